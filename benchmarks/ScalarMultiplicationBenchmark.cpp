@@ -0,0 +1,405 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+#include <vector>
+
+#include "EllipticCurve.hpp"
+#include "EllipticCurveConstants.hpp"
+#include "P256Field.hpp"
+#include "P256LaneField.hpp"
+#include "Spake2CipherSuite.hpp"
+
+#include <gmp.h>
+
+/** Compares the variable-base scalar multiplication algorithms on P-256: 
+    variable-time wNAF, variable-time binary double-and-add, and the 
+    constant-time fixed-window ladder. Then compares two-term multi-scalar 
+    multiplications, as used by SPAKE2, run one at a time and as a batch, 
+    SPAKE2's own two multi-scalar multiplications on P-256 and edwards25519, 
+    wNAF on secp256k1 with and without the GLV endomorphism, and the P-256 
+    field inversions used to return to affine coordinates. The 
+    algorithms are timed in turn within each repeat, and the fastest repeat 
+    of each is kept, so that background load affects them alike.
+*/
+
+/// @brief The algorithms being compared.
+enum class Algorithm
+{
+  WNAF,
+  BINARY,
+  CONSTANT_TIME
+};
+
+/// @brief The number of random scalars multiplied per measurement.
+static const unsigned int NUM_SCALARS = 100u;
+
+/// @brief The number of times each measurement is repeated.
+static const unsigned int NUM_REPEATS = 20u;
+
+/** Time a scalar multiplication of the generator over a set of scalars.
+    @param curve The curve to multiply on. Its window width is changed.
+    @param scalars The scalars to multiply the generator by.
+    @param algorithm The algorithm to time.
+    @return The average time of a single multiplication, in microseconds.
+*/
+double timeMultiplication(EllipticCurve& curve, 
+                          const mpz_t*   scalars,
+                          Algorithm      algorithm);
+
+/** Time the multi-scalar multiplications aG + bP over pairs of scalars, 
+    where G has a precomputed table and P does not.
+    @param curve The curve to multiply on.
+    @param batch The terms of each multi-scalar multiplication.
+    @param batched If true, every multiplication runs in a single batch.
+    @return The average time of a single multi-scalar multiplication, in 
+    microseconds.
+*/
+double timeBatch(
+  const EllipticCurve&                                               curve, 
+  const std::vector<std::vector<EllipticCurve::MultiplicationTerm>>& batch,
+  bool                                                               batched);
+
+/** Time the inversion of a set of P-256 field elements.
+    @param field The field to invert in.
+    @param elements The elements to invert.
+    @param variable_time If true, time invertVariableTime() instead of the 
+    constant-time invert().
+    @return The average time of a single inversion, in nanoseconds.
+*/
+double timeInversion(const P256Field&                       field, 
+                     const std::vector<P256Field::Element>& elements,
+                     bool                                   variable_time);
+
+int main()
+{
+  gmp_randstate_t random_state;
+  gmp_randinit_default(random_state);
+  gmp_randseed_ui     (random_state, 1ul);
+
+  mpz_t         scalars[NUM_SCALARS];
+  EllipticCurve order_curve(Curves::P256);
+  for ( unsigned int i = 0; i < NUM_SCALARS; ++i )
+  {
+    mpz_init    (scalars[i]);
+    mpz_urandomm(scalars[i], random_state, order_curve.getOrder());
+  }
+
+  const ArithmeticBackends backends[]      = 
+  {
+    ArithmeticBackends::MPZ, ArithmeticBackends::MPN, ArithmeticBackends::P256
+  };
+  const char* const        backend_names[] = { "MPZ", "MPN", "P256" };
+
+  std::cout << std::fixed << std::setprecision(1)
+            << "P-256 scalar multiplication, microseconds per call" << std::endl
+            << std::setw(8)  << "backend" 
+            << std::setw(12) << "wNAF" 
+            << std::setw(12) << "binary" 
+            << std::setw(16) << "constant-time" 
+            << std::setw(16) << "CT / wNAF" << std::endl;
+
+  for ( unsigned int i = 0; i < 3u; ++i )
+  {
+    EllipticCurve curve(Curves::P256, backends[i]);
+
+    double wnaf_us          = 0.0;
+    double binary_us        = 0.0;
+    double constant_time_us = 0.0;
+
+    for ( unsigned int repeat = 0; repeat < NUM_REPEATS; ++repeat )
+    {
+      const double wnaf          = 
+        timeMultiplication(curve, scalars, Algorithm::WNAF);
+      const double binary        = 
+        timeMultiplication(curve, scalars, Algorithm::BINARY);
+      const double constant_time = 
+        timeMultiplication(curve, scalars, Algorithm::CONSTANT_TIME);
+
+      if ( repeat == 0 || wnaf < wnaf_us )
+      {
+        wnaf_us = wnaf;
+      }
+      if ( repeat == 0 || binary < binary_us )
+      {
+        binary_us = binary;
+      }
+      if ( repeat == 0 || constant_time < constant_time_us )
+      {
+        constant_time_us = constant_time;
+      }
+    }
+
+    std::cout << std::setw(8)  << backend_names[i]
+              << std::setw(12) << wnaf_us 
+              << std::setw(12) << binary_us 
+              << std::setw(16) << constant_time_us 
+              << std::setw(16) << std::setprecision(2) 
+              << constant_time_us / wnaf_us << std::setprecision(1) 
+              << std::endl;
+  }
+
+  std::cout << std::endl 
+            << "P-256 two-term multi-scalar multiplication, microseconds per "
+            << "call (AVX-512 IFMA " 
+            << ( P256LaneField::isIfmaSupported() ? "available" : "unavailable" ) 
+            << ")" << std::endl
+            << std::setw(8)  << "backend" 
+            << std::setw(12) << "single" 
+            << std::setw(12) << "batched" << std::endl;
+
+  for ( unsigned int i = 0; i < 3u; ++i )
+  {
+    EllipticCurve              curve(Curves::P256, backends[i]);
+    const EllipticCurve::Point P = 
+      curve.scalarMultiplication(scalars[0], curve.getGenerator());
+
+    std::vector<std::vector<EllipticCurve::MultiplicationTerm>> batch;
+    for ( unsigned int j = 0; j + 1 < NUM_SCALARS; j += 2 )
+    {
+      batch.push_back(
+        { { scalars[j],     curve.getGenerator(), curve.getGeneratorTable() },
+          { scalars[j + 1], P                                              } });
+    }
+
+    double single_us  = 0.0;
+    double batched_us = 0.0;
+
+    for ( unsigned int repeat = 0; repeat < NUM_REPEATS; ++repeat )
+    {
+      const double single  = timeBatch(curve, batch, false);
+      const double batched = timeBatch(curve, batch, true);
+
+      if ( repeat == 0 || single < single_us )
+      {
+        single_us = single;
+      }
+      if ( repeat == 0 || batched < batched_us )
+      {
+        batched_us = batched;
+      }
+    }
+
+    std::cout << std::setw(8)  << backend_names[i]
+              << std::setw(12) << single_us 
+              << std::setw(12) << batched_us << std::endl;
+  }
+
+  std::cout << std::endl 
+            << "SPAKE2 multi-scalar multiplications with each Ciphersuite's "
+            << "tables, microseconds per call" << std::endl
+            << std::setw(14) << "curve" 
+            << std::setw(12) << "xG + wM" 
+            << std::setw(12) << "xY + vN" << std::endl;
+
+  const Curves      spake2_curves[]      = { Curves::P256, Curves::EDWARDS25519 };
+  const char* const spake2_curve_names[] = { "P-256", "edwards25519" };
+
+  for ( unsigned int i = 0; i < 2u; ++i )
+  {
+    const Spake2CipherSuite& cipher_suite = 
+      Spake2CipherSuite::getCipherSuite(spake2_curves[i],
+                                        HashFunctions::SHA256,
+                                        KeyDerivationFunctions::HKDF,
+                                        MessageAuthenticationCodeFunctions::HMAC);
+    const EllipticCurve&       curve = cipher_suite.getCurve();
+    const EllipticCurve::Point Y     = cipher_suite.multiplyN(scalars[0]);
+
+    /// The public key pA, and the shared point K with Y standing for hpB.
+    std::vector<std::vector<EllipticCurve::MultiplicationTerm>> public_keys;
+    std::vector<std::vector<EllipticCurve::MultiplicationTerm>> shared_points;
+    for ( unsigned int j = 0; j + 1 < NUM_SCALARS; j += 2 )
+    {
+      public_keys.push_back(
+        { { scalars[j],     curve.getGenerator(), curve.getGeneratorTable() },
+          { scalars[j + 1], cipher_suite.getM(),  cipher_suite.getMTable()  } });
+      shared_points.push_back(
+        { { scalars[j],     Y                                             },
+          { scalars[j + 1], cipher_suite.getN(),  cipher_suite.getNTable()  } });
+    }
+
+    double public_key_us   = 0.0;
+    double shared_point_us = 0.0;
+
+    for ( unsigned int repeat = 0; repeat < NUM_REPEATS; ++repeat )
+    {
+      const double public_key   = timeBatch(curve, public_keys,   false);
+      const double shared_point = timeBatch(curve, shared_points, false);
+
+      if ( repeat == 0 || public_key < public_key_us )
+      {
+        public_key_us = public_key;
+      }
+      if ( repeat == 0 || shared_point < shared_point_us )
+      {
+        shared_point_us = shared_point;
+      }
+    }
+
+    std::cout << std::setw(14) << spake2_curve_names[i]
+              << std::setw(12) << public_key_us 
+              << std::setw(12) << shared_point_us << std::endl;
+  }
+
+  std::cout << std::endl 
+            << "secp256k1 wNAF scalar multiplication, microseconds per call" 
+            << std::endl
+            << std::setw(8)  << "backend" 
+            << std::setw(12) << "wNAF" << std::endl;
+
+  const ArithmeticBackends secp256k1_backends[]      = 
+  {
+    ArithmeticBackends::MPN, ArithmeticBackends::SECP256K1
+  };
+  const char* const        secp256k1_backend_names[] = { "MPN", "GLV" };
+
+  for ( unsigned int i = 0; i < 2u; ++i )
+  {
+    EllipticCurve curve(Curves::SECP256K1, secp256k1_backends[i]);
+
+    double wnaf_us = 0.0;
+    for ( unsigned int repeat = 0; repeat < NUM_REPEATS; ++repeat )
+    {
+      const double wnaf = timeMultiplication(curve, scalars, Algorithm::WNAF);
+      if ( repeat == 0 || wnaf < wnaf_us )
+      {
+        wnaf_us = wnaf;
+      }
+    }
+
+    std::cout << std::setw(8)  << secp256k1_backend_names[i]
+              << std::setw(12) << wnaf_us << std::endl;
+  }
+
+  const P256Field                 field(order_curve.getPrimeModulus(), 
+                                        order_curve.getA());
+  std::vector<P256Field::Element> elements(NUM_SCALARS);
+  for ( unsigned int i = 0; i < NUM_SCALARS; ++i )
+  {
+    field.fromMpz(elements[i], scalars[i]);
+  }
+
+  double chain_ns = 0.0;
+  double gcd_ns   = 0.0;
+  for ( unsigned int repeat = 0; repeat < NUM_REPEATS; ++repeat )
+  {
+    const double chain = timeInversion(field, elements, false);
+    const double gcd   = timeInversion(field, elements, true);
+
+    if ( repeat == 0 || chain < chain_ns )
+    {
+      chain_ns = chain;
+    }
+    if ( repeat == 0 || gcd < gcd_ns )
+    {
+      gcd_ns = gcd;
+    }
+  }
+
+  std::cout << std::endl 
+            << "P-256 field inversion, nanoseconds per call" << std::endl
+            << std::setw(24) << "addition chain (CT)" 
+            << std::setw(24) << "mpz_invert (variable)" << std::endl
+            << std::setw(24) << chain_ns 
+            << std::setw(24) << gcd_ns << std::endl;
+
+  for ( unsigned int i = 0; i < NUM_SCALARS; ++i )
+  {
+    mpz_clear(scalars[i]);
+  }
+  gmp_randclear(random_state);
+
+  return 0;
+}
+
+// ============================================================================
+double timeMultiplication(EllipticCurve& curve, 
+                          const mpz_t*   scalars,
+                          Algorithm      algorithm)
+{
+  typedef std::chrono::steady_clock clock;
+
+  const EllipticCurve::Point& G = curve.getGenerator();
+  curve.setWindowBits(algorithm == Algorithm::BINARY ? 1u : DEFAULT_WINDOW_BITS);
+
+  const clock::time_point start = clock::now();
+
+  for ( unsigned int i = 0; i < NUM_SCALARS; ++i )
+  {
+    const EllipticCurve::Point result = 
+      ( algorithm == Algorithm::CONSTANT_TIME ) ?
+        curve.constantTimeScalarMultiplication(scalars[i], G) :
+        curve.scalarMultiplication(scalars[i], G);
+  }
+
+  const std::chrono::duration<double, std::micro> elapsed = clock::now() - start;
+  return elapsed.count() / NUM_SCALARS;
+}
+
+// ============================================================================
+double timeBatch(
+  const EllipticCurve&                                               curve, 
+  const std::vector<std::vector<EllipticCurve::MultiplicationTerm>>& batch,
+  bool                                                               batched)
+{
+  typedef std::chrono::steady_clock clock;
+
+  const clock::time_point start = clock::now();
+
+  if ( batched )
+  {
+    const std::vector<EllipticCurve::Point> results = 
+      curve.batchMultiScalarMultiplication(batch);
+  }
+  else
+  {
+    for ( const std::vector<EllipticCurve::MultiplicationTerm>& terms : batch )
+    {
+      const EllipticCurve::Point result = curve.multiScalarMultiplication(terms);
+    }
+  }
+
+  const std::chrono::duration<double, std::micro> elapsed = clock::now() - start;
+  return elapsed.count() / batch.size();
+}
+
+// ============================================================================
+double timeInversion(const P256Field&                       field, 
+                     const std::vector<P256Field::Element>& elements,
+                     bool                                   variable_time)
+{
+  typedef std::chrono::steady_clock clock;
+
+  P256Field::Element inverse;
+
+  const clock::time_point start = clock::now();
+
+  for ( const P256Field::Element& element : elements )
+  {
+    if ( variable_time )
+    {
+      field.invertVariableTime(inverse, element);
+    }
+    else
+    {
+      field.invert(inverse, element);
+    }
+  }
+
+  const std::chrono::duration<double, std::nano> elapsed = clock::now() - start;
+  return elapsed.count() / elements.size();
+}
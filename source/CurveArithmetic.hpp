@@ -0,0 +1,2082 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+#ifndef CURVE_ARITHMETIC_HPP
+#define CURVE_ARITHMETIC_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "CurveTraits.hpp"
+#include "EllipticCurve.hpp"
+#include "EllipticCurveConstants.hpp"
+#include "SecureRandom.hpp"
+#include "sodium.h"
+
+#include <gmp.h>
+
+/** Precomputed multiples of a fixed base point, used to speed up repeated 
+    multiplications of that point. Tables are opaque, and may only be used 
+    with the CurveArithmetic which created them.
+*/
+class FixedBaseTable
+{
+public:
+
+  /// @brief The destructor does nothing.
+  virtual ~FixedBaseTable() {}
+
+  /** Accessor for the memory held by this table.
+      @return The size of the precomputed points, in bytes.
+  */
+  virtual std::size_t getSizeBytes() const = 0;
+};
+
+/** Interface for the point arithmetic behind an EllipticCurve. Points enter 
+    and leave in affine coordinates, while implementations are free to work 
+    in any internal representation.
+*/
+class CurveArithmetic
+{
+public:
+
+  /// @brief The destructor does nothing.
+  virtual ~CurveArithmetic() {}
+
+  /** Add two affine points.
+      @param P The first point on the curve.
+      @param Q The second point on the curve.
+      @return P + Q.
+  */
+  virtual EllipticCurve::Point operate(const EllipticCurve::Point& P, 
+                                       const EllipticCurve::Point& Q) const = 0;
+
+  /** Add two affine points with complete formulas, which take the same path
+      for every pair of inputs, including the point at infinity, P == Q and
+      P == -Q. Only valid on curves without points of order two.
+      @param P The first point on the curve.
+      @param Q The second point on the curve.
+      @return P + Q.
+  */
+  virtual EllipticCurve::Point 
+  completeOperate(const EllipticCurve::Point& P, 
+                  const EllipticCurve::Point& Q) const = 0;
+
+  /** Multiply an affine point by a scalar.
+      @param scalar The scalar to multiply P by.
+      @param P The point on the curve to be multiplied.
+      @return scalar * P.
+  */
+  virtual EllipticCurve::Point 
+  scalarMultiplication(const mpz_t& scalar, const EllipticCurve::Point& P) const = 0;
+
+  /** Multiply an affine point by a scalar without branches or memory accesses
+      that depend on the scalar's bits. Only the sign of the scalar and, for 
+      scalars longer than the prime modulus, its length are treated as public.
+      @param scalar The secret scalar to multiply P by.
+      @param P The public point on the curve to be multiplied.
+      @return scalar * P.
+  */
+  virtual EllipticCurve::Point 
+  constantTimeScalarMultiplication(const mpz_t&                scalar, 
+                                   const EllipticCurve::Point& P) const = 0;
+
+  /** Multiply an affine point by the cofactor, mapping it into the subgroup 
+      of order n. Exact for every point on the curve, including those which 
+      scalarMultiplication() may reject. The default uses 
+      scalarMultiplication(), which accepts any point.
+      @param P The public point on the curve to clear.
+      @param cofactor The curve's cofactor, h.
+      @return h * P.
+  */
+  virtual EllipticCurve::Point 
+  clearCofactor(const EllipticCurve::Point& P, const mpz_t& cofactor) const
+  {
+    return scalarMultiplication(cofactor, P);
+  }
+
+  /** Set the window width used when multiplying points without a 
+      precomputed table.
+      @param window_bits The width of the NAF window, in [1, MAX_WINDOW_BITS].
+      A width of 1 selects plain binary double-and-add.
+  */
+  virtual void setWindowBits(unsigned int window_bits) = 0;
+
+  /** Negate an affine point.
+      @param P The point on the curve to negate.
+      @return -P.
+  */
+  virtual EllipticCurve::Point 
+  negatePoint(const EllipticCurve::Point& P) const = 0;
+
+  /** Recover an affine point from its x coordinate and the parity of its y 
+      coordinate, by solving y^2 = x^3 + ax + b. Twisted Edwards curves swap
+      the roles of x and y, following RFC 8032.
+      @param result The point to place the recovered point into.
+      @param x The x coordinate, in [0, p).
+      @param y_is_odd 1 to select the odd root y, 0 to select the even one.
+      @return True if x and y_is_odd describe a point on the curve.
+      @throw std::invalid_argument if p is not 3 mod 4.
+  */
+  virtual bool decompressPoint(EllipticCurve::Point& result, 
+                               const mpz_t&          x, 
+                               unsigned int          y_is_odd) const = 0;
+
+  /** Precompute multiples of a fixed base point.
+      @param base The point on the curve to precompute multiples of.
+      @param order The order of base. Scalars too large for the table are 
+      reduced modulo order.
+      @param max_bytes The maximum size of the table, in bytes.
+      @return A new table, owned by the caller, or nullptr if base is at 
+      infinity or max_bytes is too small to hold a single point.
+  */
+  virtual FixedBaseTable* 
+  createFixedBaseTable(const EllipticCurve::Point& base, 
+                       const mpz_t&                order,
+                       std::size_t                 max_bytes) const = 0;
+
+  /** Multiply a fixed base point by a scalar.
+      @param scalar The scalar to multiply the base point by.
+      @param table The precomputed table of the base point, created by this 
+      object's createFixedBaseTable().
+      @return scalar * base.
+  */
+  virtual EllipticCurve::Point 
+  fixedBaseMultiplication(const mpz_t&          scalar, 
+                          const FixedBaseTable& table) const = 0;
+
+  /** Compute the sum of several scalar multiplications, sharing a single 
+      chain of doublings between every term.
+      @param terms The (scalar, point) pairs to sum. Tables, if given, must 
+      have been created by this object's createFixedBaseTable().
+      @return The sum of scalar * point over every term.
+  */
+  virtual EllipticCurve::Point multiScalarMultiplication(
+    const std::vector<EllipticCurve::MultiplicationTerm>& terms) const = 0;
+
+  /** Compute several independent multi-scalar multiplications, converting 
+      every result back to affine coordinates with a single shared inversion.
+      @param batch The terms of each multi-scalar multiplication.
+      @return The result of each multi-scalar multiplication, in order.
+  */
+  virtual std::vector<EllipticCurve::Point> batchMultiScalarMultiplication(
+    const std::vector<std::vector<EllipticCurve::MultiplicationTerm>>& batch) const = 0;
+};
+
+/** Point arithmetic in Jacobian projective coordinates over a prime field. 
+    A Jacobian point (X, Y, Z) corresponds to the affine point 
+    (X / Z^2, Y / Z^3), and the point at infinity is represented by Z = 0. 
+    Only the conversion back to affine coordinates requires an inversion.
+    The Field parameter provides the field element type and its arithmetic,
+    e.g. MpzField or P256Field. The Traits parameter describes what is known
+    about the curve at compile time (see CurveTraits), so that a curve such 
+    as P-256 has its a = -3 shortcuts chosen by the compiler rather than 
+    tested at run time.
+*/
+template <typename Field, typename Traits = RuntimeCurveTraits>
+class JacobianArithmetic : public CurveArithmetic
+{
+public:
+
+  typedef typename Field::Element Element;
+
+  /// @brief A point in Jacobian coordinates.
+  struct JacobianPoint
+  {
+    Element X;
+    Element Y;
+    Element Z;
+  };
+
+  /** @brief A point in homogeneous projective coordinates, (X / Z, Y / Z).
+      The point at infinity is (0 : 1 : 0). Used by the complete formulas.
+  */
+  struct ProjectivePoint
+  {
+    Element X;
+    Element Y;
+    Element Z;
+  };
+
+  /** Construct the arithmetic for a curve.
+      @param p The curve's prime modulus.
+      @param a The curve's a parameter.
+      @param b The curve's b parameter.
+  */
+  JacobianArithmetic(const mpz_t& p, const mpz_t& a, const mpz_t& b);
+
+  /// @brief The destructor does nothing.
+  ~JacobianArithmetic();
+
+  EllipticCurve::Point operate(const EllipticCurve::Point& P, 
+                               const EllipticCurve::Point& Q) const;
+
+  /// @brief Uses completeAddition() in homogeneous projective coordinates.
+  EllipticCurve::Point completeOperate(const EllipticCurve::Point& P, 
+                                       const EllipticCurve::Point& Q) const;
+
+  EllipticCurve::Point 
+  scalarMultiplication(const mpz_t& scalar, const EllipticCurve::Point& P) const;
+
+  /** Uses a regular signed-digit recoding with a fixed window of 
+      CONSTANT_TIME_WINDOW_BITS bits: every digit is odd and non-zero, so each
+      window costs exactly w doublings and one addition. Table entries are 
+      normalized, and selected by scanning the whole table with masked moves.
+      Additions use the mixed Jacobian formulas, with each exceptional case 
+      replaced by masked moves, so the accumulator never leaves Jacobian 
+      coordinates. Runs in constant time with the MPN and P256 field backends
+      only - the mpz_t based MpzField is inherently variable time. The 
+      recoded digits live on the stack, and are wiped before returning.
+      @throw std::invalid_argument if scalar is longer than twice the 
+      largest field, MAX_FIELD_SIZE_BYTES.
+      @cite Joye, Tunstall. Exponent Recoding and Regular Exponentiation 
+      Algorithms. AFRICACRYPT 2009.
+  */
+  EllipticCurve::Point 
+  constantTimeScalarMultiplication(const mpz_t&                scalar, 
+                                   const EllipticCurve::Point& P) const;
+
+  EllipticCurve::Point negatePoint(const EllipticCurve::Point& P) const;
+
+  bool decompressPoint(EllipticCurve::Point& result, 
+                       const mpz_t&          x, 
+                       unsigned int          y_is_odd) const;
+
+  void setWindowBits(unsigned int window_bits);
+
+  FixedBaseTable* createFixedBaseTable(const EllipticCurve::Point& base, 
+                                       const mpz_t&                order,
+                                       std::size_t                 max_bytes) const;
+
+  EllipticCurve::Point fixedBaseMultiplication(const mpz_t&          scalar, 
+                                               const FixedBaseTable& table) const;
+
+  EllipticCurve::Point multiScalarMultiplication(
+    const std::vector<EllipticCurve::MultiplicationTerm>& terms) const;
+
+  std::vector<EllipticCurve::Point> batchMultiScalarMultiplication(
+    const std::vector<std::vector<EllipticCurve::MultiplicationTerm>>& batch) const;
+
+protected:
+
+  /// @brief The largest number of teeth considered for a comb table.
+  static const unsigned int MAX_COMB_TEETH = 8u;
+
+  /// @brief The most temporaries used by any one of the point formulas.
+  static const unsigned int WORKSPACE_ELEMENTS = 11u;
+
+  /** Scratch elements for the point formulas. A multiplication creates one 
+      workspace and passes it to every formula it runs, so fields whose 
+      elements own heap memory, i.e. MpzField, allocate their temporaries 
+      once per multiplication rather than once per formula. A workspace may 
+      not be shared between threads.
+  */
+  struct Workspace
+  {
+    Element elements[WORKSPACE_ELEMENTS];
+  };
+
+  /** A Lim-Lee comb table. The scalar is laid out as a matrix of `teeth` rows
+      of row_bits bits, and each row is split into `blocks` blocks of 
+      block_bits bits. Entry u (1 <= u < 2^teeth) of block j holds the sum of 
+      2^(i * row_bits + j * block_bits) * P over the set bits i of u, so a 
+      multiplication takes block_bits doublings and at most 
+      blocks * block_bits additions. Entries are stored normalized (Z = 1).
+      @cite Lim, Lee. More Flexible Exponentiation with Precomputation. 
+      CRYPTO 1994.
+  */
+  struct CombTable : public FixedBaseTable
+  {
+    CombTable(const mpz_t& order_in)
+      : teeth(0), blocks(0), row_bits(0), block_bits(0), size_bytes(0), 
+        order(), points()
+    {
+      mpz_init_set(order, order_in);
+    }
+
+    ~CombTable()
+    {
+      mpz_clear(order);
+    }
+
+    std::size_t getSizeBytes() const
+    {
+      return size_bytes;
+    }
+
+    /// @brief Returns entry u of the given block.
+    const JacobianPoint& getEntry(unsigned int block, unsigned int u) const
+    {
+      return points[block * ( ( 1u << teeth ) - 1u ) + u - 1u];
+    }
+
+    unsigned int               teeth;
+    unsigned int               blocks;
+    unsigned int               row_bits;
+    unsigned int               block_bits;
+    std::size_t                size_bytes;
+    mpz_t                      order;
+    std::vector<JacobianPoint> points;
+
+    /// Both copy assignment and copy constructors are deleted.
+    CombTable operator=(const CombTable& object) = delete;
+    CombTable          (const CombTable& object) = delete;
+  };
+
+  /// @brief The underlying prime field.
+  Field field;
+
+  /// @brief The width of the NAF window for points without a table.
+  unsigned int window_bits;
+
+  /// @brief The length of the prime modulus, in bits.
+  unsigned int field_bits;
+
+  /// @brief True if a = -3 mod p, enabling the cheaper formulas.
+  bool a_is_minus_three;
+
+  /// @brief Test if a = -3 mod p, at compile time where the traits allow.
+  bool aIsMinusThree() const;
+
+  /// @brief The curve's b parameter, and 3b, for the complete formulas.
+  Element b;
+  Element b3;
+
+  /// @brief Test if P is the point at infinity.
+  bool isInfinity(const JacobianPoint& P) const;
+
+  /// @brief Set P to the point at infinity.
+  void setInfinity(JacobianPoint& P) const;
+
+  /** Convert an affine point into Jacobian coordinates, i.e. (x, y, 1).
+      @param result The Jacobian point to place P into.
+      @param P The affine point to convert.
+  */
+  void toJacobian(JacobianPoint& result, const EllipticCurve::Point& P) const;
+
+  /** Convert a Jacobian point back into affine coordinates. This is the only
+      step which requires a modular inversion.
+      @param P The Jacobian point to convert.
+      @param secret If true, Z may reveal a secret scalar, so it is blinded 
+      by a random element before the inversion. Otherwise Z is inverted 
+      directly.
+      @return P in affine coordinates.
+  */
+  EllipticCurve::Point toAffine(const JacobianPoint& P, bool secret = false) const;
+
+  /** Draw a random non-zero field element, close to uniformly.
+      @param result The element to place the random value into.
+  */
+  void randomElement(Element& result) const;
+
+  /** Normalize Jacobian points to Z = 1 using a single inversion (Montgomery's
+      simultaneous inversion trick). Points at infinity are left untouched. 
+      The inversion is variable time.
+      @param points The points to normalize, in place.
+  */
+  void normalize(std::vector<JacobianPoint>& points) const;
+
+  /** Reduce a scalar modulo the order of a comb table's base point, if it 
+      does not fit into the comb.
+      @param reduced Storage for the reduced scalar. Must be initialized.
+      @param scalar The scalar to reduce.
+      @param table The comb table the scalar will be used with.
+      @return Either scalar, or reduced holding scalar mod order.
+  */
+  mpz_srcptr reduceCombScalar(mpz_t            reduced, 
+                              mpz_srcptr       scalar, 
+                              const CombTable& table) const;
+
+  /** Add a column of a comb to T, i.e. the table entries selected by bit 
+      column of every block.
+      @param T The running total to add to.
+      @param scalar The scalar, which must fit into the comb.
+      @param table The comb table.
+      @param column The column within each block, in [0, block_bits).
+      @param workspace Scratch elements for the formulas.
+  */
+  void addCombColumn(JacobianPoint&   T, 
+                     mpz_srcptr       scalar, 
+                     const CombTable& table, 
+                     unsigned int     column,
+                     Workspace&       workspace) const;
+
+  /** Recode a scalar's magnitude into width-w non-adjacent form (wNAF), 
+      where w is window_bits. Every non-zero digit is odd with magnitude below
+      2^(w-1), and any w consecutive digits hold at most one non-zero digit. 
+      A width of 1 yields plain binary digits.
+      @param digits The digits to fill in. digits[i] is the coefficient of 2^i.
+      @param scalar The scalar to recode. Its sign is ignored.
+  */
+  void recodeScalar(std::vector<signed char>& digits, mpz_srcptr scalar) const;
+
+  /** Precompute the odd multiples P, 3P, 5P, ... needed by the digits of 
+      recodeScalar(), along with their negations.
+      @param positive The odd multiples of P.
+      @param negative The odd multiples of -P.
+      @param P The point to precompute the multiples of.
+      @param workspace Scratch elements for the formulas.
+  */
+  void precomputeOddMultiples(std::vector<JacobianPoint>& positive, 
+                              std::vector<JacobianPoint>& negative, 
+                              const JacobianPoint&        P,
+                              Workspace&                  workspace) const;
+
+  /** Add a single recoded digit's multiple of P to T.
+      @param T The running total to add to.
+      @param digit A digit produced by recodeScalar().
+      @param positive The odd multiples of P.
+      @param negative The odd multiples of -P.
+      @param workspace Scratch elements for the formulas.
+  */
+  void addDigit(JacobianPoint&                    T, 
+                signed char                       digit,
+                const std::vector<JacobianPoint>& positive, 
+                const std::vector<JacobianPoint>& negative,
+                Workspace&                        workspace) const;
+
+  /** Convert an affine point into projective coordinates, i.e. (x : y : 1), 
+      without branching. The point at infinity becomes (0 : 1 : 0).
+      @param result The projective point to place P into.
+      @param P The affine point to convert.
+      @param workspace Scratch elements for the conversion.
+  */
+  void toProjective(ProjectivePoint&            result, 
+                    const EllipticCurve::Point& P,
+                    Workspace&                  workspace) const;
+
+  /** Convert a projective point into Jacobian coordinates, without branching.
+      @param result The Jacobian point to place P into.
+      @param P The projective point to convert.
+      @param workspace Scratch elements for the formulas.
+  */
+  void fromProjective(JacobianPoint&         result, 
+                      const ProjectivePoint& P,
+                      Workspace&             workspace) const;
+
+  /** Read bits [position, position + count) of a little-endian limb array.
+      Only position and count affect which limbs are read.
+      @param limbs The limbs to read from.
+      @param position The index of the lowest bit to read.
+      @param count The number of bits to read, at most 8.
+      @return The bits, as an integer.
+  */
+  static unsigned int readBits(const mp_limb_t* limbs, 
+                               std::size_t      position, 
+                               unsigned int     count);
+
+  /** @brief The most digits recodeRegular() fills in, enough for scalars 
+      of twice the largest field, as for SecureRandom::MAX_SCALAR_BYTES.
+  */
+  static const std::size_t MAX_REGULAR_DIGITS = 
+    ( 16u * MAX_FIELD_SIZE_BYTES + CONSTANT_TIME_WINDOW_BITS - 1u ) / 
+    CONSTANT_TIME_WINDOW_BITS;
+
+  /** Recode a scalar's magnitude into the regular signed digits of 
+      constantTimeScalarMultiplication(), with a window of 
+      CONSTANT_TIME_WINDOW_BITS bits. Only num_digits affects the running time.
+      The scalar is copied into limbs on the stack, which are wiped before 
+      returning. The caller wipes the digits.
+      @param digits The digits to fill in. digits[i] is the coefficient of 
+      2^(iw), every digit is odd, and the top digit is positive.
+      @param scalar The scalar to recode. Its sign is ignored.
+      @param num_digits The number of digits. Must cover every bit of scalar.
+      @return 1 if the scalar was even, in which case the digits hold the 
+      scalar plus one, otherwise 0.
+      @throw std::invalid_argument if num_digits exceeds MAX_REGULAR_DIGITS.
+  */
+  static unsigned int recodeRegular(int         digits[MAX_REGULAR_DIGITS], 
+                                    mpz_srcptr  scalar, 
+                                    std::size_t num_digits);
+
+  /** Select digit * P and 2 * digit * P from tables of odd multiples and 
+      their doubles without branching on, or indexing by, the digit. Every 
+      table entry is read.
+      @param result The point to place digit * P into.
+      @param result_doubled The point to place 2 * digit * P into.
+      @param digit An odd digit, with |digit| < 2 * table.size().
+      @param table The odd multiples P, 3P, 5P, ..., normalized.
+      @param doubled_table The doubles 2P, 6P, 10P, ...
+      @param workspace Scratch elements for the formulas.
+  */
+  void selectMultiple(JacobianPoint&                    result, 
+                      JacobianPoint&                    result_doubled,
+                      int                               digit, 
+                      const std::vector<JacobianPoint>& table,
+                      const std::vector<JacobianPoint>& doubled_table,
+                      Workspace&                        workspace) const;
+
+  /** Perform point addition in projective coordinates with the complete 
+      formulas, which are correct for every pair of inputs, including the 
+      point at infinity, P == Q and P == -Q. result may alias P or Q.
+      @cite Renes, Costello, Batina. Complete addition formulas for prime 
+      order elliptic curves. EUROCRYPT 2016. Algorithms 1 and 4.
+      @param result The point to place P + Q into.
+      @param P The first point to add.
+      @param Q The second point to add.
+      @param workspace Scratch elements for the formulas.
+  */
+  void completeAddition(ProjectivePoint&       result, 
+                        const ProjectivePoint& P, 
+                        const ProjectivePoint& Q,
+                        Workspace&             workspace) const;
+
+  /// @brief completeAddition() for a = -3, using b.
+  void completeAdditionMinusThree(ProjectivePoint&       result, 
+                                  const ProjectivePoint& P, 
+                                  const ProjectivePoint& Q,
+                                  Workspace&             workspace) const;
+
+  /// @brief completeAddition() for any a, using 3b.
+  void completeAdditionGeneric(ProjectivePoint&       result, 
+                               const ProjectivePoint& P, 
+                               const ProjectivePoint& Q,
+                               Workspace&             workspace) const;
+
+  /** Sum the multiples of a multi-scalar multiplication, leaving the result in
+      Jacobian coordinates.
+      @param result The point to place the sum into.
+      @param terms The (scalar, point) pairs to sum.
+      @param workspace Scratch elements for the formulas.
+  */
+  void sumMultiples(JacobianPoint&                                        result, 
+                    const std::vector<EllipticCurve::MultiplicationTerm>& terms,
+                    Workspace&                                            workspace) const;
+
+  /** Perform point doubling in Jacobian coordinates. result may alias P.
+      @param result The point to place 2P into.
+      @param P The point to double.
+      @param workspace Scratch elements for the formulas.
+  */
+  void pointDoubling(JacobianPoint&       result, 
+                     const JacobianPoint& P,
+                     Workspace&           workspace) const;
+
+  /** Perform point doubling in Jacobian coordinates without branching. The 
+      formulas have no exceptional cases on a curve point: doubling the point 
+      at infinity, or a point with y = 0, yields Z = 0. result may alias P.
+      @param result The point to place 2P into.
+      @param P The point to double.
+      @param workspace Scratch elements for the formulas.
+  */
+  void pointDoublingBranchFree(JacobianPoint&       result, 
+                               const JacobianPoint& P,
+                               Workspace&           workspace) const;
+
+  /** Perform point addition in Jacobian coordinates. Handles the point at
+      infinity, P == Q and P == -Q. result may alias P or Q.
+      @param result The point to place P + Q into.
+      @param P The first point to add.
+      @param Q The second point to add.
+      @param workspace Scratch elements for the formulas.
+  */
+  void pointAddition(JacobianPoint&       result, 
+                     const JacobianPoint& P, 
+                     const JacobianPoint& Q,
+                     Workspace&           workspace) const;
+
+  /** Perform mixed point addition, where Q is normalized (Z = 1). Taking Z2 = 1
+      saves four multiplications and a squaring over pointAddition(). Handles 
+      P at infinity, P == Q and P == -Q. result may alias P or Q.
+      @param result The point to place P + Q into.
+      @param P The first point to add.
+      @param Q The second point to add, which must have Z = 1.
+      @param workspace Scratch elements for the formulas.
+  */
+  void pointAdditionMixed(JacobianPoint&       result, 
+                          const JacobianPoint& P, 
+                          const JacobianPoint& Q,
+                          Workspace&           workspace) const;
+
+  /** Perform mixed point addition without branching, for secret operands. 
+      Each exceptional case of the mixed formulas is computed anyway and 
+      replaced with masked moves: P at infinity yields Q, Q at infinity yields
+      P, and P == Q yields the precomputed Q_doubled. P == -Q needs no 
+      correction, as the formulas then give Z = 0. result may alias P.
+      @param result The point to place P + Q into.
+      @param P The first point to add.
+      @param Q The second point to add, which must have Z = 1 or Z = 0.
+      @param Q_doubled The point 2Q.
+      @param workspace Scratch elements for the formulas.
+  */
+  void pointAdditionMixedBranchFree(JacobianPoint&       result, 
+                                    const JacobianPoint& P, 
+                                    const JacobianPoint& Q,
+                                    const JacobianPoint& Q_doubled,
+                                    Workspace&           workspace) const;
+
+  /// Both copy assignment and copy constructors are deleted.
+  JacobianArithmetic operator=(const JacobianArithmetic& object) = delete;
+  JacobianArithmetic          (const JacobianArithmetic& object) = delete;
+};
+
+// ============================================================================
+template <typename Field, typename Traits>
+JacobianArithmetic<Field, Traits>::JacobianArithmetic(const mpz_t& p, 
+                                                      const mpz_t& a, 
+                                                      const mpz_t& b_in)
+  : field(p, a),
+    window_bits(DEFAULT_WINDOW_BITS),
+    field_bits(mpz_sizeinbase(p, 2)),
+    a_is_minus_three(false),
+    b(),
+    b3()
+{
+  field.fromMpz(b,  b_in);
+  field.add    (b3, b,  b);
+  field.add    (b3, b3, b);
+
+  mpz_t a_plus_three;
+  mpz_init  (a_plus_three);
+  mpz_add_ui(a_plus_three, a, 3ul);
+  a_is_minus_three = ( mpz_divisible_p(a_plus_three, p) != 0 );
+  mpz_clear (a_plus_three);
+
+  if ( Traits::A_IS_MINUS_THREE && !a_is_minus_three )
+  {
+    throw std::invalid_argument("Curve traits require a = -3 mod p.");
+  }
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+JacobianArithmetic<Field, Traits>::~JacobianArithmetic()
+{
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+inline bool JacobianArithmetic<Field, Traits>::aIsMinusThree() const
+{
+  return Traits::A_IS_MINUS_THREE || a_is_minus_three;
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+inline bool JacobianArithmetic<Field, Traits>::isInfinity(const JacobianPoint& P) const
+{
+  return field.isZero(P.Z);
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+inline void JacobianArithmetic<Field, Traits>::setInfinity(JacobianPoint& P) const
+{
+  field.setOne (P.X);
+  field.setOne (P.Y);
+  field.setZero(P.Z);
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+void JacobianArithmetic<Field, Traits>::toJacobian(JacobianPoint&              result, 
+                                                   const EllipticCurve::Point& P) const
+{
+  if ( P.at_infinity )
+  {
+    setInfinity(result);
+    return;
+  }
+
+  field.fromMpz(result.X, P.x);
+  field.fromMpz(result.Y, P.y);
+  field.setOne (result.Z);
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+EllipticCurve::Point 
+JacobianArithmetic<Field, Traits>::toAffine(const JacobianPoint& P, 
+                                            bool                 secret) const
+{
+  EllipticCurve::Point result;
+
+  if ( isInfinity(P) )
+  {
+    return result;
+  }
+
+  /// Already normalized, no inversion required.
+  if ( field.isOne(P.Z) )
+  {
+    field.toMpz(result.x, P.X);
+    field.toMpz(result.y, P.Y);
+    result.at_infinity = false;
+    return result;
+  }
+
+  Element z_inverse;
+  Element z_inverse_squared;
+  Element coordinate;
+
+  if ( secret )
+  {
+    /** 1 / Z = r / Zr for a random r. Zr is uniformly distributed whatever Z
+        is, so the faster variable-time inversion reveals nothing about Z.
+    */
+    randomElement(coordinate);
+    field.mul               (z_inverse, P.Z,       coordinate);
+    field.invertVariableTime(z_inverse, z_inverse);
+    field.mul               (z_inverse, z_inverse, coordinate);
+  }
+  else
+  {
+    field.invertVariableTime(z_inverse, P.Z);
+  }
+  field.sqr(z_inverse_squared, z_inverse);
+
+  /// x = X / Z^2
+  field.mul  (coordinate, P.X, z_inverse_squared);
+  field.toMpz(result.x,   coordinate);
+
+  /// y = Y / Z^3
+  field.mul  (coordinate, P.Y,        z_inverse_squared);
+  field.mul  (coordinate, coordinate, z_inverse);
+  field.toMpz(result.y,   coordinate);
+
+  result.at_infinity = false;
+  return result;
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+void JacobianArithmetic<Field, Traits>::randomElement(Element& result) const
+{
+  /// field_bits random bits, which are below 2p and reduce to [0, p).
+  const std::size_t num_limbs = 
+    ( field_bits + GMP_NUMB_BITS - 1 ) / GMP_NUMB_BITS;
+  mp_limb_t limbs[( MAX_FIELD_SIZE_BYTES * 8u + GMP_NUMB_BITS - 1 ) / GMP_NUMB_BITS];
+
+  SecureRandom::getBytes(reinterpret_cast<unsigned char*>(limbs), 
+                         num_limbs * sizeof(mp_limb_t));
+  if ( field_bits % GMP_NUMB_BITS != 0 )
+  {
+    limbs[num_limbs - 1] &= ( mp_limb_t(1) << ( field_bits % GMP_NUMB_BITS ) ) - 1u;
+  }
+
+  mpz_t value;
+  mpz_roinit_n (value,  limbs, num_limbs);
+  field.fromMpz(result, value);
+
+  /// Zero has no inverse, so replace it with one.
+  Element one;
+  field.setOne         (one);
+  field.conditionalMove(result, one, field.isZero(result) ? 1u : 0u);
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+void JacobianArithmetic<Field, Traits>::pointDoubling(JacobianPoint&       result, 
+                                                      const JacobianPoint& P,
+                                                      Workspace&           workspace) const
+{
+  /// The tangent at a point with y = 0 is vertical.
+  if ( isInfinity(P) || field.isZero(P.Y) )
+  {
+    setInfinity(result);
+    return;
+  }
+
+  pointDoublingBranchFree(result, P, workspace);
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+void 
+JacobianArithmetic<Field, Traits>::pointDoublingBranchFree(JacobianPoint&       result, 
+                                                           const JacobianPoint& P,
+                                                           Workspace&           workspace) const
+{
+  Element& x_squared = workspace.elements[0];
+  Element& y_squared = workspace.elements[1];
+  Element& y_fourth  = workspace.elements[2];
+  Element& z_squared = workspace.elements[3];
+  Element& s         = workspace.elements[4];
+  Element& m         = workspace.elements[5];
+  Element& t         = workspace.elements[6];
+
+  field.sqr(y_squared, P.Y);
+  field.sqr(y_fourth,  y_squared);
+  field.sqr(z_squared, P.Z);
+
+  /// S = 4 * X * Y^2
+  field.mul(s, P.X, y_squared);
+  field.add(s, s,   s);
+  field.add(s, s,   s);
+
+  if ( aIsMinusThree() )
+  {
+    /// M = 3X^2 - 3Z^4 = 3(X - Z^2)(X + Z^2)
+    field.sub(m, P.X, z_squared);
+    field.add(t, P.X, z_squared);
+    field.mul(m, m,   t);
+    field.add(t, m,   m);
+    field.add(m, m,   t);
+  }
+  else
+  {
+    /// M = 3X^2 + aZ^4
+    field.sqr(x_squared, P.X);
+    field.sqr(m,         z_squared);
+    field.mul(m,         m, field.getA());
+    field.add(m,         m, x_squared);
+    field.add(m,         m, x_squared);
+    field.add(m,         m, x_squared);
+  }
+
+  /// Z3 = 2YZ
+  field.mul(t,        P.Y, P.Z);
+  field.add(result.Z, t,   t);
+
+  /// X3 = M^2 - 2S
+  field.sqr(result.X, m);
+  field.sub(result.X, result.X, s);
+  field.sub(result.X, result.X, s);
+
+  /// Y3 = M(S - X3) - 8Y^4
+  field.sub(t,        s,        result.X);
+  field.mul(t,        t,        m);
+  field.add(y_fourth, y_fourth, y_fourth);
+  field.add(y_fourth, y_fourth, y_fourth);
+  field.add(y_fourth, y_fourth, y_fourth);
+  field.sub(result.Y, t,        y_fourth);
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+void JacobianArithmetic<Field, Traits>::pointAddition(JacobianPoint&       result, 
+                                                      const JacobianPoint& P, 
+                                                      const JacobianPoint& Q,
+                                                      Workspace&           workspace) const
+{
+  if ( isInfinity(P) )
+  {
+    result = Q;
+    return;
+  }
+
+  if ( isInfinity(Q) )
+  {
+    result = P;
+    return;
+  }
+
+  /// Affine inputs and normalized table entries take the cheaper formulas.
+  if ( field.isOne(Q.Z) )
+  {
+    pointAdditionMixed(result, P, Q, workspace);
+    return;
+  }
+
+  if ( field.isOne(P.Z) )
+  {
+    pointAdditionMixed(result, Q, P, workspace);
+    return;
+  }
+
+  Element& z1_squared = workspace.elements[0];
+  Element& z2_squared = workspace.elements[1];
+  Element& u1         = workspace.elements[2];
+  Element& u2         = workspace.elements[3];
+  Element& s1         = workspace.elements[4];
+  Element& s2         = workspace.elements[5];
+  Element& h          = workspace.elements[6];
+  Element& r          = workspace.elements[7];
+  Element& h_squared  = workspace.elements[8];
+  Element& h_cubed    = workspace.elements[9];
+  Element& v          = workspace.elements[10];
+
+  /// U1 = X1 * Z2^2, U2 = X2 * Z1^2
+  field.sqr(z1_squared, P.Z);
+  field.sqr(z2_squared, Q.Z);
+  field.mul(u1,         P.X, z2_squared);
+  field.mul(u2,         Q.X, z1_squared);
+
+  /// S1 = Y1 * Z2^3, S2 = Y2 * Z1^3
+  field.mul(s1, P.Y, z2_squared);
+  field.mul(s1, s1,  Q.Z);
+  field.mul(s2, Q.Y, z1_squared);
+  field.mul(s2, s2,  P.Z);
+
+  /// H = U2 - U1, r = S2 - S1
+  field.sub(h, u2, u1);
+  field.sub(r, s2, s1);
+
+  if ( field.isZero(h) )
+  {
+    /// P == Q requires doubling, while P == -Q yields the point at infinity.
+    if ( field.isZero(r) )
+    {
+      pointDoubling(result, P, workspace);
+    }
+    else
+    {
+      setInfinity(result);
+    }
+    return;
+  }
+
+  /// V = U1 * H^2
+  field.sqr(h_squared, h);
+  field.mul(h_cubed,   h_squared, h);
+  field.mul(v,         u1,        h_squared);
+
+  /// Z3 = Z1 * Z2 * H. The inputs are no longer needed past this point.
+  field.mul(u2,       P.Z, Q.Z);
+  field.mul(result.Z, u2,  h);
+
+  /// X3 = r^2 - H^3 - 2V
+  field.sqr(result.X, r);
+  field.sub(result.X, result.X, h_cubed);
+  field.sub(result.X, result.X, v);
+  field.sub(result.X, result.X, v);
+
+  /// Y3 = r(V - X3) - S1 * H^3
+  field.sub(u2,       v,  result.X);
+  field.mul(u2,       u2, r);
+  field.mul(s1,       s1, h_cubed);
+  field.sub(result.Y, u2, s1);
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+void JacobianArithmetic<Field, Traits>::pointAdditionMixed(JacobianPoint&       result, 
+                                                           const JacobianPoint& P, 
+                                                           const JacobianPoint& Q,
+                                                           Workspace&           workspace) const
+{
+  if ( isInfinity(P) )
+  {
+    result = Q;
+    return;
+  }
+
+  Element& z1_squared = workspace.elements[0];
+  Element& u2         = workspace.elements[1];
+  Element& s2         = workspace.elements[2];
+  Element& h          = workspace.elements[3];
+  Element& r          = workspace.elements[4];
+  Element& h_squared  = workspace.elements[5];
+  Element& h_cubed    = workspace.elements[6];
+  Element& v          = workspace.elements[7];
+
+  /// With Z2 = 1, U1 = X1 and S1 = Y1. U2 = X2 * Z1^2, S2 = Y2 * Z1^3
+  field.sqr(z1_squared, P.Z);
+  field.mul(u2,         Q.X, z1_squared);
+  field.mul(s2,         Q.Y, z1_squared);
+  field.mul(s2,         s2,  P.Z);
+
+  /// H = U2 - X1, r = S2 - Y1
+  field.sub(h, u2, P.X);
+  field.sub(r, s2, P.Y);
+
+  if ( field.isZero(h) )
+  {
+    /// P == Q requires doubling, while P == -Q yields the point at infinity.
+    if ( field.isZero(r) )
+    {
+      pointDoubling(result, P, workspace);
+    }
+    else
+    {
+      setInfinity(result);
+    }
+    return;
+  }
+
+  /// V = X1 * H^2, and S2 now holds Y1 * H^3.
+  field.sqr(h_squared, h);
+  field.mul(h_cubed,   h_squared, h);
+  field.mul(v,         P.X,       h_squared);
+  field.mul(s2,        P.Y,       h_cubed);
+
+  /// Z3 = Z1 * H. The inputs are no longer needed past this point.
+  field.mul(result.Z, P.Z, h);
+
+  /// X3 = r^2 - H^3 - 2V
+  field.sqr(result.X, r);
+  field.sub(result.X, result.X, h_cubed);
+  field.sub(result.X, result.X, v);
+  field.sub(result.X, result.X, v);
+
+  /// Y3 = r(V - X3) - Y1 * H^3
+  field.sub(u2,       v,  result.X);
+  field.mul(u2,       u2, r);
+  field.sub(result.Y, u2, s2);
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+void JacobianArithmetic<Field, Traits>::
+pointAdditionMixedBranchFree(JacobianPoint&       result, 
+                             const JacobianPoint& P, 
+                             const JacobianPoint& Q,
+                             const JacobianPoint& Q_doubled,
+                             Workspace&           workspace) const
+{
+  Element& z1_squared = workspace.elements[0];
+  Element& u2         = workspace.elements[1];
+  Element& s2         = workspace.elements[2];
+  Element& h          = workspace.elements[3];
+  Element& r          = workspace.elements[4];
+  Element& h_squared  = workspace.elements[5];
+  Element& h_cubed    = workspace.elements[6];
+  Element& v          = workspace.elements[7];
+  Element& X3         = workspace.elements[8];
+  Element& Y3         = workspace.elements[9];
+  Element& Z3         = workspace.elements[10];
+
+  const unsigned int P_at_infinity = field.isZero(P.Z) ? 1u : 0u;
+  const unsigned int Q_at_infinity = field.isZero(Q.Z) ? 1u : 0u;
+
+  /// The same formulas as pointAdditionMixed(), with Z2 = 1.
+  field.sqr(z1_squared, P.Z);
+  field.mul(u2,         Q.X, z1_squared);
+  field.mul(s2,         Q.Y, z1_squared);
+  field.mul(s2,         s2,  P.Z);
+  field.sub(h,          u2,  P.X);
+  field.sub(r,          s2,  P.Y);
+
+  /// H = r = 0 only when P == Q, given that neither is at infinity.
+  const unsigned int doubling = 
+    ( field.isZero(h) ? 1u : 0u ) & ( field.isZero(r) ? 1u : 0u ) & 
+    ( P_at_infinity ^ 1u ) & ( Q_at_infinity ^ 1u );
+
+  field.sqr(h_squared, h);
+  field.mul(h_cubed,   h_squared, h);
+  field.mul(v,         P.X,       h_squared);
+  field.mul(s2,        P.Y,       h_cubed);
+  field.mul(Z3,        P.Z,       h);
+
+  field.sqr(X3, r);
+  field.sub(X3, X3, h_cubed);
+  field.sub(X3, X3, v);
+  field.sub(X3, X3, v);
+
+  field.sub(u2, v,  X3);
+  field.mul(u2, u2, r);
+  field.sub(Y3, u2, s2);
+
+  /// P is read for the last time here, so result may alias it.
+  field.conditionalMove(X3, Q_doubled.X, doubling);
+  field.conditionalMove(Y3, Q_doubled.Y, doubling);
+  field.conditionalMove(Z3, Q_doubled.Z, doubling);
+  field.conditionalMove(X3, Q.X,         P_at_infinity);
+  field.conditionalMove(Y3, Q.Y,         P_at_infinity);
+  field.conditionalMove(Z3, Q.Z,         P_at_infinity);
+  field.conditionalMove(X3, P.X,         Q_at_infinity);
+  field.conditionalMove(Y3, P.Y,         Q_at_infinity);
+  field.conditionalMove(Z3, P.Z,         Q_at_infinity);
+
+  result.X = X3;
+  result.Y = Y3;
+  result.Z = Z3;
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+inline void 
+JacobianArithmetic<Field, Traits>::toProjective(ProjectivePoint&            result, 
+                                                const EllipticCurve::Point& P,
+                                                Workspace&                  workspace) const
+{
+  const unsigned int at_infinity = P.at_infinity ? 1u : 0u;
+
+  Element& zero = workspace.elements[0];
+  Element& one  = workspace.elements[1];
+  field.setZero(zero);
+  field.setOne (one);
+
+  field.fromMpz(result.X, P.x);
+  field.fromMpz(result.Y, P.y);
+  result.Z = one;
+
+  field.conditionalMove(result.X, zero, at_infinity);
+  field.conditionalMove(result.Y, one,  at_infinity);
+  field.conditionalMove(result.Z, zero, at_infinity);
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+inline void 
+JacobianArithmetic<Field, Traits>::fromProjective(JacobianPoint&         result, 
+                                                  const ProjectivePoint& P,
+                                                  Workspace&             workspace) const
+{
+  const unsigned int at_infinity = field.isZero(P.Z) ? 1u : 0u;
+
+  Element& z_squared = workspace.elements[0];
+  Element& one       = workspace.elements[1];
+
+  /// (X / Z, Y / Z) = (XZ / Z^2, YZ^2 / Z^3).
+  field.sqr(z_squared, P.Z);
+  field.mul(result.X,  P.X, P.Z);
+  field.mul(result.Y,  P.Y, z_squared);
+  result.Z = P.Z;
+
+  /// Infinity would map to (0, 0, 0), so replace it with (1, 1, 0).
+  field.setOne         (one);
+  field.conditionalMove(result.X, one, at_infinity);
+  field.conditionalMove(result.Y, one, at_infinity);
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+inline unsigned int JacobianArithmetic<Field, Traits>::readBits(const mp_limb_t* limbs, 
+                                                                std::size_t      position, 
+                                                                unsigned int     count)
+{
+  const std::size_t  index = position / GMP_NUMB_BITS;
+  const unsigned int shift = position % GMP_NUMB_BITS;
+
+  mp_limb_t bits = limbs[index] >> shift;
+  if ( shift + count > GMP_NUMB_BITS )
+  {
+    bits |= limbs[index + 1] << ( GMP_NUMB_BITS - shift );
+  }
+
+  return static_cast<unsigned int>(bits & ( ( mp_limb_t(1) << count ) - 1u ));
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+unsigned int JacobianArithmetic<Field, Traits>::recodeRegular(int         digits[MAX_REGULAR_DIGITS], 
+                                                              mpz_srcptr  scalar, 
+                                                              std::size_t num_digits)
+{
+  const unsigned int w = CONSTANT_TIME_WINDOW_BITS;
+
+  if ( num_digits > MAX_REGULAR_DIGITS )
+  {
+    throw std::invalid_argument("Scalar is longer than twice the largest field.");
+  }
+
+  /// Copy the scalar's magnitude into a fixed number of limbs, with a spare.
+  mp_limb_t limbs[( MAX_REGULAR_DIGITS * CONSTANT_TIME_WINDOW_BITS + 
+                    GMP_NUMB_BITS - 1 ) / GMP_NUMB_BITS + 1] = { 0 };
+  std::copy(mpz_limbs_read(scalar), 
+            mpz_limbs_read(scalar) + mpz_size(scalar), 
+            limbs);
+
+  /** The recoding needs an odd scalar, so recode k | 1 and let the caller 
+      subtract P at the end if k was even. Digit i is 
+      2 * bits[wi + 1, wi + w] + 1 - 2^w, which is odd and in (-2^w, 2^w).
+  */
+  const unsigned int even = static_cast<unsigned int>(~limbs[0] & 1u);
+  limbs[0] |= 1u;
+
+  for ( std::size_t i = 0; i + 1 < num_digits; ++i )
+  {
+    digits[i] = 2 * static_cast<int>(readBits(limbs, i * w + 1, w)) 
+              + 1 - ( 1 << w );
+  }
+  digits[num_digits - 1] = 
+    2 * static_cast<int>(readBits(limbs, ( num_digits - 1 ) * w + 1, w - 1)) 
+    + 1;
+
+  sodium_memzero(limbs, sizeof(limbs));
+  return even;
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+void JacobianArithmetic<Field, Traits>::
+selectMultiple(JacobianPoint&                    result, 
+               JacobianPoint&                    result_doubled,
+               int                               digit, 
+               const std::vector<JacobianPoint>& table,
+               const std::vector<JacobianPoint>& doubled_table,
+               Workspace&                        workspace) const
+{
+  const unsigned int sign_bit  = std::numeric_limits<unsigned int>::digits - 1;
+  const unsigned int negative  = static_cast<unsigned int>(digit) >> sign_bit;
+  const unsigned int magnitude = 
+    ( static_cast<unsigned int>(digit) ^ ( 0u - negative ) ) + negative;
+  const unsigned int index     = magnitude >> 1;
+
+  result         = table[0];
+  result_doubled = doubled_table[0];
+  for ( unsigned int j = 1; j < table.size(); ++j )
+  {
+    /// The top bit of ~d & (d - 1) is set only when d == 0.
+    const unsigned int difference = index ^ j;
+    const unsigned int match      = 
+      ( ~difference & ( difference - 1u ) ) >> sign_bit;
+
+    field.conditionalMove(result.X,         table[j].X,         match);
+    field.conditionalMove(result.Y,         table[j].Y,         match);
+    field.conditionalMove(result.Z,         table[j].Z,         match);
+    field.conditionalMove(result_doubled.X, doubled_table[j].X, match);
+    field.conditionalMove(result_doubled.Y, doubled_table[j].Y, match);
+    field.conditionalMove(result_doubled.Z, doubled_table[j].Z, match);
+  }
+
+  Element& negated_y = workspace.elements[0];
+  field.neg            (negated_y,        result.Y);
+  field.conditionalMove(result.Y,         negated_y, negative);
+  field.neg            (negated_y,        result_doubled.Y);
+  field.conditionalMove(result_doubled.Y, negated_y, negative);
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+inline void 
+JacobianArithmetic<Field, Traits>::completeAddition(ProjectivePoint&       result, 
+                                                    const ProjectivePoint& P, 
+                                                    const ProjectivePoint& Q,
+                                                    Workspace&             workspace) const
+{
+  /// a is a public property of the curve.
+  if ( aIsMinusThree() )
+  {
+    completeAdditionMinusThree(result, P, Q, workspace);
+  }
+  else
+  {
+    completeAdditionGeneric(result, P, Q, workspace);
+  }
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+void JacobianArithmetic<Field, Traits>::
+completeAdditionMinusThree(ProjectivePoint&       result, 
+                           const ProjectivePoint& P, 
+                           const ProjectivePoint& Q,
+                           Workspace&             workspace) const
+{
+  Element& t0 = workspace.elements[0];
+  Element& t1 = workspace.elements[1];
+  Element& t2 = workspace.elements[2];
+  Element& t3 = workspace.elements[3];
+  Element& t4 = workspace.elements[4];
+  Element& X3 = workspace.elements[5];
+  Element& Y3 = workspace.elements[6];
+  Element& Z3 = workspace.elements[7];
+
+  field.mul(t0, P.X, Q.X);
+  field.mul(t1, P.Y, Q.Y);
+  field.mul(t2, P.Z, Q.Z);
+  field.add(t3, P.X, P.Y);
+  field.add(t4, Q.X, Q.Y);
+  field.mul(t3, t3,  t4);
+  field.add(t4, t0,  t1);
+  field.sub(t3, t3,  t4);
+  field.add(t4, P.Y, P.Z);
+  field.add(X3, Q.Y, Q.Z);
+  field.mul(t4, t4,  X3);
+  field.add(X3, t1,  t2);
+  field.sub(t4, t4,  X3);
+  field.add(X3, P.X, P.Z);
+  field.add(Y3, Q.X, Q.Z);
+  field.mul(X3, X3,  Y3);
+  field.add(Y3, t0,  t2);
+  field.sub(Y3, X3,  Y3);
+  field.mul(Z3, b,   t2);
+  field.sub(X3, Y3,  Z3);
+  field.add(Z3, X3,  X3);
+  field.add(X3, X3,  Z3);
+  field.sub(Z3, t1,  X3);
+  field.add(X3, t1,  X3);
+  field.mul(Y3, b,   Y3);
+  field.add(t1, t2,  t2);
+  field.add(t2, t1,  t2);
+  field.sub(Y3, Y3,  t2);
+  field.sub(Y3, Y3,  t0);
+  field.add(t1, Y3,  Y3);
+  field.add(Y3, t1,  Y3);
+  field.add(t1, t0,  t0);
+  field.add(t0, t1,  t0);
+  field.sub(t0, t0,  t2);
+  field.mul(t1, t4,  Y3);
+  field.mul(t2, t0,  Y3);
+  field.mul(Y3, X3,  Z3);
+  field.add(Y3, Y3,  t2);
+  field.mul(X3, t3,  X3);
+  field.sub(X3, X3,  t1);
+  field.mul(Z3, t4,  Z3);
+  field.mul(t1, t3,  t0);
+  field.add(Z3, Z3,  t1);
+
+  result.X = X3;
+  result.Y = Y3;
+  result.Z = Z3;
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+void JacobianArithmetic<Field, Traits>::
+completeAdditionGeneric(ProjectivePoint&       result, 
+                        const ProjectivePoint& P, 
+                        const ProjectivePoint& Q,
+                        Workspace&             workspace) const
+{
+  const Element& a = field.getA();
+
+  Element& t0 = workspace.elements[0];
+  Element& t1 = workspace.elements[1];
+  Element& t2 = workspace.elements[2];
+  Element& t3 = workspace.elements[3];
+  Element& t4 = workspace.elements[4];
+  Element& t5 = workspace.elements[5];
+  Element& X3 = workspace.elements[6];
+  Element& Y3 = workspace.elements[7];
+  Element& Z3 = workspace.elements[8];
+
+  field.mul(t0, P.X, Q.X);
+  field.mul(t1, P.Y, Q.Y);
+  field.mul(t2, P.Z, Q.Z);
+  field.add(t3, P.X, P.Y);
+  field.add(t4, Q.X, Q.Y);
+  field.mul(t3, t3,  t4);
+  field.add(t4, t0,  t1);
+  field.sub(t3, t3,  t4);
+  field.add(t4, P.X, P.Z);
+  field.add(t5, Q.X, Q.Z);
+  field.mul(t4, t4,  t5);
+  field.add(t5, t0,  t2);
+  field.sub(t4, t4,  t5);
+  field.add(t5, P.Y, P.Z);
+  field.add(X3, Q.Y, Q.Z);
+  field.mul(t5, t5,  X3);
+  field.add(X3, t1,  t2);
+  field.sub(t5, t5,  X3);
+  field.mul(Z3, a,   t4);
+  field.mul(X3, b3,  t2);
+  field.add(Z3, X3,  Z3);
+  field.sub(X3, t1,  Z3);
+  field.add(Z3, t1,  Z3);
+  field.mul(Y3, X3,  Z3);
+  field.add(t1, t0,  t0);
+  field.add(t1, t1,  t0);
+  field.mul(t2, a,   t2);
+  field.mul(t4, b3,  t4);
+  field.add(t1, t1,  t2);
+  field.sub(t2, t0,  t2);
+  field.mul(t2, a,   t2);
+  field.add(t4, t4,  t2);
+  field.mul(t0, t1,  t4);
+  field.add(Y3, Y3,  t0);
+  field.mul(t0, t5,  t4);
+  field.mul(X3, t3,  X3);
+  field.sub(X3, X3,  t0);
+  field.mul(t0, t3,  t1);
+  field.mul(Z3, t5,  Z3);
+  field.add(Z3, Z3,  t0);
+
+  result.X = X3;
+  result.Y = Y3;
+  result.Z = Z3;
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+EllipticCurve::Point 
+JacobianArithmetic<Field, Traits>::operate(const EllipticCurve::Point& P, 
+                                           const EllipticCurve::Point& Q) const
+{
+  JacobianPoint P_jacobian;
+  JacobianPoint Q_jacobian;
+  Workspace     workspace;
+
+  toJacobian(P_jacobian, P);
+  toJacobian(Q_jacobian, Q);
+
+  /// pointAddition() falls back to doubling when P == Q.
+  pointAddition(P_jacobian, P_jacobian, Q_jacobian, workspace);
+  return toAffine(P_jacobian);
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+EllipticCurve::Point 
+JacobianArithmetic<Field, Traits>::completeOperate(const EllipticCurve::Point& P, 
+                                                   const EllipticCurve::Point& Q) const
+{
+  ProjectivePoint P_projective;
+  ProjectivePoint Q_projective;
+  JacobianPoint   sum;
+  Workspace       workspace;
+
+  toProjective(P_projective, P, workspace);
+  toProjective(Q_projective, Q, workspace);
+
+  completeAddition(P_projective, P_projective, Q_projective, workspace);
+  fromProjective  (sum,          P_projective, workspace);
+  return toAffine(sum, true);
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+void JacobianArithmetic<Field, Traits>::setWindowBits(unsigned int window_bits_in)
+{
+  window_bits = window_bits_in;
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+void 
+JacobianArithmetic<Field, Traits>::recodeScalar(std::vector<signed char>& digits, 
+                                                mpz_srcptr                scalar_in) const
+{
+  /// mpz_tstbit() uses two's complement, so read the magnitude in place.
+  mpz_t             magnitude;
+  const mpz_srcptr  scalar   = 
+    mpz_roinit_n(magnitude, mpz_limbs_read(scalar_in), mpz_size(scalar_in));
+  const std::size_t num_bits = mpz_sizeinbase(scalar, 2);
+
+  /// A final carry may spill past the top bit.
+  digits.assign(num_bits + window_bits, 0);
+  if ( mpz_sgn(scalar) == 0 )
+  {
+    return;
+  }
+
+  if ( window_bits == 1 )
+  {
+    for ( std::size_t i = 0; i < num_bits; ++i )
+    {
+      digits[i] = mpz_tstbit(scalar, i);
+    }
+    return;
+  }
+
+  /** Scan for the next bit which differs from the carry, then emit the 
+      signed digit of the following window. A digit of 2^(w-1) or more is 
+      made negative by borrowing 2^w from the next window.
+  */
+  unsigned int carry = 0;
+  std::size_t  bit   = 0;
+  while ( bit < digits.size() )
+  {
+    if ( static_cast<unsigned int>(mpz_tstbit(scalar, bit)) == carry )
+    {
+      ++bit;
+      continue;
+    }
+
+    int window = carry;
+    for ( unsigned int i = 0; i < window_bits; ++i )
+    {
+      window += mpz_tstbit(scalar, bit + i) << i;
+    }
+
+    carry       = ( window >> ( window_bits - 1 ) ) & 1;
+    digits[bit] = static_cast<signed char>(window - ( carry << window_bits ));
+    bit        += window_bits;
+  }
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+void JacobianArithmetic<Field, Traits>::
+precomputeOddMultiples(std::vector<JacobianPoint>& positive, 
+                       std::vector<JacobianPoint>& negative, 
+                       const JacobianPoint&        P,
+                       Workspace&                  workspace) const
+{
+  const std::size_t count = 
+    ( window_bits == 1 ) ? 1u : ( std::size_t(1) << ( window_bits - 2 ) );
+
+  positive.resize(count);
+  negative.resize(count);
+
+  positive[0] = P;
+  if ( count > 1 )
+  {
+    JacobianPoint P_doubled;
+    pointDoubling(P_doubled, P, workspace);
+
+    for ( std::size_t i = 1; i < count; ++i )
+    {
+      pointAddition(positive[i], positive[i - 1], P_doubled, workspace);
+    }
+  }
+
+  /// Negation only flips the sign of Y.
+  for ( std::size_t i = 0; i < count; ++i )
+  {
+    negative[i] = positive[i];
+    field.neg(negative[i].Y, negative[i].Y);
+  }
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+inline void 
+JacobianArithmetic<Field, Traits>::addDigit(JacobianPoint&                    T, 
+                                            signed char                       digit,
+                                            const std::vector<JacobianPoint>& positive, 
+                                            const std::vector<JacobianPoint>& negative,
+                                            Workspace&                        workspace) const
+{
+  if ( digit > 0 )
+  {
+    pointAddition(T, T, positive[( digit - 1 ) / 2], workspace);
+  }
+  else if ( digit < 0 )
+  {
+    pointAddition(T, T, negative[( -digit - 1 ) / 2], workspace);
+  }
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+EllipticCurve::Point JacobianArithmetic<Field, Traits>::
+scalarMultiplication(const mpz_t& scalar, const EllipticCurve::Point& P) const
+{
+  if ( P.at_infinity || mpz_sgn(scalar) == 0 )
+  {
+    return EllipticCurve::Point();
+  }
+
+  JacobianPoint P_jacobian;
+  toJacobian(P_jacobian, P);
+  if ( mpz_sgn(scalar) < 0 )
+  {
+    field.neg(P_jacobian.Y, P_jacobian.Y);
+  }
+
+  std::vector<signed char>   digits;
+  std::vector<JacobianPoint> positive;
+  std::vector<JacobianPoint> negative;
+  Workspace                  workspace;
+  recodeScalar          (digits,   scalar);
+  precomputeOddMultiples(positive, negative, P_jacobian, workspace);
+
+  JacobianPoint T;
+  setInfinity(T);
+
+  for ( std::size_t i = digits.size(); i-- > 0; )
+  {
+    pointDoubling(T, T, workspace);
+    addDigit     (T, digits[i], positive, negative, workspace);
+  }
+
+  /// Only a single inversion is needed to return to affine coordinates.
+  return toAffine(T);
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+EllipticCurve::Point JacobianArithmetic<Field, Traits>::
+constantTimeScalarMultiplication(const mpz_t&                scalar, 
+                                 const EllipticCurve::Point& P) const
+{
+  const unsigned int w = CONSTANT_TIME_WINDOW_BITS;
+
+  if ( P.at_infinity )
+  {
+    return EllipticCurve::Point();
+  }
+
+  /// Every scalar below 2^field_bits takes the same number of windows.
+  const std::size_t scalar_bits = 
+    std::max<std::size_t>(field_bits, mpz_sizeinbase(scalar, 2));
+  const std::size_t num_digits  = ( scalar_bits + w - 1 ) / w;
+
+  int                digits[MAX_REGULAR_DIGITS];
+  const unsigned int even = recodeRegular(digits, scalar, num_digits);
+
+  /** table[j] = (2j + 1)P, normalized with a single inversion, and 
+      doubled_table[j] = 2(2j + 1)P, which is only ever moved into the result
+      and so needs no normalizing. P and the scalar's sign are public.
+  */
+  JacobianPoint multiple;
+  JacobianPoint P_doubled;
+  Workspace     workspace;
+  toJacobian(multiple, P);
+  if ( mpz_sgn(scalar) < 0 )
+  {
+    field.neg(multiple.Y, multiple.Y);
+  }
+  pointDoubling(P_doubled, multiple, workspace);
+
+  const std::size_t          table_size = std::size_t(1) << ( w - 1 );
+  std::vector<JacobianPoint> table        (table_size);
+  std::vector<JacobianPoint> doubled_table(table_size);
+  for ( std::size_t j = 0; j < table_size; ++j )
+  {
+    table[j] = multiple;
+    pointDoubling(doubled_table[j], multiple, workspace);
+    pointAddition(multiple,         multiple, P_doubled, workspace);
+  }
+  normalize(table);
+
+  /** Doublings and additions both stay in Jacobian coordinates, where they 
+      are cheapest. The mixed additions against the normalized table mask 
+      their exceptional cases, rather than going through complete formulas.
+  */
+  JacobianPoint R;
+  JacobianPoint T;
+  JacobianPoint T_doubled;
+
+  selectMultiple(R, T_doubled, digits[num_digits - 1], table, doubled_table, 
+                 workspace);
+
+  for ( std::size_t i = num_digits - 1; i-- > 0; )
+  {
+    for ( unsigned int j = 0; j < w; ++j )
+    {
+      pointDoublingBranchFree(R, R, workspace);
+    }
+
+    selectMultiple              (T, T_doubled, digits[i], table, doubled_table, 
+                                 workspace);
+    pointAdditionMixedBranchFree(R, R, T, T_doubled, workspace);
+  }
+
+  /// Add -P if the scalar was even, keeping the sum only then.
+  JacobianPoint sum;
+  T         = table[0];
+  T_doubled = doubled_table[0];
+  field.neg(T.Y,         T.Y);
+  field.neg(T_doubled.Y, T_doubled.Y);
+  pointAdditionMixedBranchFree(sum, R, T, T_doubled, workspace);
+
+  field.conditionalMove(R.X, sum.X, even);
+  field.conditionalMove(R.Y, sum.Y, even);
+  field.conditionalMove(R.Z, sum.Z, even);
+
+  sodium_memzero(digits, sizeof(digits));
+  return toAffine(R, true);
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+EllipticCurve::Point 
+JacobianArithmetic<Field, Traits>::negatePoint(const EllipticCurve::Point& P) const
+{
+  if ( P.at_infinity )
+  {
+    return P;
+  }
+
+  EllipticCurve::Point result;
+  Element              y;
+
+  field.fromMpz(y,        P.y);
+  field.neg    (y,        y);
+  field.toMpz  (result.y, y);
+  mpz_set      (result.x, P.x);
+
+  result.at_infinity = false;
+  return result;
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+bool 
+JacobianArithmetic<Field, Traits>::decompressPoint(EllipticCurve::Point& result, 
+                                                   const mpz_t&          x, 
+                                                   unsigned int          y_is_odd) const
+{
+  Element x_element;
+  Element rhs;
+  Element y;
+  Element negated_y;
+
+  /// y^2 = x^3 + ax + b
+  field.fromMpz(x_element, x);
+  field.sqr    (rhs,       x_element);
+  field.add    (rhs,       rhs, field.getA());
+  field.mul    (rhs,       rhs, x_element);
+  field.add    (rhs,       rhs, b);
+
+  if ( !field.squareRoot(y, rhs) )
+  {
+    return false;
+  }
+
+  /// The roots are y and p - y, of opposite parity unless y = 0.
+  field.toMpz(result.y, y);
+  if ( static_cast<unsigned int>(mpz_odd_p(result.y)) != ( y_is_odd & 1u ) )
+  {
+    if ( field.isZero(y) )
+    {
+      return false;
+    }
+
+    field.neg  (negated_y, y);
+    field.toMpz(result.y,  negated_y);
+  }
+
+  field.toMpz(result.x, x_element);
+  result.at_infinity = false;
+  return true;
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+void 
+JacobianArithmetic<Field, Traits>::normalize(std::vector<JacobianPoint>& points) const
+{
+  /// products[i] is the product of all finite Z coordinates before point i.
+  std::vector<Element> products(points.size());
+  Element              accumulator;
+  Element              z_inverse;
+  Element              z_inverse_squared;
+
+  field.setOne(accumulator);
+  for ( std::size_t i = 0; i < points.size(); ++i )
+  {
+    products[i] = accumulator;
+    if ( !isInfinity(points[i]) )
+    {
+      field.mul(accumulator, accumulator, points[i].Z);
+    }
+  }
+
+  /// accumulator holds the inverse of the product of every Z after point i.
+  field.invertVariableTime(accumulator, accumulator);
+  for ( std::size_t i = points.size(); i-- > 0; )
+  {
+    JacobianPoint& P = points[i];
+    if ( isInfinity(P) )
+    {
+      continue;
+    }
+
+    field.mul(z_inverse,   accumulator, products[i]);
+    field.mul(accumulator, accumulator, P.Z);
+
+    field.sqr(z_inverse_squared, z_inverse);
+    field.mul(P.X,               P.X,       z_inverse_squared);
+    field.mul(P.Y,               P.Y,       z_inverse_squared);
+    field.mul(P.Y,               P.Y,       z_inverse);
+    field.setOne(P.Z);
+  }
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+FixedBaseTable* JacobianArithmetic<Field, Traits>::
+createFixedBaseTable(const EllipticCurve::Point& base, 
+                     const mpz_t&                order,
+                     std::size_t                 max_bytes) const
+{
+  if ( base.at_infinity || mpz_sgn(order) <= 0 )
+  {
+    return nullptr;
+  }
+
+  const unsigned int scalar_bits = mpz_sizeinbase(order, 2);
+  const std::size_t  point_bytes = 3 * field.getElementBytes();
+
+  /** Pick the cheapest layout which fits into max_bytes. With the generic
+      formulas, an addition costs roughly 1.6 doublings, and each addition is
+      skipped when all of a column's bits are zero.
+  */
+  unsigned int best_teeth  = 0;
+  unsigned int best_blocks = 0;
+  double       best_cost   = 0.0;
+
+  for ( unsigned int teeth = 1; teeth <= MAX_COMB_TEETH; ++teeth )
+  {
+    const std::size_t  entries  = ( 1u << teeth ) - 1u;
+    const unsigned int row_bits = ( scalar_bits + teeth - 1 ) / teeth;
+
+    for ( unsigned int blocks = 1; blocks <= row_bits; ++blocks )
+    {
+      if ( blocks * entries * point_bytes > max_bytes )
+      {
+        break;
+      }
+
+      const unsigned int block_bits = ( row_bits + blocks - 1 ) / blocks;
+      const double       cost       = block_bits * 
+        ( 1.0 + 1.6 * blocks * entries / static_cast<double>(entries + 1) );
+
+      if ( best_teeth == 0 || cost < best_cost )
+      {
+        best_teeth  = teeth;
+        best_blocks = blocks;
+        best_cost   = cost;
+      }
+    }
+  }
+
+  if ( best_teeth == 0 )
+  {
+    return nullptr;
+  }
+
+  CombTable* table = new CombTable(order);
+  table->teeth      = best_teeth;
+  table->blocks     = best_blocks;
+  table->row_bits   = ( scalar_bits + best_teeth - 1 ) / best_teeth;
+  table->block_bits = ( table->row_bits + best_blocks - 1 ) / best_blocks;
+
+  const unsigned int entries = ( 1u << table->teeth ) - 1u;
+  table->points.resize(table->blocks * entries);
+  table->size_bytes = table->points.size() * point_bytes;
+
+  /// rows[i] = 2^(i * row_bits + j * block_bits) * P for the current block j.
+  std::vector<JacobianPoint> rows(table->teeth);
+  JacobianPoint              block_base;
+  Workspace                  workspace;
+  toJacobian(block_base, base);
+
+  for ( unsigned int j = 0; j < table->blocks; ++j )
+  {
+    rows[0] = block_base;
+    for ( unsigned int i = 1; i < table->teeth; ++i )
+    {
+      rows[i] = rows[i - 1];
+      for ( unsigned int k = 0; k < table->row_bits; ++k )
+      {
+        pointDoubling(rows[i], rows[i], workspace);
+      }
+    }
+
+    /// Each entry extends a smaller entry by its most significant tooth.
+    JacobianPoint* block_entries = &table->points[j * entries];
+    for ( unsigned int u = 1; u <= entries; ++u )
+    {
+      unsigned int top = 0;
+      while ( ( u >> ( top + 1 ) ) != 0 )
+      {
+        ++top;
+      }
+
+      const unsigned int rest = u ^ ( 1u << top );
+      if ( rest == 0 )
+      {
+        block_entries[u - 1] = rows[top];
+      }
+      else
+      {
+        pointAddition(block_entries[u - 1], 
+                      block_entries[rest - 1], 
+                      rows[top], 
+                      workspace);
+      }
+    }
+
+    for ( unsigned int k = 0; k < table->block_bits; ++k )
+    {
+      pointDoubling(block_base, block_base, workspace);
+    }
+  }
+
+  normalize(table->points);
+  return table;
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+mpz_srcptr 
+JacobianArithmetic<Field, Traits>::reduceCombScalar(mpz_t            reduced, 
+                                                    mpz_srcptr       scalar, 
+                                                    const CombTable& table) const
+{
+  if ( mpz_sgn(scalar) < 0 || 
+       mpz_sizeinbase(scalar, 2) > table.teeth * table.row_bits )
+  {
+    mpz_mod(reduced, scalar, table.order);
+    return reduced;
+  }
+
+  return scalar;
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+void JacobianArithmetic<Field, Traits>::addCombColumn(JacobianPoint&   T, 
+                                                      mpz_srcptr       scalar, 
+                                                      const CombTable& table, 
+                                                      unsigned int     column,
+                                                      Workspace&       workspace) const
+{
+  for ( unsigned int j = 0; j < table.blocks; ++j )
+  {
+    /// Columns past the end of a row belong to the next row.
+    const unsigned int bit = j * table.block_bits + column;
+    if ( bit >= table.row_bits )
+    {
+      break;
+    }
+
+    unsigned int u = 0;
+    for ( unsigned int i = 0; i < table.teeth; ++i )
+    {
+      u |= mpz_tstbit(scalar, i * table.row_bits + bit) << i;
+    }
+
+    if ( u != 0 )
+    {
+      pointAddition(T, T, table.getEntry(j, u), workspace);
+    }
+  }
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+EllipticCurve::Point JacobianArithmetic<Field, Traits>::
+fixedBaseMultiplication(const mpz_t&          scalar, 
+                        const FixedBaseTable& table_in) const
+{
+  const CombTable& table = static_cast<const CombTable&>(table_in);
+
+  mpz_t reduced;
+  mpz_init(reduced);
+  const mpz_srcptr bits = reduceCombScalar(reduced, scalar, table);
+
+  JacobianPoint T;
+  Workspace     workspace;
+  setInfinity(T);
+
+  for ( int k = table.block_bits - 1; k >= 0; --k )
+  {
+    pointDoubling(T, T, workspace);
+    addCombColumn(T, bits, table, k, workspace);
+  }
+
+  mpz_clear(reduced);
+  return toAffine(T);
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+EllipticCurve::Point JacobianArithmetic<Field, Traits>::multiScalarMultiplication(
+  const std::vector<EllipticCurve::MultiplicationTerm>& terms) const
+{
+  JacobianPoint T;
+  Workspace     workspace;
+  sumMultiples(T, terms, workspace);
+  return toAffine(T);
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+std::vector<EllipticCurve::Point> 
+JacobianArithmetic<Field, Traits>::batchMultiScalarMultiplication(
+  const std::vector<std::vector<EllipticCurve::MultiplicationTerm>>& batch) const
+{
+  std::vector<JacobianPoint> sums(batch.size());
+  Workspace                  workspace;
+  for ( std::size_t i = 0; i < batch.size(); ++i )
+  {
+    sumMultiples(sums[i], batch[i], workspace);
+  }
+
+  /// One inversion normalizes every sum, so toAffine() needs no more.
+  normalize(sums);
+
+  std::vector<EllipticCurve::Point> results;
+  results.reserve(sums.size());
+  for ( const JacobianPoint& sum : sums )
+  {
+    results.push_back(toAffine(sum));
+  }
+
+  return results;
+}
+
+// ============================================================================
+template <typename Field, typename Traits>
+void JacobianArithmetic<Field, Traits>::sumMultiples(
+  JacobianPoint&                                        T,
+  const std::vector<EllipticCurve::MultiplicationTerm>& terms,
+  Workspace&                                            workspace) const
+{
+  /// Per-term state: either a comb table, or a recoded scalar and its table.
+  struct TermState
+  {
+    TermState()
+      : reduced(), bits(nullptr), comb(nullptr), digits(), positive(), 
+        negative()
+    {
+      mpz_init(reduced);
+    }
+
+    ~TermState()
+    {
+      mpz_clear(reduced);
+    }
+
+    mpz_t                      reduced;
+    mpz_srcptr                 bits;
+    const CombTable*           comb;
+    std::vector<signed char>   digits;
+    std::vector<JacobianPoint> positive;
+    std::vector<JacobianPoint> negative;
+  };
+
+  std::unique_ptr<TermState[]> states(new TermState[terms.size()]);
+  unsigned int                 chain_length = 0;
+
+  for ( std::size_t i = 0; i < terms.size(); ++i )
+  {
+    const EllipticCurve::MultiplicationTerm& term  = terms[i];
+    TermState&                               state = states[i];
+
+    if ( term.table != nullptr )
+    {
+      state.comb = static_cast<const CombTable*>(term.table);
+      state.bits = reduceCombScalar(state.reduced, term.scalar, *state.comb);
+      chain_length = std::max(chain_length, state.comb->block_bits);
+      continue;
+    }
+
+    if ( term.point->at_infinity || mpz_sgn(term.scalar) == 0 )
+    {
+      continue;
+    }
+
+    /// The sign of the scalar is folded into P.
+    JacobianPoint P;
+    toJacobian(P, *term.point);
+    if ( mpz_sgn(term.scalar) < 0 )
+    {
+      field.neg(P.Y, P.Y);
+    }
+
+    recodeScalar          (state.digits,   term.scalar);
+    precomputeOddMultiples(state.positive, state.negative, P, workspace);
+
+    chain_length = std::max(chain_length, 
+                            static_cast<unsigned int>(state.digits.size()));
+  }
+
+  setInfinity(T);
+
+  for ( int k = chain_length - 1; k >= 0; --k )
+  {
+    pointDoubling(T, T, workspace);
+
+    for ( std::size_t i = 0; i < terms.size(); ++i )
+    {
+      const TermState& state = states[i];
+
+      /// Combs are aligned to the end of the chain.
+      if ( state.comb != nullptr )
+      {
+        if ( static_cast<unsigned int>(k) < state.comb->block_bits )
+        {
+          addCombColumn(T, state.bits, *state.comb, k, workspace);
+        }
+      }
+      else if ( static_cast<std::size_t>(k) < state.digits.size() )
+      {
+        addDigit(T, state.digits[k], state.positive, state.negative, workspace);
+      }
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,87 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+#ifndef CURVE_TRAITS_HPP
+#define CURVE_TRAITS_HPP
+
+#include "EllipticCurveConstants.hpp"
+
+/** Compile-time properties of a curve, used to specialize JacobianArithmetic.
+    Where a property is not known at compile time, the arithmetic falls back 
+    to the value it reads from the curve parameters at run time. These are 
+    the traits of a curve which is only known at run time.
+*/
+struct RuntimeCurveTraits
+{
+  /// @brief The number of 64-bit limbs in a field element, or 0 if unknown.
+  static constexpr unsigned int NUM_LIMBS = 0u;
+
+  /** @brief True if a = -3 mod p, enabling the cheaper doubling and complete
+      addition formulas.
+  */
+  static constexpr bool A_IS_MINUS_THREE = false;
+
+  /// @brief True if the cofactor h is 1, so multiplying by h can be skipped.
+  static constexpr bool COFACTOR_IS_ONE = false;
+};
+
+/** The traits of each named curve in curve_parameters. Every flag must agree
+    with the curve's run-time parameters, which JacobianArithmetic checks on 
+    construction.
+*/
+template <Curves curve>
+struct CurveTraits;
+
+/// @brief Curve P-256, with p = 2^256 - 2^224 + 2^192 + 2^96 - 1.
+template <>
+struct CurveTraits<Curves::P256>
+{
+  static constexpr unsigned int FIELD_SIZE_BYTES = 32u;
+  static constexpr unsigned int NUM_LIMBS        = 4u;
+  static constexpr bool         A_IS_MINUS_THREE = true;
+  static constexpr bool         COFACTOR_IS_ONE  = true;
+};
+
+/// @brief Curve edwards25519, with p = 2^255 - 19. Its a is -1, not -3.
+template <>
+struct CurveTraits<Curves::EDWARDS25519>
+{
+  static constexpr unsigned int FIELD_SIZE_BYTES = 32u;
+  static constexpr unsigned int NUM_LIMBS        = 4u;
+  static constexpr bool         A_IS_MINUS_THREE = false;
+  static constexpr bool         COFACTOR_IS_ONE  = false;
+};
+
+/// @brief Curve secp256k1, with p = 2^256 - 2^32 - 977. Its a is 0.
+template <>
+struct CurveTraits<Curves::SECP256K1>
+{
+  static constexpr unsigned int FIELD_SIZE_BYTES = 32u;
+  static constexpr unsigned int NUM_LIMBS        = 4u;
+  static constexpr bool         A_IS_MINUS_THREE = false;
+  static constexpr bool         COFACTOR_IS_ONE  = true;
+};
+
+static_assert(CurveTraits<Curves::EDWARDS25519>::FIELD_SIZE_BYTES <= 
+              MAX_FIELD_SIZE_BYTES,
+              "edwards25519 must fit in the inline storage of EllipticCurve::Point.");
+static_assert(CurveTraits<Curves::SECP256K1>::FIELD_SIZE_BYTES <= 
+              MAX_FIELD_SIZE_BYTES,
+              "secp256k1 must fit in the inline storage of EllipticCurve::Point.");
+static_assert(CurveTraits<Curves::P256>::FIELD_SIZE_BYTES <= MAX_FIELD_SIZE_BYTES,
+              "P-256 must fit in the inline storage of EllipticCurve::Point.");
+static_assert(CurveTraits<Curves::P256>::NUM_LIMBS * 8u == 
+              CurveTraits<Curves::P256>::FIELD_SIZE_BYTES,
+              "P-256 field elements must fill a whole number of limbs.");
+
+#endif
@@ -0,0 +1,811 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+
+#include "Ed25519Arithmetic.hpp"
+
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+#include "Constants.hpp"
+#include "EllipticCurveConstants.hpp"
+#include "sodium.h"
+
+// ============================================================================
+Ed25519Arithmetic::Ed25519Arithmetic(const mpz_t& p_in, 
+                                     const mpz_t& a_in, 
+                                     const mpz_t& d_in)
+  : generator(),
+    field    (p_in, a_in),
+    d2       ()
+{
+  if ( sodium_init() < 0 )
+  {
+    throw std::runtime_error("libsodium failed to initialize.");
+  }
+
+  const CurveParameters& parameters = curve_parameters.at(Curves::EDWARDS25519);
+
+  mpz_inits(p, d, order, group_order, sqrt_minus_one, square_root_exponent, 
+            nullptr);
+  mpz_set_str(p,           parameters.p, Base::DECIMAL);
+  mpz_set_str(d,           parameters.b, Base::HEX);
+  mpz_set_str(order,       parameters.n, Base::DECIMAL);
+  mpz_set_str(group_order, parameters.h, Base::DECIMAL);
+  mpz_mul    (group_order, group_order,  order);
+
+  /// a == -1 mod p
+  mpz_add_ui(sqrt_minus_one, a_in, 1ul);
+  const bool valid = mpz_cmp(p, p_in) == 0 && mpz_cmp(d, d_in) == 0 &&
+                     mpz_divisible_p(sqrt_minus_one, p) != 0;
+
+  if ( !valid )
+  {
+    mpz_clears(p, d, order, group_order, sqrt_minus_one, square_root_exponent, 
+               nullptr);
+    throw std::invalid_argument("Ed25519Arithmetic requires the curve edwards25519.");
+  }
+
+  /// sqrt(-1) = 2^((p - 1) / 4), as 2 is not a square mod p.
+  mpz_sub_ui     (square_root_exponent, p, 1ul);
+  mpz_tdiv_q_2exp(square_root_exponent, square_root_exponent, 2ul);
+  mpz_set_ui     (sqrt_minus_one, 2ul);
+  mpz_powm       (sqrt_minus_one, sqrt_minus_one, square_root_exponent, p);
+
+  /// p = 5 mod 8, so value^((p + 3) / 8) is a root of value or of -value.
+  mpz_add_ui     (square_root_exponent, p, 3ul);
+  mpz_tdiv_q_2exp(square_root_exponent, square_root_exponent, 3ul);
+
+  field.fromMpz(d2, d);
+  field.add    (d2, d2, d2);
+
+  encode(generator, EllipticCurve::Point(parameters.gx, parameters.gy, Base::HEX));
+}
+
+// ============================================================================
+Ed25519Arithmetic::~Ed25519Arithmetic()
+{
+  mpz_clears(p, d, order, group_order, sqrt_minus_one, square_root_exponent, 
+             nullptr);
+}
+
+// ============================================================================
+EllipticCurve::Point 
+Ed25519Arithmetic::operate(const EllipticCurve::Point& P, 
+                           const EllipticCurve::Point& Q) const
+{
+  EncodedPoint encoded_P;
+  EncodedPoint encoded_Q;
+  encode(encoded_P, P);
+  encode(encoded_Q, Q);
+
+  add(encoded_P, encoded_P, encoded_Q);
+  return decode(encoded_P);
+}
+
+// ============================================================================
+EllipticCurve::Point 
+Ed25519Arithmetic::completeOperate(const EllipticCurve::Point& P, 
+                                   const EllipticCurve::Point& Q) const
+{
+  return operate(P, Q);
+}
+
+// ============================================================================
+EllipticCurve::Point 
+Ed25519Arithmetic::scalarMultiplication(const mpz_t&                scalar, 
+                                        const EllipticCurve::Point& P) const
+{
+  EncodedPoint encoded;
+  EncodedPoint product;
+  encode  (encoded, P);
+  multiply(product, scalar, encoded, isGenerator(encoded));
+  return decode(product);
+}
+
+// ============================================================================
+EllipticCurve::Point 
+Ed25519Arithmetic::constantTimeScalarMultiplication(
+  const mpz_t&                scalar, 
+  const EllipticCurve::Point& P) const
+{
+  return scalarMultiplication(scalar, P);
+}
+
+// ============================================================================
+EllipticCurve::Point 
+Ed25519Arithmetic::clearCofactor(const EllipticCurve::Point& P, 
+                                 const mpz_t&                /* cofactor */) const
+{
+  /// The doubling formula holds for any point on the curve, of any order.
+  ExtendedPoint cleared;
+  toExtended   (cleared, P);
+  pointDoubling(cleared, cleared);
+  pointDoubling(cleared, cleared);
+  pointDoubling(cleared, cleared);
+  return toAffine(cleared);
+}
+
+// ============================================================================
+void Ed25519Arithmetic::setWindowBits(unsigned int /* window_bits */)
+{
+}
+
+// ============================================================================
+EllipticCurve::Point 
+Ed25519Arithmetic::negatePoint(const EllipticCurve::Point& P) const
+{
+  if ( P.at_infinity || mpz_sgn(P.x) == 0 )
+  {
+    return P;
+  }
+
+  /** -(x, y) = (p - x, y). mpz_sub() needs a spare limb, which the inline 
+      coordinates of a Point do not have.
+  */
+  mpz_t negated_x;
+  mpz_init(negated_x);
+  mpz_sub (negated_x, p, P.x);
+
+  EllipticCurve::Point result(negated_x, P.y);
+  mpz_clear(negated_x);
+  return result;
+}
+
+// ============================================================================
+bool Ed25519Arithmetic::decompressPoint(EllipticCurve::Point& result, 
+                                        const mpz_t&          y, 
+                                        unsigned int          x_is_odd) const
+{
+  mpz_t u;
+  mpz_t v;
+  mpz_t x;
+  mpz_inits(u, v, x, nullptr);
+
+  /** x^2 = u / v, where u = y^2 - 1 and v = dy^2 + 1. v is never zero, as d
+      is not a square.
+  */
+  mpz_mul   (u, y, y);
+  mpz_mod   (u, u, p);
+  mpz_mul   (v, u, d);
+  mpz_add_ui(v, v, 1ul);
+  mpz_sub_ui(u, u, 1ul);
+  mpz_invert(v, v, p);
+  mpz_mul   (u, u, v);
+  mpz_mod   (u, u, p);
+
+  /// x is either u^((p + 3) / 8), or that times sqrt(-1).
+  mpz_powm(x, u, square_root_exponent, p);
+  mpz_mul (v, x, x);
+  mpz_sub (v, v, u);
+  if ( mpz_divisible_p(v, p) == 0 )
+  {
+    mpz_mul(x, x, sqrt_minus_one);
+    mpz_mod(x, x, p);
+    mpz_mul(v, x, x);
+    mpz_sub(v, v, u);
+  }
+
+  /// There is no odd choice of x = 0.
+  const bool on_curve = mpz_divisible_p(v, p) != 0 && 
+                        !( mpz_sgn(x) == 0 && x_is_odd != 0 );
+  if ( on_curve )
+  {
+    if ( ( mpz_odd_p(x) != 0 ) != ( x_is_odd != 0 ) )
+    {
+      mpz_sub(x, p, x);
+    }
+
+    if ( mpz_sgn(x) == 0 && mpz_cmp_ui(y, 1ul) == 0 )
+    {
+      result = EllipticCurve::Point();
+    }
+    else
+    {
+      mpz_set(result.x, x);
+      mpz_set(result.y, y);
+      result.at_infinity = false;
+    }
+  }
+
+  mpz_clears(u, v, x, nullptr);
+  return on_curve;
+}
+
+// ============================================================================
+FixedBaseTable* 
+Ed25519Arithmetic::createFixedBaseTable(const EllipticCurve::Point& base, 
+                                        const mpz_t&                /* order */,
+                                        std::size_t                 max_bytes) const
+{
+  if ( base.at_infinity || max_bytes < sizeof(EncodedPoint) )
+  {
+    return nullptr;
+  }
+
+  std::unique_ptr<EncodedBaseTable> table(new EncodedBaseTable());
+  encode(table->base, base);
+  table->is_generator = isGenerator(table->base);
+  table->in_subgroup  = table->is_generator || hasOrderN(base);
+
+  const std::size_t multiples_bytes = 
+    std::size_t(COMB_ROWS) * COMB_COLUMNS * sizeof(NielsPoint);
+  if ( table->is_generator || !table->in_subgroup || 
+       max_bytes < sizeof(EncodedPoint) + multiples_bytes )
+  {
+    return table.release();
+  }
+
+  /// Row k holds 256^k times the base, times 1 to 8.
+  std::vector<ExtendedPoint> multiples(COMB_ROWS * COMB_COLUMNS);
+  ExtendedPoint              row_base;
+  toExtended(row_base, base);
+  for ( unsigned int k = 0; k < COMB_ROWS; ++k )
+  {
+    ExtendedPoint* const row = &multiples[k * COMB_COLUMNS];
+    row[0] = row_base;
+    for ( unsigned int j = 1; j < COMB_COLUMNS; ++j )
+    {
+      pointAddition(row[j], row[j - 1], row_base);
+    }
+
+    for ( unsigned int i = 0; i < 8u; ++i )
+    {
+      pointDoubling(row_base, row_base);
+    }
+  }
+
+  normalize(table->multiples, multiples);
+  return table.release();
+}
+
+// ============================================================================
+EllipticCurve::Point 
+Ed25519Arithmetic::fixedBaseMultiplication(const mpz_t&          scalar, 
+                                           const FixedBaseTable& table_in) const
+{
+  const EncodedBaseTable& table = static_cast<const EncodedBaseTable&>(table_in);
+
+  if ( !table.multiples.empty() )
+  {
+    ExtendedPoint result;
+    combMultiplication(result, scalar, table);
+    return toAffine(result);
+  }
+
+  EncodedPoint result;
+  multiply(result, scalar, table.base, table.is_generator);
+  return decode(result);
+}
+
+// ============================================================================
+EllipticCurve::Point Ed25519Arithmetic::multiScalarMultiplication(
+  const std::vector<EllipticCurve::MultiplicationTerm>& terms) const
+{
+  EncodedPoint  sum;
+  EncodedPoint  product;
+  EncodedPoint  base;
+  ExtendedPoint comb_sum;
+  ExtendedPoint comb_product;
+  bool          has_comb_terms = false;
+  setIdentity(sum);
+  setIdentity(comb_sum);
+
+  /** Sum libsodium's products as encodings and the table's in extended 
+      coordinates, so x is recovered at most once, and there is at most one 
+      inversion.
+  */
+  for ( const EllipticCurve::MultiplicationTerm& term : terms )
+  {
+    if ( term.table != nullptr )
+    {
+      const EncodedBaseTable& table = 
+        static_cast<const EncodedBaseTable&>(*term.table);
+      if ( !table.multiples.empty() )
+      {
+        combMultiplication(comb_product, term.scalar, table);
+        pointAddition     (comb_sum,     comb_sum,    comb_product);
+        has_comb_terms = true;
+        continue;
+      }
+      multiply(product, term.scalar, table.base, table.is_generator);
+    }
+    else
+    {
+      encode  (base,    *term.point);
+      multiply(product, term.scalar, base, isGenerator(base));
+    }
+    add(sum, sum, product);
+  }
+
+  if ( !has_comb_terms )
+  {
+    return decode(sum);
+  }
+
+  if ( !isIdentity(sum) )
+  {
+    ExtendedPoint encoded_sum;
+    toExtended   (encoded_sum, decode(sum));
+    pointAddition(comb_sum,    comb_sum, encoded_sum);
+  }
+  return toAffine(comb_sum);
+}
+
+// ============================================================================
+std::vector<EllipticCurve::Point> Ed25519Arithmetic::batchMultiScalarMultiplication(
+  const std::vector<std::vector<EllipticCurve::MultiplicationTerm>>& batch) const
+{
+  std::vector<EllipticCurve::Point> results;
+  results.reserve(batch.size());
+  for ( const std::vector<EllipticCurve::MultiplicationTerm>& terms : batch )
+  {
+    results.push_back(multiScalarMultiplication(terms));
+  }
+  return results;
+}
+
+// ============================================================================
+void Ed25519Arithmetic::encode(EncodedPoint&               result, 
+                               const EllipticCurve::Point& P) const
+{
+  if ( P.at_infinity )
+  {
+    setIdentity(result);
+    return;
+  }
+
+  if ( mpz_sgn(P.y) < 0 || mpz_cmp(P.y, p) >= 0 )
+  {
+    throw std::invalid_argument("Point y coordinate is not in [0, p).");
+  }
+
+  /// y in little-endian, with the parity of x in the top bit.
+  std::memset(result.bytes, 0, ENCODED_BYTES);
+  mpz_export (result.bytes, nullptr, -1, 1, 0, 0, P.y);
+  if ( mpz_odd_p(P.x) )
+  {
+    result.bytes[ENCODED_BYTES - 1] |= 0x80u;
+  }
+}
+
+// ============================================================================
+EllipticCurve::Point Ed25519Arithmetic::decode(const EncodedPoint& encoded) const
+{
+  EncodedPoint y_bytes = encoded;
+  y_bytes.bytes[ENCODED_BYTES - 1] &= 0x7fu;
+
+  mpz_t y;
+  mpz_init  (y);
+  mpz_import(y, ENCODED_BYTES, -1, 1, 0, 0, y_bytes.bytes);
+
+  EllipticCurve::Point result;
+  const bool valid = 
+    decompressPoint(result, y, encoded.bytes[ENCODED_BYTES - 1] >> 7);
+  mpz_clear(y);
+
+  if ( !valid )
+  {
+    throw std::runtime_error("libsodium returned a point not on the curve.");
+  }
+  return result;
+}
+
+// ============================================================================
+bool Ed25519Arithmetic::isGenerator(const EncodedPoint& encoded) const
+{
+  return std::memcmp(encoded.bytes, generator.bytes, ENCODED_BYTES) == 0;
+}
+
+// ============================================================================
+bool Ed25519Arithmetic::isIdentity(const EncodedPoint& encoded)
+{
+  EncodedPoint identity;
+  setIdentity(identity);
+  return std::memcmp(encoded.bytes, identity.bytes, ENCODED_BYTES) == 0;
+}
+
+// ============================================================================
+void Ed25519Arithmetic::setIdentity(EncodedPoint& result)
+{
+  std::memset(result.bytes, 0, ENCODED_BYTES);
+  result.bytes[0] = 1u;
+}
+
+// ============================================================================
+void Ed25519Arithmetic::add(EncodedPoint&       result, 
+                            const EncodedPoint& P, 
+                            const EncodedPoint& Q)
+{
+  if ( crypto_core_ed25519_add(result.bytes, P.bytes, Q.bytes) != 0 )
+  {
+    throw std::invalid_argument("Point is not on edwards25519.");
+  }
+}
+
+// ============================================================================
+void Ed25519Arithmetic::multiply(EncodedPoint&       result, 
+                                 mpz_srcptr          scalar, 
+                                 const EncodedPoint& P,
+                                 bool                is_generator) const
+{
+  /// The neutral element has order 1, but libsodium refuses it.
+  if ( isIdentity(P) )
+  {
+    setIdentity(result);
+    return;
+  }
+
+  /** Only the generator is known to have order n. Any other point's order 
+      divides hn, so reducing modulo hn keeps the product exact for points 
+      outside the subgroup of order n.
+  */
+  mpz_t reduced;
+  mpz_init(reduced);
+  mpz_mod (reduced, scalar, is_generator ? order : group_order);
+
+  /** libsodium ignores bit 255, which hn - 1 exceeds by a margin of under 
+      2^128. In that case multiply by hn - scalar instead, and negate.
+  */
+  const bool negate = mpz_sizeinbase(reduced, 2) > 8u * ENCODED_BYTES - 1u;
+  if ( negate )
+  {
+    mpz_sub(reduced, group_order, reduced);
+  }
+
+  unsigned char scalar_bytes[ENCODED_BYTES] = {0};
+  mpz_export(scalar_bytes, nullptr, -1, 1, 0, 0, reduced);
+
+  /** libsodium fails for a zero scalar, for a product at infinity, and for 
+      a point of small order. The first two are the identity.
+  */
+  int status = -1;
+  if ( mpz_sgn(reduced) != 0 )
+  {
+    status = is_generator 
+           ? crypto_scalarmult_ed25519_base_noclamp(result.bytes, scalar_bytes)
+           : crypto_scalarmult_ed25519_noclamp     (result.bytes, scalar_bytes, P.bytes);
+  }
+
+  sodium_memzero(scalar_bytes, sizeof(scalar_bytes));
+  mpz_clear(reduced);
+
+  if ( status != 0 )
+  {
+    /// 8P is at infinity only for a point of small order.
+    EncodedPoint cleared = P;
+    add(cleared, cleared, cleared);
+    add(cleared, cleared, cleared);
+    add(cleared, cleared, cleared);
+    if ( isIdentity(cleared) )
+    {
+      throw std::invalid_argument("Point has small order. Clear the cofactor "
+                                  "before multiplying it.");
+    }
+
+    setIdentity(result);
+  }
+  else if ( negate )
+  {
+    EncodedPoint identity;
+    setIdentity(identity);
+    crypto_core_ed25519_sub(result.bytes, identity.bytes, result.bytes);
+  }
+}
+
+// ============================================================================
+void Ed25519Arithmetic::setIdentity(ExtendedPoint& result) const
+{
+  field.setZero(result.X);
+  field.setOne (result.Y);
+  field.setOne (result.Z);
+  field.setZero(result.T);
+}
+
+// ============================================================================
+void Ed25519Arithmetic::toExtended(ExtendedPoint&              result, 
+                                   const EllipticCurve::Point& P) const
+{
+  if ( P.at_infinity )
+  {
+    setIdentity(result);
+    return;
+  }
+
+  field.fromMpz(result.X, P.x);
+  field.fromMpz(result.Y, P.y);
+  field.setOne (result.Z);
+  field.mul    (result.T, result.X, result.Y);
+}
+
+// ============================================================================
+EllipticCurve::Point Ed25519Arithmetic::toAffine(const ExtendedPoint& P) const
+{
+  Element z_inverse;
+  Element coordinate;
+  field.invert(z_inverse, P.Z);
+
+  EllipticCurve::Point result;
+  field.mul  (coordinate, P.X, z_inverse);
+  field.toMpz(result.x,   coordinate);
+  field.mul  (coordinate, P.Y, z_inverse);
+  field.toMpz(result.y,   coordinate);
+
+  /// The neutral element, (0, 1), is the point at infinity.
+  result.at_infinity = mpz_sgn(result.x) == 0 && mpz_cmp_ui(result.y, 1ul) == 0;
+  return result.at_infinity ? EllipticCurve::Point() : result;
+}
+
+// ============================================================================
+bool Ed25519Arithmetic::hasOrderN(const EllipticCurve::Point& P) const
+{
+  /// nP, by double and add over the public order.
+  ExtendedPoint base;
+  ExtendedPoint product;
+  toExtended (base, P);
+  setIdentity(product);
+  for ( std::size_t bit = mpz_sizeinbase(order, 2); bit-- > 0; )
+  {
+    pointDoubling(product, product);
+    if ( mpz_tstbit(order, bit) )
+    {
+      pointAddition(product, product, base);
+    }
+  }
+
+  /// The neutral element has X = 0 and Y = Z.
+  Element difference;
+  field.sub(difference, product.Y, product.Z);
+  return field.isZero(product.X) && field.isZero(difference);
+}
+
+// ============================================================================
+void Ed25519Arithmetic::normalize(std::vector<NielsPoint>&          result, 
+                                  const std::vector<ExtendedPoint>& points) const
+{
+  /// products[i] is the product of every Z before point i. Z is never zero.
+  std::vector<Element> products(points.size());
+  Element              accumulator;
+  Element              z_inverse;
+  Element              x;
+  Element              y;
+
+  field.setOne(accumulator);
+  for ( std::size_t i = 0; i < points.size(); ++i )
+  {
+    products[i] = accumulator;
+    field.mul(accumulator, accumulator, points[i].Z);
+  }
+
+  /// accumulator holds the inverse of the product of every Z after point i.
+  field.invertVariableTime(accumulator, accumulator);
+  result.resize(points.size());
+  for ( std::size_t i = points.size(); i-- > 0; )
+  {
+    const ExtendedPoint& P = points[i];
+    NielsPoint&          Q = result[i];
+
+    field.mul(z_inverse,   accumulator, products[i]);
+    field.mul(accumulator, accumulator, P.Z);
+    field.mul(x,           P.X,         z_inverse);
+    field.mul(y,           P.Y,         z_inverse);
+
+    field.add(Q.y_plus_x,  y,      x);
+    field.sub(Q.y_minus_x, y,      x);
+    field.mul(Q.xy2d,      x,      y);
+    field.mul(Q.xy2d,      Q.xy2d, d2);
+  }
+}
+
+// ============================================================================
+void Ed25519Arithmetic::pointDoubling(ExtendedPoint&       result, 
+                                      const ExtendedPoint& P) const
+{
+  Element A;
+  Element B;
+  Element C;
+  Element E;
+  Element F;
+  Element G;
+  Element H;
+
+  /** dbl-2008-hwcd with a = -1: A = X^2, B = Y^2, C = 2Z^2, 
+      E = (X + Y)^2 - A - B, G = B - A, F = G - C, H = -A - B.
+  */
+  field.sqr(A, P.X);
+  field.sqr(B, P.Y);
+  field.sqr(C, P.Z);
+  field.add(C, C, C);
+  field.add(E, P.X, P.Y);
+  field.sqr(E, E);
+  field.add(H, A, B);
+  field.sub(E, E, H);
+  field.sub(G, B, A);
+  field.sub(F, G, C);
+  field.neg(H, H);
+
+  field.mul(result.X, E, F);
+  field.mul(result.Y, G, H);
+  field.mul(result.T, E, H);
+  field.mul(result.Z, F, G);
+}
+
+// ============================================================================
+void Ed25519Arithmetic::pointAddition(ExtendedPoint&       result, 
+                                      const ExtendedPoint& P, 
+                                      const ExtendedPoint& Q) const
+{
+  Element A;
+  Element B;
+  Element C;
+  Element D;
+  Element E;
+  Element F;
+  Element G;
+  Element H;
+
+  /** add-2008-hwcd-3: A = (Y1 - X1)(Y2 - X2), B = (Y1 + X1)(Y2 + X2), 
+      C = 2dT1T2, D = 2Z1Z2, E = B - A, F = D - C, G = D + C, H = B + A.
+  */
+  field.sub(A, P.Y, P.X);
+  field.sub(E, Q.Y, Q.X);
+  field.mul(A, A,   E);
+  field.add(B, P.Y, P.X);
+  field.add(E, Q.Y, Q.X);
+  field.mul(B, B,   E);
+  field.mul(C, P.T, Q.T);
+  field.mul(C, C,   d2);
+  field.mul(D, P.Z, Q.Z);
+  field.add(D, D,   D);
+
+  field.sub(E, B, A);
+  field.sub(F, D, C);
+  field.add(G, D, C);
+  field.add(H, B, A);
+
+  field.mul(result.X, E, F);
+  field.mul(result.Y, G, H);
+  field.mul(result.T, E, H);
+  field.mul(result.Z, F, G);
+}
+
+// ============================================================================
+void Ed25519Arithmetic::pointAdditionMixed(ExtendedPoint&       result, 
+                                           const ExtendedPoint& P, 
+                                           const NielsPoint&    Q) const
+{
+  Element A;
+  Element B;
+  Element C;
+  Element D;
+  Element E;
+  Element F;
+  Element G;
+  Element H;
+
+  /// madd-2008-hwcd-3, i.e. add-2008-hwcd-3 with Z2 = 1.
+  field.sub(A, P.Y, P.X);
+  field.mul(A, A,   Q.y_minus_x);
+  field.add(B, P.Y, P.X);
+  field.mul(B, B,   Q.y_plus_x);
+  field.mul(C, P.T, Q.xy2d);
+  field.add(D, P.Z, P.Z);
+
+  field.sub(E, B, A);
+  field.sub(F, D, C);
+  field.add(G, D, C);
+  field.add(H, B, A);
+
+  field.mul(result.X, E, F);
+  field.mul(result.Y, G, H);
+  field.mul(result.T, E, H);
+  field.mul(result.Z, F, G);
+}
+
+// ============================================================================
+void Ed25519Arithmetic::selectMultiple(NielsPoint&             result, 
+                                       const EncodedBaseTable& table,
+                                       unsigned int            row,
+                                       int                     digit) const
+{
+  const unsigned int sign_bit  = std::numeric_limits<unsigned int>::digits - 1;
+  const unsigned int negative  = static_cast<unsigned int>(digit) >> sign_bit;
+  const unsigned int magnitude = 
+    ( static_cast<unsigned int>(digit) ^ ( 0u - negative ) ) + negative;
+
+  /// The neutral element is (1, 1, 0).
+  field.setOne (result.y_plus_x);
+  field.setOne (result.y_minus_x);
+  field.setZero(result.xy2d);
+  for ( unsigned int j = 1; j <= COMB_COLUMNS; ++j )
+  {
+    /// The top bit of ~d & (d - 1) is set only when d == 0.
+    const unsigned int difference = magnitude ^ j;
+    const unsigned int match      = 
+      ( ~difference & ( difference - 1u ) ) >> sign_bit;
+
+    const NielsPoint& multiple = table.multiples[row * COMB_COLUMNS + j - 1];
+    field.conditionalMove(result.y_plus_x,  multiple.y_plus_x,  match);
+    field.conditionalMove(result.y_minus_x, multiple.y_minus_x, match);
+    field.conditionalMove(result.xy2d,      multiple.xy2d,      match);
+  }
+
+  /// -(x, y) = (-x, y) swaps y + x with y - x, and negates 2dxy.
+  const NielsPoint selected = result;
+  Element          negated_xy2d;
+  field.neg            (negated_xy2d,     selected.xy2d);
+  field.conditionalMove(result.y_plus_x,  selected.y_minus_x, negative);
+  field.conditionalMove(result.y_minus_x, selected.y_plus_x,  negative);
+  field.conditionalMove(result.xy2d,      negated_xy2d,       negative);
+}
+
+// ============================================================================
+void Ed25519Arithmetic::combMultiplication(ExtendedPoint&          result, 
+                                           mpz_srcptr              scalar, 
+                                           const EncodedBaseTable& table) const
+{
+  /// The base has order n, so n < 2^253 bounds the scalar.
+  mpz_t reduced;
+  mpz_init(reduced);
+  mpz_mod (reduced, scalar, order);
+
+  unsigned char scalar_bytes[ENCODED_BYTES] = {0};
+  mpz_export(scalar_bytes, nullptr, -1, 1, 0, 0, reduced);
+  mpz_clear (reduced);
+
+  /** Recode into 64 signed 4-bit digits in [-8, 8), borrowing 16 from the 
+      next digit. The top digit takes the last carry, and is at most 2.
+  */
+  signed char digits[2 * ENCODED_BYTES];
+  for ( std::size_t i = 0; i < ENCODED_BYTES; ++i )
+  {
+    digits[2 * i]     = static_cast<signed char>(scalar_bytes[i] & 15u);
+    digits[2 * i + 1] = static_cast<signed char>(scalar_bytes[i] >> 4);
+  }
+
+  signed char carry = 0;
+  for ( std::size_t i = 0; i + 1 < sizeof(digits); ++i )
+  {
+    digits[i] += carry;
+    carry      = static_cast<signed char>(( digits[i] + 8 ) >> 4);
+    digits[i] -= static_cast<signed char>(carry * 16);
+  }
+  digits[sizeof(digits) - 1] += carry;
+
+  /** The sum of the odd digits' multiples, times 16, plus the sum of the 
+      even digits' multiples. Digit i is in row i / 2.
+  */
+  NielsPoint multiple;
+  setIdentity(result);
+  for ( unsigned int i = 1; i < sizeof(digits); i += 2 )
+  {
+    selectMultiple    (multiple, table,  i / 2, digits[i]);
+    pointAdditionMixed(result,   result, multiple);
+  }
+
+  pointDoubling(result, result);
+  pointDoubling(result, result);
+  pointDoubling(result, result);
+  pointDoubling(result, result);
+
+  for ( unsigned int i = 0; i < sizeof(digits); i += 2 )
+  {
+    selectMultiple    (multiple, table,  i / 2, digits[i]);
+    pointAdditionMixed(result,   result, multiple);
+  }
+
+  sodium_memzero(scalar_bytes, sizeof(scalar_bytes));
+  sodium_memzero(digits,       sizeof(digits));
+}
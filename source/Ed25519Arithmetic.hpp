@@ -0,0 +1,307 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+#ifndef ED25519_ARITHMETIC_HPP
+#define ED25519_ARITHMETIC_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "CurveArithmetic.hpp"
+#include "EllipticCurve.hpp"
+#include "MpnField.hpp"
+
+#include <gmp.h>
+
+/** Point arithmetic for the twisted Edwards curve edwards25519, 
+    -x^2 + y^2 = 1 + dx^2y^2, built on libsodium's group operations. Points
+    enter and leave as affine (x, y), with the neutral element (0, 1) as the
+    point at infinity, and are handed to libsodium in their 32 byte RFC 8032 
+    encoding: y in little-endian, with the parity of x in the top bit. Only
+    leaving libsodium requires work - recovering x from y, with one 
+    exponentiation - so multi-scalar multiplications sum their terms as 
+    encodings and recover x once.
+
+    libsodium has no precomputation for points other than the generator, so
+    fixed base tables of other points in the subgroup of order n hold 
+    multiples of their own, in ref10's layout. These are multiplied with 
+    signed 4-bit digits and constant-time selection, and summed in extended 
+    coordinates over MpnField.
+
+    Scalars are reduced modulo the order of the whole group, hn, or n for 
+    the generator, and multiplied with libsodium's constant-time ladder, so 
+    products are exact for points outside the subgroup of order n as well. 
+    libsodium refuses points of small order, so multiplying one throws. 
+    clearCofactor() accepts any point, and SPAKE2 clears a peer's public 
+    key with it.
+    @cite https://www.rfc-editor.org/rfc/rfc8032.html#section-5.1
+    @cite https://libsodium.gitbook.io/doc/advanced/point-arithmetic
+*/
+class Ed25519Arithmetic : public CurveArithmetic
+{
+public:
+
+  /// @brief The size of an encoded point or scalar, in bytes.
+  static const std::size_t ENCODED_BYTES = 32u;
+
+  /** Construct the arithmetic for edwards25519. The parameters are only 
+      validated.
+      @param p_in The curve's prime modulus. Must be 2^255 - 19.
+      @param a_in The curve's a parameter. Must be -1 mod p.
+      @param d_in The curve's d parameter.
+      @throw std::invalid_argument if the parameters are not edwards25519.
+      @throw std::runtime_error if libsodium fails to initialize.
+  */
+  Ed25519Arithmetic(const mpz_t& p_in, const mpz_t& a_in, const mpz_t& d_in);
+
+  /// @brief The destructor clears memory allocated by mpz_inits().
+  ~Ed25519Arithmetic();
+
+  EllipticCurve::Point operate(const EllipticCurve::Point& P, 
+                               const EllipticCurve::Point& Q) const;
+
+  /// @brief The twisted Edwards addition law is already complete.
+  EllipticCurve::Point completeOperate(const EllipticCurve::Point& P, 
+                                       const EllipticCurve::Point& Q) const;
+
+  EllipticCurve::Point 
+  scalarMultiplication(const mpz_t& scalar, const EllipticCurve::Point& P) const;
+
+  /// @brief libsodium's ladder is already constant-time.
+  EllipticCurve::Point 
+  constantTimeScalarMultiplication(const mpz_t&                scalar, 
+                                   const EllipticCurve::Point& P) const;
+
+  /// @brief Three doublings, in extended coordinates.
+  EllipticCurve::Point clearCofactor(const EllipticCurve::Point& P, 
+                                     const mpz_t&                cofactor) const;
+
+  /// @brief libsodium uses its own fixed windows, so this does nothing.
+  void setWindowBits(unsigned int window_bits);
+
+  EllipticCurve::Point negatePoint(const EllipticCurve::Point& P) const;
+
+  /** Recover a point from its y coordinate and the parity of x, by solving 
+      x^2 = (y^2 - 1) / (dy^2 + 1).
+      @param result The point to place the recovered point into.
+      @param y The y coordinate, in [0, p).
+      @param x_is_odd 1 to select the odd root x, 0 to select the even one.
+      @return True if y and x_is_odd describe a point on the curve.
+  */
+  bool decompressPoint(EllipticCurve::Point& result, 
+                       const mpz_t&          y, 
+                       unsigned int          x_is_odd) const;
+
+  /** The table holds the base point's encoding, which libsodium multiplies 
+      without decoding it again. Multiples of the generator use libsodium's 
+      own precomputed table. Other bases of order n also get 256 multiples, 
+      if max_bytes allows, while bases outside that subgroup are only 
+      encoded.
+  */
+  FixedBaseTable* createFixedBaseTable(const EllipticCurve::Point& base, 
+                                       const mpz_t&                order,
+                                       std::size_t                 max_bytes) const;
+
+  EllipticCurve::Point fixedBaseMultiplication(const mpz_t&          scalar, 
+                                               const FixedBaseTable& table) const;
+
+  EllipticCurve::Point multiScalarMultiplication(
+    const std::vector<EllipticCurve::MultiplicationTerm>& terms) const;
+
+  /// @brief Each entry is summed separately, as libsodium has no batching.
+  std::vector<EllipticCurve::Point> batchMultiScalarMultiplication(
+    const std::vector<std::vector<EllipticCurve::MultiplicationTerm>>& batch) const;
+
+private:
+
+  /// @brief The RFC 8032 encoding of a point.
+  struct EncodedPoint
+  {
+    unsigned char bytes[ENCODED_BYTES];
+  };
+
+  typedef MpnField::Element Element;
+
+  /// @brief A point in extended coordinates, with x = X/Z, y = Y/Z, xy = T/Z.
+  struct ExtendedPoint
+  {
+    Element X;
+    Element Y;
+    Element Z;
+    Element T;
+  };
+
+  /// @brief An affine point as (y + x, y - x, 2dxy), for mixed addition.
+  struct NielsPoint
+  {
+    Element y_plus_x;
+    Element y_minus_x;
+    Element xy2d;
+  };
+
+  /// @brief The number of rows of multiples in a table, one per byte.
+  static const unsigned int COMB_ROWS = ENCODED_BYTES;
+
+  /// @brief The number of multiples in a row, for digits in [-8, 8].
+  static const unsigned int COMB_COLUMNS = 8u;
+
+  /** A base point's encoding, whether it is the generator, and whether it 
+      lies in the subgroup of order n. For such a base other than the 
+      generator, multiples[8k + j] is (j + 1)256^k times the base.
+  */
+  struct EncodedBaseTable : public FixedBaseTable
+  {
+    std::size_t getSizeBytes() const
+    {
+      return sizeof(base) + multiples.size() * sizeof(NielsPoint);
+    }
+
+    EncodedPoint            base;
+    bool                    is_generator;
+    bool                    in_subgroup;
+    std::vector<NielsPoint> multiples;
+  };
+
+  /// @brief The prime modulus, p = 2^255 - 19.
+  mpz_t p;
+
+  /// @brief The curve's d parameter.
+  mpz_t d;
+
+  /// @brief The order of the generator, n, and of the whole group, hn.
+  mpz_t order;
+  mpz_t group_order;
+
+  /// @brief sqrt(-1) mod p, and the square root exponent (p + 3) / 8.
+  mpz_t sqrt_minus_one;
+  mpz_t square_root_exponent;
+
+  /// @brief The encoding of the generator.
+  EncodedPoint generator;
+
+  /// @brief Field arithmetic modulo p, for the extended coordinates.
+  MpnField field;
+
+  /// @brief 2d, in Montgomery form.
+  Element d2;
+
+  /** Encode a point for libsodium.
+      @param result The encoding to place P into.
+      @param P The point to encode.
+      @throw std::invalid_argument if y is not in [0, p).
+  */
+  void encode(EncodedPoint& result, const EllipticCurve::Point& P) const;
+
+  /** Decode a point returned by libsodium, which is always valid.
+      @param encoded The encoding to decode.
+      @return The affine point.
+  */
+  EllipticCurve::Point decode(const EncodedPoint& encoded) const;
+
+  /// @brief Test if an encoding is that of the generator.
+  bool isGenerator(const EncodedPoint& encoded) const;
+
+  /// @brief Test if an encoding is that of the neutral element, (0, 1).
+  static bool isIdentity(const EncodedPoint& encoded);
+
+  /// @brief Set result to the encoding of the neutral element, (0, 1).
+  static void setIdentity(EncodedPoint& result);
+
+  /** result = P + Q, on encodings.
+      @throw std::invalid_argument if P or Q is not on the curve.
+  */
+  static void add(EncodedPoint&       result, 
+                  const EncodedPoint& P, 
+                  const EncodedPoint& Q);
+
+  /** result = scalar * P, on encodings.
+      @param result The encoding to place scalar * P into. Must not alias P.
+      @param scalar The scalar to multiply P by. May be negative.
+      @param P The encoding of the point to multiply.
+      @param is_generator True if P is the generator, selecting libsodium's 
+      precomputed table.
+      @throw std::invalid_argument if P has small order, other than the 
+      neutral element.
+  */
+  void multiply(EncodedPoint&       result, 
+                mpz_srcptr          scalar, 
+                const EncodedPoint& P,
+                bool                is_generator) const;
+
+  /// @brief Set result to the neutral element, (0 : 1 : 1 : 0).
+  void setIdentity(ExtendedPoint& result) const;
+
+  /// @brief Convert an affine point to extended coordinates.
+  void toExtended(ExtendedPoint& result, const EllipticCurve::Point& P) const;
+
+  /** Convert a point in extended coordinates to affine, with a 
+      constant-time inversion.
+      @param P The point to convert.
+      @return The affine point, at infinity for the neutral element.
+  */
+  EllipticCurve::Point toAffine(const ExtendedPoint& P) const;
+
+  /** Test if P lies in the subgroup of order n, by computing nP.
+      @param P The point to test, other than the point at infinity.
+      @return True if nP is the neutral element.
+  */
+  bool hasOrderN(const EllipticCurve::Point& P) const;
+
+  /** Convert points to their affine Niels form, with a single inversion.
+      @param result The vector to place the converted points into.
+      @param points The points to convert.
+  */
+  void normalize(std::vector<NielsPoint>&          result, 
+                 const std::vector<ExtendedPoint>& points) const;
+
+  /// @brief result = 2P, with the doubling formula for a = -1.
+  void pointDoubling(ExtendedPoint& result, const ExtendedPoint& P) const;
+
+  /// @brief result = P + Q, with the complete addition formula for a = -1.
+  void pointAddition(ExtendedPoint&       result, 
+                     const ExtendedPoint& P, 
+                     const ExtendedPoint& Q) const;
+
+  /// @brief result = P + Q, where Q is affine.
+  void pointAdditionMixed(ExtendedPoint&       result, 
+                          const ExtendedPoint& P, 
+                          const NielsPoint&    Q) const;
+
+  /** Select digit times the base of a row of a table, without branching on,
+      or indexing by, digit.
+      @param result The point to place the multiple into.
+      @param table The table to select from.
+      @param row The row of the table, k.
+      @param digit The multiple of 256^k times the base, in [-8, 8].
+  */
+  void selectMultiple(NielsPoint&             result, 
+                      const EncodedBaseTable& table,
+                      unsigned int            row,
+                      int                     digit) const;
+
+  /** result = scalar * base, with the multiples of a table. Runs in 
+      constant time, as libsodium's ladder does.
+      @param result The point to place the product into.
+      @param scalar The scalar to multiply the base by. May be negative.
+      @param table A table with multiples of its base.
+  */
+  void combMultiplication(ExtendedPoint&          result, 
+                          mpz_srcptr              scalar, 
+                          const EncodedBaseTable& table) const;
+
+  /// Both copy assignment and copy constructors are deleted.
+  Ed25519Arithmetic operator=(const Ed25519Arithmetic& object) = delete;
+  Ed25519Arithmetic          (const Ed25519Arithmetic& object) = delete;
+};
+
+#endif
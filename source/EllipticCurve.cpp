@@ -13,10 +13,22 @@
 
 #include "EllipticCurve.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
+#include "CurveArithmetic.hpp"
+#include "CurveTraits.hpp"
+#include "Ed25519Arithmetic.hpp"
 #include "EllipticCurveConstants.hpp"
+#include "MpnField.hpp"
+#include "MpzField.hpp"
+#include "P256Field.hpp"
+#include "P256LaneArithmetic.hpp"
+#include "Secp256k1Arithmetic.hpp"
+#include "StringHelpers.hpp"
 
 // ============================================================================
 EllipticCurve::EllipticCurve(const std::string& curve_name_in,
@@ -25,41 +37,59 @@ EllipticCurve::EllipticCurve(const std::string& curve_name_in,
                              unsigned int       p_in,
                              unsigned int       h_in,
                              unsigned int       n_in,
-                             unsigned int       field_size_bytes_in)
+                             unsigned int       field_size_bytes_in,
+                             ArithmeticBackends backend)
   : curve_name      (curve_name_in),
     a               (),
     b               (),
     p               (),
     h               (),
     n               (),
+    cofactor_is_one (h_in == 1u),
+    form            (CurveForms::SHORT_WEIERSTRASS),
     generator       (),
-    field_size_bytes(field_size_bytes_in)
+    field_size_bytes(field_size_bytes_in),
+    arithmetic      (),
+    generator_table ()
 {
   mpz_init_set_ui(a, a_in);
   mpz_init_set_ui(b, b_in);
   mpz_init_set_ui(p, p_in);
   mpz_init_set_ui(h, h_in);
   mpz_init_set_ui(n, n_in);
+
+  arithmetic.reset(createArithmetic(backend));
 }
 
 // ============================================================================
-EllipticCurve::EllipticCurve(Curves curve_name_in)
+EllipticCurve::EllipticCurve(Curves             curve_name_in,
+                             ArithmeticBackends backend,
+                             std::size_t        generator_table_bytes)
   : curve_name      (curve_parameters.at(curve_name_in).name),
     a               (),
     b               (),
     p               (),
     h               (),
     n               (),
+    cofactor_is_one (cofactorIsOne(curve_name_in)),
+    form            (curve_parameters.at(curve_name_in).form),
     generator       (),
-    field_size_bytes(curve_parameters.at(curve_name_in).field_size_bytes)
+    field_size_bytes(curve_parameters.at(curve_name_in).field_size_bytes),
+    arithmetic      (),
+    generator_table ()
 {
   mpz_init_set_str(a,           curve_parameters.at(curve_name_in).a,  10);
   mpz_init_set_str(b,           curve_parameters.at(curve_name_in).b,  16);
   mpz_init_set_str(p,           curve_parameters.at(curve_name_in).p,  10);
   mpz_init_set_str(h,           curve_parameters.at(curve_name_in).h,  10);
   mpz_init_set_str(n,           curve_parameters.at(curve_name_in).n,  10);
-  mpz_init_set_str(generator.x, curve_parameters.at(curve_name_in).gx, 16);
-  mpz_init_set_str(generator.y, curve_parameters.at(curve_name_in).gy, 16); 
+  generator = Point(curve_parameters.at(curve_name_in).gx, 
+                    curve_parameters.at(curve_name_in).gy, 
+                    Base::HEX);
+
+  arithmetic.reset(createArithmetic(backend));
+  generator_table.reset(
+    arithmetic->createFixedBaseTable(generator, n, generator_table_bytes));
 }
 
 // ============================================================================
@@ -68,6 +98,49 @@ EllipticCurve::~EllipticCurve()
   mpz_clears(a, b, p, h, n, nullptr);
 }
 
+// ============================================================================
+bool EllipticCurve::cofactorIsOne(Curves curve_name_in)
+{
+  switch ( curve_name_in )
+  {
+    case Curves::P256:
+      return CurveTraits<Curves::P256>::COFACTOR_IS_ONE;
+    case Curves::EDWARDS25519:
+      return CurveTraits<Curves::EDWARDS25519>::COFACTOR_IS_ONE;
+    case Curves::SECP256K1:
+      return CurveTraits<Curves::SECP256K1>::COFACTOR_IS_ONE;
+    default:
+      return false;
+  }
+}
+
+// ============================================================================
+CurveArithmetic* 
+EllipticCurve::createArithmetic(ArithmeticBackends backend) const
+{
+  if ( ( form == CurveForms::TWISTED_EDWARDS ) != 
+       ( backend == ArithmeticBackends::ED25519 ) )
+  {
+    throw std::invalid_argument("Twisted Edwards curves require the ED25519 "
+                                "backend, and it supports no other curve.");
+  }
+
+  switch ( backend )
+  {
+    case ArithmeticBackends::ED25519:
+      return new Ed25519Arithmetic(p, a, b);
+    case ArithmeticBackends::MPN:
+      return new JacobianArithmetic<MpnField>(p, a, b);
+    case ArithmeticBackends::P256:
+      return new P256LaneArithmetic(p, a, b);
+    case ArithmeticBackends::SECP256K1:
+      return new Secp256k1Arithmetic(p, a, b);
+    case ArithmeticBackends::MPZ:
+    default:
+      return new JacobianArithmetic<MpzField>(p, a, b);
+  }
+}
+
 // ============================================================================
 EllipticCurve::Point 
 EllipticCurve::operate(const Point& P, const Point& Q) const
@@ -82,151 +155,109 @@ EllipticCurve::operate(const Point& P, const Point& Q) const
     return P;
   }
 
-  return ( mpz_cmp(P.x, Q.x) == 0 && mpz_cmp(P.y, Q.y) == 0 )
-    ? pointDoubling(P, Q) 
-    : pointAddition(P, Q);
+  return arithmetic->operate(P, Q);
 }
 
 // ============================================================================
-EllipticCurve::
-Point EllipticCurve::pointAddition(const Point& P, const Point& Q) const
+EllipticCurve::Point 
+EllipticCurve::completeOperate(const Point& P, const Point& Q) const
 {
-  Point result;
+  if ( form == CurveForms::SHORT_WEIERSTRASS && !cofactor_is_one )
+  {
+    throw std::runtime_error("Complete addition requires a curve of prime order.");
+  }
 
-  mpz_t numerator;
-  mpz_t denominator;
-  mpz_t denominator_inverse;
-  mpz_t x_squared;
-  mpz_t x_squared_times_three;
-  mpz_t slope;
-  mpz_t intermediate;
-  
-  mpz_inits(numerator, 
-            denominator, 
-            denominator_inverse,
-            x_squared,
-            x_squared_times_three,
-            slope, 
-            intermediate,
-            nullptr);
-  
-  /// y2 - y1
-  mpz_sub(numerator, Q.y, P.y);
-
-  /// x2 - x1
-  mpz_sub(denominator, Q.x, P.x);
-
-  /// (x2 - x1)^-1
-  getInverse(denominator, denominator_inverse);
-
-  /// s = (y2 - y1)((x2 - x1)^-1)
-  mpz_mul(slope, numerator, denominator_inverse);
-
-  /// x3 = s^2 - x1 - 2x mod p
-  mpz_mul(result.x, slope, slope);
-  mpz_sub(result.x, result.x, P.x);
-  mpz_sub(result.x, result.x, Q.x);
-  mpz_mod(result.x, result.x, getPrimeModulus());
-
-  /// y3 = s(x1 - x3) - y1 mod p
-  mpz_sub(intermediate, P.x, result.x);
-  mpz_mul(result.y, slope, intermediate);
-  mpz_sub(result.y, result.y, P.y);
-  mpz_mod(result.y, result.y, getPrimeModulus());
-  
-  mpz_clears(numerator, 
-             denominator, 
-             denominator_inverse,
-             x_squared,
-             x_squared_times_three,
-             slope, 
-             intermediate,
-             nullptr);
-
-  result.at_infinity = false;
-  return result;
+  return arithmetic->completeOperate(P, Q);
 }
 
 // ============================================================================
 EllipticCurve::Point 
-EllipticCurve::pointDoubling(const Point& P, const Point& Q) const
+EllipticCurve::scalarMultiplication(const mpz_t& scalar, const Point& P) const
 {
-  Point result;
+  return arithmetic->scalarMultiplication(scalar, P);
+}
 
-  mpz_t numerator;
-  mpz_t denominator;
-  mpz_t denominator_inverse;
-  mpz_t x_squared;
-  mpz_t x_squared_times_three;
-  mpz_t intermediate;
-  mpz_t slope;
-
-  mpz_inits(numerator, 
-            denominator, 
-            denominator_inverse,
-            x_squared,
-            x_squared_times_three,
-            intermediate,
-            slope, 
-            nullptr);
-
-  /// 3x1^2 + a
-  mpz_mul   (x_squared,             P.x,                   P.x);
-  mpz_mul_ui(x_squared_times_three, x_squared,             3ul);
-  mpz_add   (numerator,             x_squared_times_three, getA());
-
-  /// (2y1)^-1
-  mpz_mul_ui(denominator, P.y, 2ul);
-  getInverse(denominator, denominator_inverse);
-
-  /// (3x1^2 + a)((2y1)^-1) % p
-  mpz_mul(slope, numerator, denominator_inverse);
-  mpz_mod(slope, slope,     getPrimeModulus());
-
-  /// x3 = s^2 - x1 - 2x mod p
-  mpz_mul(result.x, slope,    slope);
-  mpz_sub(result.x, result.x, P.x);
-  mpz_sub(result.x, result.x, Q.x);
-  mpz_mod(result.x, result.x, getPrimeModulus());
-
-  /// y3 = s(x1 - x3) - y1 mod p
-  mpz_sub(intermediate, P.x,      result.x);
-  mpz_mul(result.y,     slope,    intermediate);
-  mpz_sub(result.y,     result.y, P.y);
-  mpz_mod(result.y,     result.y, getPrimeModulus());
-
-  mpz_clears(numerator, 
-             denominator, 
-             denominator_inverse,
-             x_squared,
-             x_squared_times_three,
-             intermediate,
-             slope, 
-             nullptr);
-
-  result.at_infinity = false;
-  return result;
+// ============================================================================
+EllipticCurve::Point 
+EllipticCurve::constantTimeScalarMultiplication(const mpz_t& scalar, 
+                                                const Point& P) const
+{
+  return arithmetic->constantTimeScalarMultiplication(scalar, P);
+}
+
+// ============================================================================
+EllipticCurve::Point EllipticCurve::clearCofactor(const Point& P) const
+{
+  if ( cofactor_is_one || P.at_infinity )
+  {
+    return P;
+  }
+
+  return arithmetic->clearCofactor(P, h);
 }
 
 // ============================================================================
 EllipticCurve::Point 
-EllipticCurve::scalarMultiplication(const mpz_t& scalar, const Point& P) const
+EllipticCurve::fixedBaseMultiplication(const mpz_t& scalar) const
 {
-  /// Ignore the initial assignment bit (leftmost).
-  const unsigned int num_bits = mpz_sizeinbase(scalar, 2) - 1;
-  
-  Point T(P);
-  
-  for ( int i = num_bits - 1; i >= 0; --i )
+  if ( !generator_table )
   {
-    T = pointDoubling(T, T);
-    /// If bit is one.
-    if ( mpz_tstbit(scalar, i) )
-    {
-      T = pointAddition(T, P);
-    }
+    return arithmetic->scalarMultiplication(scalar, generator);
   }
-  return T;
+
+  return arithmetic->fixedBaseMultiplication(scalar, *generator_table);
+}
+
+// ============================================================================
+FixedBaseTable* EllipticCurve::createFixedBaseTable(const Point& base, 
+                                                    std::size_t  max_bytes) const
+{
+  return arithmetic->createFixedBaseTable(base, n, max_bytes);
+}
+
+// ============================================================================
+EllipticCurve::Point 
+EllipticCurve::fixedBaseMultiplication(const mpz_t&          scalar, 
+                                       const FixedBaseTable& table) const
+{
+  return arithmetic->fixedBaseMultiplication(scalar, table);
+}
+
+// ============================================================================
+EllipticCurve::Point EllipticCurve::
+multiScalarMultiplication(const std::vector<MultiplicationTerm>& terms) const
+{
+  return arithmetic->multiScalarMultiplication(terms);
+}
+
+// ============================================================================
+std::vector<EllipticCurve::Point> EllipticCurve::batchMultiScalarMultiplication(
+  const std::vector<std::vector<MultiplicationTerm>>& batch) const
+{
+  return arithmetic->batchMultiScalarMultiplication(batch);
+}
+
+// ============================================================================
+const FixedBaseTable* EllipticCurve::getGeneratorTable() const
+{
+  return generator_table.get();
+}
+
+// ============================================================================
+std::size_t EllipticCurve::getGeneratorTableBytes() const
+{
+  return generator_table ? generator_table->getSizeBytes() : 0u;
+}
+
+// ============================================================================
+void EllipticCurve::setWindowBits(unsigned int window_bits)
+{
+  if ( window_bits < 1 || window_bits > MAX_WINDOW_BITS )
+  {
+    throw std::invalid_argument("Window width must be in [1, MAX_WINDOW_BITS].");
+  }
+
+  arithmetic->setWindowBits(window_bits);
 }
 
 // ============================================================================
@@ -238,19 +269,198 @@ EllipticCurve::negatePoint(const EllipticCurve::Point& P) const
     return P;
   }
 
-  EllipticCurve::Point result;
+  return arithmetic->negatePoint(P);
+}
 
-  // Negation is reflected across the x-axis, so x_neg = x
-  mpz_set(result.x, P.x);
+// ============================================================================
+EllipticCurve::Point 
+EllipticCurve::decompressPoint(const mpz_t& x, bool y_is_odd) const
+{
+  if ( mpz_sgn(x) < 0 || mpz_cmp(x, p) >= 0 )
+  {
+    throw std::invalid_argument("Compressed point x coordinate is not in [0, p).");
+  }
 
-  // y_neg = -y mod p
-  mpz_neg(result.y, P.y);         
-  mpz_mod(result.y, result.y, p); 
-  
-  result.at_infinity = false;
+  Point result;
+  if ( !arithmetic->decompressPoint(result, x, y_is_odd ? 1u : 0u) )
+  {
+    throw std::invalid_argument("Compressed point is not on the curve.");
+  }
   return result;
 }
 
+// ============================================================================
+EllipticCurve::Point 
+EllipticCurve::decodePoint(const std::string& encoded) const
+{
+  const std::size_t start = ( encoded.rfind(HEX_PREFIX_LOWERCASE, 0) == 0 || 
+                              encoded.rfind(HEX_PREFIX_UPPERCASE, 0) == 0 ) 
+                            ? HEX_PREFIX_LEN 
+                            : 0;
+  const std::size_t coordinate_length = 2u * field_size_bytes;
+  const std::size_t length            = encoded.length() - start;
+
+  if ( encoded.find_first_not_of("0123456789abcdefABCDEF", start) != 
+       std::string::npos )
+  {
+    throw std::invalid_argument("Point encoding is not hexadecimal.");
+  }
+
+  if ( form == CurveForms::TWISTED_EDWARDS )
+  {
+    return decodeEdwardsPoint(encoded.substr(start));
+  }
+
+  const std::string tag = encoded.substr(start, 2);
+  if ( tag == "04" && length == 2u + 2u * coordinate_length )
+  {
+    Point result(encoded.substr(start + 2u,                     coordinate_length),
+                 encoded.substr(start + 2u + coordinate_length, coordinate_length),
+                 Base::HEX);
+    if ( mpz_cmp(result.x, p) >= 0 || mpz_cmp(result.y, p) >= 0 )
+    {
+      throw std::invalid_argument("Point coordinate is not in [0, p).");
+    }
+    if ( !isOnCurve(result) )
+    {
+      throw std::invalid_argument("Point is not on the curve.");
+    }
+    return result;
+  }
+
+  if ( ( tag == "02" || tag == "03" ) && length == 2u + coordinate_length )
+  {
+    mpz_t x;
+    mpz_init_set_str(x, encoded.substr(start + 2u).c_str(), Base::HEX);
+
+    try
+    {
+      const Point result = decompressPoint(x, tag == "03");
+      mpz_clear(x);
+      return result;
+    }
+    catch ( ... )
+    {
+      mpz_clear(x);
+      throw;
+    }
+  }
+
+  throw std::invalid_argument("Point encoding is not SEC1 compressed or "
+                              "uncompressed.");
+}
+
+// ============================================================================
+bool EllipticCurve::isOnCurve(const Point& P) const
+{
+  mpz_t lhs;
+  mpz_t rhs;
+  mpz_inits(lhs, rhs, nullptr);
+
+  /// y^2 = (x^2 + a)x + b
+  mpz_mul(lhs, P.y, P.y);
+  mpz_mul(rhs, P.x, P.x);
+  mpz_add(rhs, rhs, a);
+  mpz_mul(rhs, rhs, P.x);
+  mpz_add(rhs, rhs, b);
+  mpz_sub(lhs, lhs, rhs);
+
+  const bool on_curve = mpz_divisible_p(lhs, p) != 0;
+  mpz_clears(lhs, rhs, nullptr);
+  return on_curve;
+}
+
+// ============================================================================
+EllipticCurve::Point 
+EllipticCurve::decodeEdwardsPoint(const std::string& encoded) const
+{
+  if ( encoded.length() != 2u * field_size_bytes )
+  {
+    throw std::invalid_argument("Point encoding is not RFC 8032.");
+  }
+
+  /// The top bit is the parity of x, and the rest is y in little-endian.
+  std::vector<unsigned char> bytes = hexStringToBytes(encoded);
+  const bool x_is_odd = ( bytes.back() & 0x80u ) != 0;
+  bytes.back() &= 0x7fu;
+
+  mpz_t y;
+  mpz_init  (y);
+  mpz_import(y, bytes.size(), -1, 1, 0, 0, bytes.data());
+
+  /// RFC 8032 rejects a non-canonical y, rather than reducing it.
+  if ( mpz_cmp(y, p) >= 0 )
+  {
+    mpz_clear(y);
+    throw std::invalid_argument("Point coordinate is not in [0, p).");
+  }
+
+  try
+  {
+    const Point result = decompressPoint(y, x_is_odd);
+    mpz_clear(y);
+    return result;
+  }
+  catch ( ... )
+  {
+    mpz_clear(y);
+    throw;
+  }
+}
+
+// ============================================================================
+std::string EllipticCurve::encodePoint(const Point& P, bool preface_hex) const
+{
+  unsigned char     bytes[MAX_ENCODED_POINT_BYTES];
+  const std::size_t length = encodePointBytes(P, bytes);
+  return binaryToHexString(bytes, length, preface_hex);
+}
+
+// ============================================================================
+std::size_t EllipticCurve::encodePointBytes(const Point&   P, 
+                                            unsigned char* bytes) const
+{
+  if ( form == CurveForms::SHORT_WEIERSTRASS )
+  {
+    /// 04 || X || Y, with each coordinate padded to the field size.
+    const std::size_t length = 1u + 2u * field_size_bytes;
+    std::fill(bytes, bytes + length, 0u);
+    bytes[0] = 0x04u;
+    mpz_export(bytes + 1u + field_size_bytes - getMpzNumBytes(P.x), 
+               nullptr, 1, 1, 1, 0, P.x);
+    mpz_export(bytes + length - getMpzNumBytes(P.y), 
+               nullptr, 1, 1, 1, 0, P.y);
+    return length;
+  }
+
+  /// The neutral element, (0, 1), is held as the point at infinity.
+  std::fill(bytes, bytes + field_size_bytes, 0u);
+  if ( P.at_infinity )
+  {
+    bytes[0] = 1u;
+  }
+  else
+  {
+    mpz_export(bytes, nullptr, -1, 1, 0, 0, P.y);
+    if ( mpz_odd_p(P.x) )
+    {
+      bytes[field_size_bytes - 1u] |= 0x80u;
+    }
+  }
+  return field_size_bytes;
+}
+
+// ============================================================================
+std::size_t EllipticCurve::getEncodedByteCount(const Point& P) const
+{
+  if ( form == CurveForms::SHORT_WEIERSTRASS )
+  {
+    return P.getUncompressedByteCount();
+  }
+
+  return field_size_bytes;
+}
+
 std::ostream& operator<<(std::ostream& os, const EllipticCurve::Point& P)
 {
   if (P.at_infinity)
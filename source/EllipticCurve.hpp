@@ -14,14 +14,21 @@
 #ifndef ELLIPTIC_CURVE_HPP
 #define ELLIPTIC_CURVE_HPP
 
+#include <cstddef>
+#include <memory>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 #include "Constants.hpp"
 #include "EllipticCurveConstants.hpp"
 #include "MpzMathHelpers.hpp"
 #include <gmp.h>
 
+class CurveArithmetic;
+class FixedBaseTable;
+
 /** Class defining an Elliptic Curve, defined as an algebraic curve of the 
     form y^2 = x^3 + ax + b. An Elliptic Curve has no cusps or 
     self-intersections. This class provides the basic Elliptic Curve operations
@@ -43,6 +50,8 @@ public:
       @param n_in The number of elements within this curve, including the point 
       of infinity.
       @param field_size_bytes_in The size of the field for this curve, in bytes.
+      @param backend The field arithmetic to use for point operations.
+      @throw std::invalid_argument if backend does not support this curve.
    */
   EllipticCurve(const std::string& curve_name_in,
                 unsigned int       a_in,
@@ -50,58 +59,115 @@ public:
                 unsigned int       p_in,
                 unsigned int       h_in,
                 unsigned int       n_in,
-                unsigned int       field_size_bytes_in);
+                unsigned int       field_size_bytes_in,
+                ArithmeticBackends backend = ArithmeticBackends::MPZ);
 
   /** Construct an Elliptic Curve with a predefined curve.
-      @param curve_name A NIST Recommended curve. Currently, this is limited to 
-      curve P-256.
+      @param curve_name A predefined curve: P-256, edwards25519 or secp256k1.
+      @param backend The field arithmetic to use for point operations. 
+      Defaults to the generic mpz_t backend, which supports any curve.
+      @param generator_table_bytes The memory budget for precomputed 
+      multiples of the generator, used by fixedBaseMultiplication(). Zero 
+      disables precomputation.
+      @throw std::invalid_argument if backend does not support curve_name.
    */
-  EllipticCurve(Curves curve_name);
+  EllipticCurve(Curves             curve_name, 
+                ArithmeticBackends backend = ArithmeticBackends::MPZ,
+                std::size_t        generator_table_bytes = 0u);
 
   /// @brief The descructor clears memory allocated by mpz_init().
   ~EllipticCurve();
   
   /** Structure defining a Point on an Elliptic Curve. A point has an x and y   
-      coordinate, or may be at the point of infinity.
+      coordinate, or may be at the point of infinity. The coordinates' limbs 
+      are stored inside the Point, with room for MAX_FIELD_SIZE_BYTES, so 
+      points are created, copied and moved without touching the heap. x and y
+      may be read like any mpz_t, but must only be written with values of at 
+      most MAX_LIMBS limbs - a larger value would make GMP try to reallocate 
+      the inline storage.
   */
   struct Point
   {
+    /// @brief The capacity of each coordinate, in limbs.
+    static const unsigned int MAX_LIMBS = 
+      ( 8u * MAX_FIELD_SIZE_BYTES + GMP_NUMB_BITS - 1u ) / GMP_NUMB_BITS;
+
     Point()
-      : x(), y(), at_infinity(true)
+      : x(), y(), at_infinity(true), x_limbs(), y_limbs()
     {
-      mpz_init(x);
-      mpz_init(y);
+      initCoordinates();
     }
     Point(unsigned int x_in, unsigned int y_in)
-      : x(), y(), at_infinity(false)
+      : x(), y(), at_infinity(false), x_limbs(), y_limbs()
     {
-      mpz_init_set_ui(x, x_in);
-      mpz_init_set_ui(y, y_in);
+      initCoordinates();
+      mpz_set_ui(x, x_in);
+      mpz_set_ui(y, y_in);
     }
+
+    /// @throw std::invalid_argument if a coordinate exceeds MAX_LIMBS limbs.
     Point(const std::string& x_in, const std::string& y_in, Base base)
-    : x(), y(), at_infinity(false)
+      : x(), y(), at_infinity(false), x_limbs(), y_limbs()
     {
-      mpz_init_set_str(x, x_in.c_str(), base);
-      mpz_init_set_str(y, y_in.c_str(), base);
+      initCoordinates();
+
+      /// Parse into heap integers first, as mpz_set_str() may over-allocate.
+      mpz_t x_parsed;
+      mpz_t y_parsed;
+      mpz_init_set_str(x_parsed, x_in.c_str(), base);
+      mpz_init_set_str(y_parsed, y_in.c_str(), base);
+
+      const bool fits = mpz_size(x_parsed) <= MAX_LIMBS && 
+                        mpz_size(y_parsed) <= MAX_LIMBS;
+      if ( fits )
+      {
+        mpz_set(x, x_parsed);
+        mpz_set(y, y_parsed);
+      }
+      mpz_clears(x_parsed, y_parsed, nullptr);
+
+      if ( !fits )
+      {
+        throw std::invalid_argument("Point coordinate is too large.");
+      }
     }
+
+    /// @throw std::invalid_argument if a coordinate exceeds MAX_LIMBS limbs.
     Point(const mpz_t& x_in, const mpz_t& y_in)
-      : x(), y(), at_infinity(false)
+      : x(), y(), at_infinity(false), x_limbs(), y_limbs()
     {
-      mpz_init_set(x, x_in);
-      mpz_init_set(y, y_in);
+      if ( mpz_size(x_in) > MAX_LIMBS || mpz_size(y_in) > MAX_LIMBS )
+      {
+        throw std::invalid_argument("Point coordinate is too large.");
+      }
+
+      initCoordinates();
+      mpz_set(x, x_in);
+      mpz_set(y, y_in);
     }
 
+    /// @brief The coordinates live inside the Point, so nothing is freed.
     ~Point()
     {
-      mpz_clear(x);
-      mpz_clear(y);
     }
 
     Point(const Point& other)
+      : x(), y(), at_infinity(other.at_infinity), x_limbs(), y_limbs()
+    {
+      initCoordinates();
+      mpz_set(x, other.x);
+      mpz_set(y, other.y);
+    }
+
+    /** There is no heap storage to take over, so a move copies the limbs. It
+        is still cheaper than the copy of a heap-backed mpz_t.
+    */
+    Point(Point&& other) noexcept
+      : x(), y(), at_infinity(other.at_infinity), x_limbs(), y_limbs()
     {
-      mpz_init_set(x, other.x);
-      mpz_init_set(y, other.y);
-      at_infinity = other.at_infinity;
+      initCoordinates();
+      mpz_set(x, other.x);
+      mpz_set(y, other.y);
     }
   
     Point& operator=(const Point& other)
@@ -115,6 +181,11 @@ public:
       return *this;
     }
 
+    Point& operator=(Point&& other) noexcept
+    {
+      return *this = static_cast<const Point&>(other);
+    }
+
     bool operator!=(const Point& object) const
     {
       return !(*this == object);
@@ -150,11 +221,69 @@ public:
       return result.str();
     }
 
+    /** SEC1 compressed encoding: 02 || X if y is even, 03 || X if y is odd.
+        Half the size of the uncompressed encoding, at the cost of a square 
+        root to decode, see EllipticCurve::decodePoint().
+    */
+    std::string getCompressedFormat(unsigned int field_size_bytes, 
+                                    bool         preface_hex = true) const
+    {
+      std::stringstream result;
+      std::string       x_padded = padMpz(x, field_size_bytes * 2, Base::HEX);
+
+      result << ( preface_hex ? "0x" : "" ) << ( mpz_odd_p(y) ? "03" : "02" ) 
+             << x_padded;
+      return result.str();
+    }
+
     friend std::ostream& operator<<(std::ostream& os, const Point& point);
 
     mpz_t x;
     mpz_t y;
     bool  at_infinity;
+
+  private:
+
+    /** Point x and y at the inline limbs. Every write through GMP stays 
+        within them, so GMP never reallocates or frees them.
+    */
+    void initCoordinates()
+    {
+      x->_mp_alloc = MAX_LIMBS;
+      x->_mp_size  = 0;
+      x->_mp_d     = x_limbs;
+      y->_mp_alloc = MAX_LIMBS;
+      y->_mp_size  = 0;
+      y->_mp_d     = y_limbs;
+    }
+
+    /// @brief The storage for the limbs of x and y.
+    mp_limb_t x_limbs[MAX_LIMBS];
+    mp_limb_t y_limbs[MAX_LIMBS];
+  };
+
+  /** Structure defining a single term, scalar * point, of a multi-scalar
+      multiplication. The scalar and point are referenced, not copied, and 
+      must outlive the multiplication. If the point has a precomputed table,
+      it may be supplied to take the fixed-base path.
+  */
+  struct MultiplicationTerm
+  {
+    MultiplicationTerm(mpz_srcptr            scalar_in, 
+                       const Point&          point_in,
+                       const FixedBaseTable* table_in = nullptr)
+      : scalar(scalar_in), point(&point_in), table(table_in)
+    {
+    }
+
+    /// @brief The scalar to multiply point by. May be negative.
+    mpz_srcptr            scalar;
+
+    /// @brief The point on the curve to be multiplied.
+    const Point*          point;
+
+    /// @brief The point's precomputed table, or nullptr.
+    const FixedBaseTable* table;
   };
   
   /** Accessor for the name of this curve.
@@ -200,6 +329,12 @@ public:
    */
   const mpz_t& getCofactor() const;
 
+  /** Test if this curve's cofactor is 1, in which case multiplying by h can 
+      be skipped. Taken from CurveTraits for the named curves.
+      @return True if h == 1.
+   */
+  bool hasUnitCofactor() const;
+
   /** Operate on two points on this curve. If P == Q, point doubling is 
       performed. Otherwise, point addition is performed. 
       @param P The first point on this curve.
@@ -210,20 +345,134 @@ public:
    */
   Point operate(const Point& P, const Point& Q) const;
 
-  /** Performs the Double-and-Add Algorithm to perform Point Multiplication.
+  /** Operate on two points on this curve with complete addition formulas. 
+      Every pair of points, including the point at infinity, P == Q and 
+      P == -Q, takes the same sequence of field operations, so the result is
+      computed without branching on the inputs.
+      @param P The first point on this curve.
+      @param Q The second point on this curve.
+      @return P + Q.
+      @throw std::runtime_error if the curve is in short Weierstrass form and
+      its cofactor is not 1, as the formulas require a prime order curve.
+   */
+  Point completeOperate(const Point& P, const Point& Q) const;
+
+  /** Performs Point Multiplication using the width-w NAF of the scalar, where
+      w is the window width (see setWindowBits()).
       This is analogous to T = dP, where d is a scalar and P is a point.
       @param scalar The scalar to multiply P by.
       @param point  The point on the curve to be multiplied.
    */
   Point scalarMultiplication(unsigned int scalar, const Point& point) const;
   
-  /** Performs the Double-and-Add Algorithm to perform Point Multiplication.
+  /** Performs Point Multiplication using the width-w NAF of the scalar, where
+      w is the window width (see setWindowBits()). A small table of odd 
+      multiples of P is built per call, and negative digits use the negated 
+      table entries.
       This is analogous to T = dP, where d is a scalar and P is a point.
       @param scalar The scalar to multiply P by.
       @param point  The point on the curve to be multiplied.
+      @throw std::invalid_argument if the backend is ED25519 and point has 
+      small order, other than the point at infinity. See clearCofactor().
   */
   Point scalarMultiplication(const mpz_t& scalar, const Point& point) const;
 
+  /** Performs Point Multiplication in constant time, for secret scalars. The
+      sequence of operations and memory accesses depends only on the length 
+      of the prime modulus, never on the bits of the scalar. This is about 
+      as fast as scalarMultiplication(), but only the MPN and P256 
+      arithmetic backends avoid secret-dependent timing inside field 
+      operations.
+      This is analogous to T = dP, where d is a scalar and P is a point.
+      @param scalar The secret scalar to multiply P by.
+      @param point  The public point on the curve to be multiplied.
+      @throw std::invalid_argument as for scalarMultiplication().
+  */
+  Point constantTimeScalarMultiplication(const mpz_t& scalar, 
+                                         const Point& point) const;
+
+  /** Multiply a point by this curve's cofactor, h, which maps any point on 
+      the curve into the subgroup of order n. Unlike scalarMultiplication(),
+      which the edwards25519 backend refuses for points of small order, this
+      accepts every point on the curve, e.g. a peer's public key with a small
+      order component. Returns the point unchanged if h == 1.
+      @param point The public point on the curve to clear.
+      @return h * point.
+  */
+  Point clearCofactor(const Point& point) const;
+
+  /** Set the window width used by scalarMultiplication() and by the terms of
+      multiScalarMultiplication() without a precomputed table. Wider windows 
+      trade a larger per-call table (2^(w-2) points) for fewer additions. 
+      Defaults to DEFAULT_WINDOW_BITS.
+      @param window_bits The window width, in [1, MAX_WINDOW_BITS]. A width 
+      of 1 selects plain binary double-and-add.
+      @throw std::invalid_argument if window_bits is out of range.
+  */
+  void setWindowBits(unsigned int window_bits);
+
+  /** Multiply the generator by a scalar using the precomputed comb table of 
+      the generator. This is analogous to T = dG, and is several times faster 
+      than scalarMultiplication(). Falls back to scalarMultiplication() if no
+      table was built.
+      @param scalar The scalar to multiply the generator by.
+      @return scalar * G.
+  */
+  Point fixedBaseMultiplication(const mpz_t& scalar) const;
+
+  /** Precompute multiples of a fixed point on this curve, for use with 
+      fixedBaseMultiplication().
+      @param base A point on this curve of order n.
+      @param max_bytes The maximum size of the table, in bytes.
+      @return A new table owned by the caller, or nullptr if base is at 
+      infinity or max_bytes is too small.
+  */
+  FixedBaseTable* createFixedBaseTable(const Point& base, 
+                                       std::size_t  max_bytes) const;
+
+  /** Multiply a fixed point by a scalar using its precomputed table.
+      @param scalar The scalar to multiply the point by.
+      @param table The point's table, created by this curve's 
+      createFixedBaseTable().
+      @return scalar * base.
+  */
+  Point fixedBaseMultiplication(const mpz_t&          scalar, 
+                                const FixedBaseTable& table) const;
+
+  /** Compute the sum of several scalar multiplications, 
+      k_1 * P_1 + k_2 * P_2 + ... + k_m * P_m, using interleaved wNAF 
+      (Straus' method) so that every term shares a single chain of doublings.
+      Terms with a precomputed table contribute their comb columns during the
+      last doublings of the chain.
+      @param terms The (scalar, point) pairs to sum.
+      @return The sum of scalar * point over every term.
+      @throw std::invalid_argument as for scalarMultiplication().
+  */
+  Point 
+  multiScalarMultiplication(const std::vector<MultiplicationTerm>& terms) const;
+
+  /** Compute several independent multi-scalar multiplications at once. Each
+      sum stays in projective coordinates until the end, when all of them are
+      converted to affine coordinates with a single field inversion 
+      (Montgomery's trick) instead of one inversion each. The results are 
+      identical to calling multiScalarMultiplication() on each entry.
+      @param batch The terms of each multi-scalar multiplication.
+      @return The result of each multi-scalar multiplication, in order.
+  */
+  std::vector<Point> batchMultiScalarMultiplication(
+    const std::vector<std::vector<MultiplicationTerm>>& batch) const;
+
+  /** Accessor for the precomputed generator table.
+      @return Pointer to the generator table, or nullptr if there is no table.
+  */
+  const FixedBaseTable* getGeneratorTable() const;
+
+  /** Accessor for the memory held by the precomputed generator table.
+      @return The size of the generator table in bytes, or zero if there is 
+      no table.
+  */
+  std::size_t getGeneratorTableBytes() const;
+
   /** Find the negative of the given point, P. The negative of a point, -P, is
       defined as -P = (x, -y), where the point is reflected across the X axis.
       The inverse of infinity is itself.
@@ -232,6 +481,61 @@ public:
    */
   Point negatePoint(const EllipticCurve::Point& P) const;
 
+  /** Recover a point from its x coordinate and the parity of its y 
+      coordinate, as carried by the SEC1 compressed encoding. Needs a square 
+      root modulo p, so p must be 3 mod 4, as it is for P-256. On twisted 
+      Edwards curves x and y swap roles, as in the RFC 8032 encoding.
+      @param x The x coordinate of the point.
+      @param y_is_odd True to select the point with the odd y coordinate.
+      @return The point (x, y).
+      @throw std::invalid_argument if x is not in [0, p), if no point on this
+      curve has the x coordinate x, or if p is not 3 mod 4.
+   */
+  Point decompressPoint(const mpz_t& x, bool y_is_odd) const;
+
+  /** Decode a point from its SEC1 encoding in hex, with an optional "0x" 
+      prefix. Both the uncompressed form, 04 || X || Y, and the compressed 
+      form, 02 || X or 03 || X, are accepted. Coordinates are padded to the 
+      field size. Points on twisted Edwards curves are instead decoded from 
+      their RFC 8032 encoding, see encodePoint().
+      @param encoded The encoded point.
+      @return The decoded point.
+      @throw std::invalid_argument if encoded is malformed, if a coordinate 
+      is not in [0, p), or if the point is not on this curve.
+   */
+  Point decodePoint(const std::string& encoded) const;
+
+  /** Encode a point in this curve's standard form, in hex. Short Weierstrass 
+      curves use the SEC1 uncompressed form, 04 || X || Y. Twisted Edwards 
+      curves use the RFC 8032 form: y in little-endian, with the parity of x 
+      in the top bit. Both are the forms used in the SPAKE2 transcript.
+      @param P The point to encode.
+      @param preface_hex Add the "0x" prefix to the result.
+      @return The encoded point.
+   */
+  std::string encodePoint(const Point& P, bool preface_hex = true) const;
+
+  /** Encode a point in this curve's standard form, as encodePoint(), into 
+      raw bytes.
+      @param P The point to encode.
+      @param bytes The buffer to write to, of at least MAX_ENCODED_POINT_BYTES.
+      @return The number of bytes written.
+   */
+  std::size_t encodePointBytes(const Point& P, unsigned char* bytes) const;
+
+  /** Accessor for the length of encodePoint(P) in bytes, as written into the
+      SPAKE2 transcript. For short Weierstrass curves this counts the 
+      coordinates without leading zero bytes, as the P-256 test vectors do.
+      @param P The point to encode.
+      @return The number of bytes in the encoding of P.
+   */
+  std::size_t getEncodedByteCount(const Point& P) const;
+
+  /** Accessor for the form of this curve's equation.
+      @return The form this curve's a and b parameters belong to.
+   */
+  CurveForms getForm() const;
+
 protected:
 private:
 
@@ -253,32 +557,52 @@ private:
   /// @brief This curves order, or number of points.
   mpz_t n;
 
+  /// @brief True if h == 1.
+  bool cofactor_is_one;
+
+  /// @brief The form of this curve's equation.
+  CurveForms form;
+
   /// @brief This curve's defined generator element.
   Point generator;
 
   /// @brief The field size of this curve, in bytes.
   unsigned int field_size_bytes;
 
-  /** Find the multiplicative inverse of a point on this curve. 
-      @param P The value to find the inverse of.
-      @param result The result to place the inverse of a into, if it exists.
-      @return True if the inverse exists, and result was updated.
+  /// @brief The point arithmetic backend for this curve.
+  std::unique_ptr<CurveArithmetic> arithmetic;
+
+  /// @brief Precomputed multiples of the generator. May be empty.
+  std::unique_ptr<FixedBaseTable>  generator_table;
+
+  /** Look up whether a named curve's cofactor is 1 in its CurveTraits.
+      @param curve_name_in The named curve.
+      @return True if the curve's cofactor is 1.
   */
-  bool getInverse(const mpz_t& P, mpz_t result) const;
+  static bool cofactorIsOne(Curves curve_name_in);
 
-  /** Perform point doubling for two points on this curve.
-      @param P The first point to double.
-      @param Q The second point to double.
-      @return P + Q.
+  /** Check that a short Weierstrass point satisfies y^2 = x^3 + ax + b. The 
+      point formulas never use b, so a point off the curve would silently be
+      multiplied on another curve, of possibly weak order.
+      @param P The point to check, with coordinates in [0, p).
+      @return True if P is on this curve.
   */
-  Point pointDoubling(const Point& P, const Point& Q) const;
+  bool isOnCurve(const Point& P) const;
 
-  /** Perform point doubling for two points on this curve.
-    @param P The first point to double.
-    @param Q The second point to double.
-    @return PQ.
+  /** Decode a point on a twisted Edwards curve from its RFC 8032 encoding.
+      @param encoded The encoded point in hex, without a prefix.
+      @return The decoded point.
+      @throw std::invalid_argument if encoded is malformed, if y is not in 
+      [0, p), or if it is not a point on this curve.
   */
-  Point pointAddition(const Point& P, const Point& Q) const;
+  Point decodeEdwardsPoint(const std::string& encoded) const;
+
+  /** Create the point arithmetic backend for this curve. Should only be 
+      called once the curve parameters have been initialized.
+      @param backend The desired arithmetic backend.
+      @return A newly-allocated arithmetic backend.
+  */
+  CurveArithmetic* createArithmetic(ArithmeticBackends backend) const;
 
   /// Both copy assignment and copy constructors are deleted.
   EllipticCurve operator=(const EllipticCurve& object) = delete;
@@ -322,21 +646,27 @@ inline const mpz_t& EllipticCurve::getCofactor() const
 }
 
 // ============================================================================
-inline const EllipticCurve::Point& EllipticCurve::getGenerator() const
+inline CurveForms EllipticCurve::getForm() const
 {
-  return generator;
+  return form;
 }
 
 // ============================================================================
-inline unsigned int EllipticCurve::getFieldSizeBytes() const
+inline bool EllipticCurve::hasUnitCofactor() const
 {
-  return field_size_bytes;
+  return cofactor_is_one;
 }
 
 // ============================================================================
-inline bool EllipticCurve::getInverse(const mpz_t& P, mpz_t result) const
+inline const EllipticCurve::Point& EllipticCurve::getGenerator() const
 {
-  return mpz_invert(result, P, getPrimeModulus()) != 0;
+  return generator;
+}
+
+// ============================================================================
+inline unsigned int EllipticCurve::getFieldSizeBytes() const
+{
+  return field_size_bytes;
 }
 
 // ============================================================================
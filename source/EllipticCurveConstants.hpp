@@ -20,8 +20,65 @@
 enum class Curves
 {
   P256,
+  EDWARDS25519,
+  SECP256K1,
 };
 
+/// @brief The equation which a curve's a and b parameters belong to.
+enum class CurveForms
+{
+  /// y^2 = x^3 + ax + b
+  SHORT_WEIERSTRASS,
+  /// ax^2 + y^2 = 1 + bx^2y^2, i.e. b holds the Edwards parameter d.
+  TWISTED_EDWARDS,
+};
+
+/// @brief Field arithmetic implementations available to an EllipticCurve.
+enum class ArithmeticBackends
+{
+  /// Generic heap-allocated mpz_t arithmetic. Supports any curve.
+  MPZ,
+  /// Fixed-size mpn_ limbs in Montgomery form. Supports any odd prime.
+  MPN,
+  /** Fixed-width 4x64-bit limbs with Solinas reduction. P-256 only. Batches
+      run eight at a time with AVX-512 IFMA where the CPU supports it.
+  */
+  P256,
+  /** libsodium's edwards25519 group operations. edwards25519 only, and the 
+      only backend which supports it.
+  */
+  ED25519,
+  /** Fixed-size mpn_ limbs in Montgomery form, with each variable-base scalar
+      split in half by the GLV endomorphism. secp256k1 only.
+  */
+  SECP256K1,
+};
+
+/** @brief The largest field element of any supported curve, in bytes. Sets 
+    the inline storage of EllipticCurve::Point, so it must cover every curve 
+    in curve_parameters.
+*/
+constexpr unsigned int MAX_FIELD_SIZE_BYTES = 32u;
+
+/// @brief The longest standard encoding of a point: SEC1 04 || X || Y.
+constexpr unsigned int MAX_ENCODED_POINT_BYTES = 1u + 2u * MAX_FIELD_SIZE_BYTES;
+
+/// @brief The default and largest window widths for variable-base wNAF.
+constexpr unsigned int DEFAULT_WINDOW_BITS = 5u;
+constexpr unsigned int MAX_WINDOW_BITS     = 8u;
+
+/// @brief The fixed window width of constant-time scalar multiplication.
+constexpr unsigned int CONSTANT_TIME_WINDOW_BITS = 4u;
+
+/** @brief The memory budget, in bytes, of each fixed-base table used by the 
+    SPAKE2 ciphersuites - one for each curve's generator, and one each for 
+    the blinding factors M and N. Set at build time with the 
+    FIXED_BASE_TABLE_BYTES CMake cache variable.
+*/
+#ifndef FIXED_BASE_TABLE_BYTES
+#define FIXED_BASE_TABLE_BYTES 65536
+#endif
+
 /// @brief Core parameters defining an Elliptic Curve.
 struct CurveParameters
 {
@@ -46,6 +103,9 @@ struct CurveParameters
   const char * h;
 
   unsigned int field_size_bytes;
+
+  /// @brief The equation a and b belong to.
+  CurveForms   form;
 };
 
 /** @brief NIST-published recommended curve parameters.
@@ -64,9 +124,40 @@ const std::map<Curves, CurveParameters> curve_parameters =
       "-3",                                                                             // a
       "5ac635d8aa3a93e7b3ebbd55769886bc651d06b0cc53b0f63bce3c3e27d2604b",               // b
       "1",                                                                              // h
-      32
+      32,
+      CurveForms::SHORT_WEIERSTRASS
+    }
+  }, // p256
+  /// Source : Section 5.1 of https://www.rfc-editor.org/rfc/rfc8032.html
+  { Curves::EDWARDS25519, 
+    { 
+      "edwards25519",
+      "57896044618658097711785492504343953926634992332820282019728792003956564819949",  // p
+      "7237005577332262213973186563042994240857116359379907606001950938285454250989",   // n
+      "216936d3cd6e53fec0a4e231fdd6dc5c692cc7609525a7b2c9562d608f25d51a",               // gx
+      "6666666666666666666666666666666666666666666666666666666666666658",               // gy
+      "-1",                                                                             // a
+      "52036cee2b6ffe738cc740797779e89800700a4d4141d8ab75eb4dca135978a3",               // d
+      "8",                                                                              // h
+      32,
+      CurveForms::TWISTED_EDWARDS
+    }
+  }, // edwards25519
+  /// Source : Section 2.4.1 of https://www.secg.org/sec2-v2.pdf
+  { Curves::SECP256K1, 
+    { 
+      "secp256k1",
+      "115792089237316195423570985008687907853269984665640564039457584007908834671663", // p
+      "115792089237316195423570985008687907852837564279074904382605163141518161494337", // n
+      "79be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798",               // gx
+      "483ada7726a3c4655da4fbfc0e1108a8fd17b448a68554199c47d08ffb10d4b8",               // gy
+      "0",                                                                              // a
+      "7",                                                                              // b
+      "1",                                                                              // h
+      32,
+      CurveForms::SHORT_WEIERSTRASS
     }
-  } // p256
+  } // secp256k1
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,243 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+
+#include "GmpArena.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+#include <gmp.h>
+
+namespace
+{
+  /// @brief Every allocation is rounded up to keep limbs aligned.
+  const std::size_t ALIGNMENT = 16u;
+
+  /// @brief A block of memory reserved from the system.
+  struct Block
+  {
+    unsigned char* memory;
+    std::size_t    size;
+  };
+
+  /** The arena of a single thread. Blocks are filled in order, and kept when 
+      the arena is reset.
+  */
+  struct ThreadArena
+  {
+    ThreadArena()
+      : blocks(), current(0), offset(0), depth(0)
+    {
+    }
+
+    ~ThreadArena()
+    {
+      for ( const Block& block : blocks )
+      {
+        std::free(block.memory);
+      }
+    }
+
+    /// @brief Test if memory was allocated from this arena.
+    bool owns(const void* memory) const
+    {
+      const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(memory);
+      for ( const Block& block : blocks )
+      {
+        const std::uintptr_t start = 
+          reinterpret_cast<std::uintptr_t>(block.memory);
+        if ( address >= start && address < start + block.size )
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /// @brief Test if memory is the most recent allocation in the arena.
+    bool isLast(const void* memory, std::size_t size) const
+    {
+      return current < blocks.size() && 
+             static_cast<const unsigned char*>(memory) + roundUp(size) == 
+             blocks[current].memory + offset;
+    }
+
+    void* allocate(std::size_t size)
+    {
+      size = roundUp(size);
+
+      for ( ; current < blocks.size(); ++current, offset = 0 )
+      {
+        if ( size <= blocks[current].size - offset )
+        {
+          void* const memory = blocks[current].memory + offset;
+          offset += size;
+          return memory;
+        }
+      }
+
+      Block block;
+      block.size   = std::max(size, GmpArena::BLOCK_BYTES);
+      block.memory = static_cast<unsigned char*>(std::malloc(block.size));
+      if ( block.memory == nullptr )
+      {
+        std::cerr << "GMP arena failed to allocate " << block.size 
+                  << " bytes." << std::endl;
+        std::abort();
+      }
+
+      blocks.push_back(block);
+      offset = size;
+      return block.memory;
+    }
+
+    static std::size_t roundUp(std::size_t size)
+    {
+      return ( size + ALIGNMENT - 1u ) & ~( ALIGNMENT - 1u );
+    }
+
+    std::vector<Block> blocks;
+    std::size_t        current;
+    std::size_t        offset;
+    unsigned int       depth;
+  };
+
+  thread_local ThreadArena thread_arena;
+
+  /// @brief GMP's memory functions from before install().
+  void* (*default_allocate)  (std::size_t)                      = nullptr;
+  void* (*default_reallocate)(void*, std::size_t, std::size_t) = nullptr;
+  void  (*default_deallocate)(void*, std::size_t)              = nullptr;
+
+  std::once_flag    install_flag;
+  std::atomic<bool> installed(false);
+}
+
+const std::size_t GmpArena::BLOCK_BYTES;
+
+// ============================================================================
+void GmpArena::install()
+{
+  std::call_once(install_flag, []()
+  {
+    mp_get_memory_functions(&default_allocate, 
+                            &default_reallocate, 
+                            &default_deallocate);
+    mp_set_memory_functions(&GmpArena::allocate, 
+                            &GmpArena::reallocate, 
+                            &GmpArena::deallocate);
+    installed = true;
+  });
+}
+
+// ============================================================================
+bool GmpArena::isInstalled()
+{
+  return installed;
+}
+
+// ============================================================================
+std::size_t GmpArena::getBytesInUse()
+{
+  const ThreadArena& arena = thread_arena;
+  if ( arena.depth == 0 )
+  {
+    return 0u;
+  }
+
+  std::size_t bytes = arena.offset;
+  for ( std::size_t i = 0; i < arena.current && i < arena.blocks.size(); ++i )
+  {
+    bytes += arena.blocks[i].size;
+  }
+  return bytes;
+}
+
+// ============================================================================
+GmpArena::Scope::Scope()
+{
+  ++thread_arena.depth;
+}
+
+// ============================================================================
+GmpArena::Scope::~Scope()
+{
+  ThreadArena& arena = thread_arena;
+  if ( --arena.depth == 0 )
+  {
+    arena.current = 0;
+    arena.offset  = 0;
+  }
+}
+
+// ============================================================================
+void* GmpArena::allocate(std::size_t size)
+{
+  ThreadArena& arena = thread_arena;
+  if ( arena.depth == 0 )
+  {
+    return default_allocate(size);
+  }
+
+  return arena.allocate(size);
+}
+
+// ============================================================================
+void* GmpArena::reallocate(void* memory, std::size_t old_size, std::size_t size)
+{
+  ThreadArena& arena = thread_arena;
+  if ( !arena.owns(memory) )
+  {
+    return default_reallocate(memory, old_size, size);
+  }
+
+  /// The most recent allocation can usually grow in place.
+  if ( arena.depth != 0 && arena.isLast(memory, old_size) )
+  {
+    const std::size_t start = 
+      static_cast<unsigned char*>(memory) - arena.blocks[arena.current].memory;
+    if ( ThreadArena::roundUp(size) <= arena.blocks[arena.current].size - start )
+    {
+      arena.offset = start + ThreadArena::roundUp(size);
+      return memory;
+    }
+  }
+
+  void* const result = allocate(size);
+  std::memcpy(result, memory, std::min(old_size, size));
+  return result;
+}
+
+// ============================================================================
+void GmpArena::deallocate(void* memory, std::size_t size)
+{
+  ThreadArena& arena = thread_arena;
+  if ( !arena.owns(memory) )
+  {
+    default_deallocate(memory, size);
+    return;
+  }
+
+  /// Short-lived temporaries are freed in reverse order, so reuse their space.
+  if ( arena.depth != 0 && arena.isLast(memory, size) )
+  {
+    arena.offset -= ThreadArena::roundUp(size);
+  }
+}
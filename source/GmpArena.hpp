@@ -0,0 +1,92 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+
+#ifndef GMP_ARENA_HPP
+#define GMP_ARENA_HPP
+
+#include <cstddef>
+
+/** An optional per-thread bump arena for GMP's memory. install() replaces 
+    GMP's memory functions, process wide, with functions that allocate from 
+    the calling thread's arena while a GmpArena::Scope is alive on it, and 
+    fall back to GMP's previous functions otherwise. Inside a scope an 
+    allocation is a pointer increment, frees do nothing (beyond rolling back
+    the most recent allocation), and when the outermost scope ends the arena
+    is reset in O(1). The arena's blocks are kept for the thread's next scope,
+    so a thread that runs one handshake after another stops calling malloc 
+    altogether, and threads never contend for a lock.
+
+    GMP memory allocated inside a scope must not outlive it, nor be handed to
+    another thread. As GMP may give an integer freshly allocated limbs on any
+    write, an integer which outlives a scope should not be written inside it.
+    Reallocations of heap memory do stay on the heap. Without install(), GMP
+    keeps its default allocator and scopes have no effect.
+*/
+class GmpArena
+{
+public:
+
+  /// @brief The size of each block reserved from the system, in bytes.
+  static const std::size_t BLOCK_BYTES = 65536u;
+
+  /** Replace GMP's memory functions with the arena's. Safe to call more than
+      once, but should be called before starting any threads which use GMP.
+  */
+  static void install();
+
+  /** Test if install() has been called.
+      @return True if GMP allocates through the arena's functions.
+  */
+  static bool isInstalled();
+
+  /** Accessor for the arena memory used by the calling thread's current 
+      scope.
+      @return The number of bytes allocated since the outermost scope began.
+  */
+  static std::size_t getBytesInUse();
+
+  /** Routes the calling thread's GMP allocations to its arena for the 
+      lifetime of the object. Scopes may be nested, and only the outermost 
+      one resets the arena.
+  */
+  class Scope
+  {
+  public:
+
+    /// @brief Start allocating from the calling thread's arena.
+    Scope();
+
+    /// @brief Reset the arena if this is the outermost scope.
+    ~Scope();
+
+  private:
+
+    /// Both copy assignment and copy constructors are deleted.
+    Scope operator=(const Scope& object) = delete;
+    Scope          (const Scope& object) = delete;
+  };
+
+private:
+
+  /// @brief GMP's memory functions, installed in place of the defaults.
+  static void* allocate  (std::size_t size);
+  static void* reallocate(void* memory, std::size_t old_size, std::size_t size);
+  static void  deallocate(void* memory, std::size_t size);
+
+  /// Both copy assignment and copy constructors are deleted.
+  GmpArena operator=(const GmpArena& object) = delete;
+  GmpArena          (const GmpArena& object) = delete;
+};
+
+#endif
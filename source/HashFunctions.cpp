@@ -14,23 +14,52 @@
 #include "HashFunctions.hpp"
 
 #include <sstream>
+#include <stdexcept>
 #include <string>
 
+#include "OpenSslContexts.hpp"
 #include "StringHelpers.hpp"
 
 #include <openssl/sha.h>
 
 /** Perform the SHA-256 hash of the input.
-    @param input The input to take the SHA-256 hash of.
-    @return The SHA-256 hash of input.
+    @param data The input to take the SHA-256 hash of.
+    @param length The length of data, in bytes.
+    @param digest Set to the SHA-256 hash of data.
+    @return The length of the hash, SHA256_DIGEST_LENGTH.
     @cite https://docs.openssl.org/3.1/man3/SHA256_Init/
  */
+HashBytesFunction SHA_256_BYTES = [](const unsigned char* data,
+                                     std::size_t          length,
+                                     unsigned char*       digest) -> std::size_t
+{
+  SHA256(data, length, digest);
+
+  return SHA256_DIGEST_LENGTH;
+};
+
+/** Perform the SHA-256 hash of the input.
+    @param input The input to take the SHA-256 hash of, in hex.
+    @return The SHA-256 hash of input.
+ */
 HashFunction SHA_256 = [](const std::string& input) -> std::string
 {
-  unsigned char              hash[SHA256_DIGEST_LENGTH];
+  unsigned char              hash[MAX_DIGEST_BYTES];
   std::vector<unsigned char> bytes = hexStringToBytes(input);
   
-  SHA256(bytes.data(), bytes.size(), hash);
+  const std::size_t length = SHA_256_BYTES(bytes.data(), bytes.size(), hash);
   
-  return binaryToHexString(hash, SHA256_DIGEST_LENGTH, true);
-};
\ No newline at end of file
+  return binaryToHexString(hash, length, true);
+};
+
+// ============================================================================
+const EVP_MD* getMessageDigest(HashFunctions hash_function)
+{
+  switch ( hash_function )
+  {
+    case HashFunctions::SHA256:
+      return OpenSslContexts::getSha256();
+    default:
+      throw std::invalid_argument("Unknown hash function.");
+  }
+}
@@ -14,18 +14,39 @@
 #ifndef HASH_FUNCTIONS_HPP
 #define HASH_FUNCTIONS_HPP
 
+#include <cstddef>
 #include <functional>
 #include <map>
 #include <string>
 
+#include <openssl/evp.h>
+
 enum class HashFunctions
 {
   SHA256,
 };
 
+/// @brief The largest digest of any hash function, in bytes.
+constexpr std::size_t MAX_DIGEST_BYTES = EVP_MAX_MD_SIZE;
+
 using HashFunction = std::function<std::string(const std::string&)>;
 
-extern HashFunction SHA_256;
+/** A hash function over raw bytes, which writes the digest into a buffer 
+    provided by the caller, and does not allocate.
+    @param data - The message to hash.
+    @param length - The length of data, in bytes.
+    @param digest - Set to the digest. Must hold MAX_DIGEST_BYTES.
+    @return The length of the digest, in bytes.
+*/
+using HashBytesFunction = std::function<std::size_t(const unsigned char*, 
+                                                    std::size_t, 
+                                                    unsigned char*)>;
+
+/// @brief SHA-256 over hex strings, with the "0x" prefix on its output.
+extern HashFunction      SHA_256;
+
+/// @brief SHA-256 over raw bytes.
+extern HashBytesFunction SHA_256_BYTES;
 
 /// @brief Map to store available hash functions. Currently limited to SHA-256
 const std::map<HashFunctions, HashFunction> hash_functions
@@ -33,4 +54,18 @@ const std::map<HashFunctions, HashFunction> hash_functions
   { HashFunctions::SHA256, SHA_256 }
 };
 
+/// @brief The byte-oriented forms of hash_functions.
+const std::map<HashFunctions, HashBytesFunction> hash_bytes_functions
+{
+  { HashFunctions::SHA256, SHA_256_BYTES }
+};
+
+/** Accessor for the OpenSSL digest behind a hash function, for hashing a 
+    message incrementally as it is built.
+    @param hash_function The hash function.
+    @return The OpenSSL message digest.
+    @throw std::invalid_argument If hash_function is unknown.
+*/
+const EVP_MD* getMessageDigest(HashFunctions hash_function);
+
 #endif
\ No newline at end of file
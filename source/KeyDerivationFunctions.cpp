@@ -13,11 +13,44 @@
 
 #include "KeyDerivationFunctions.hpp"
 
-#include <vector>
-
+#include "OpenSslContexts.hpp"
 #include "StringHelpers.hpp"
-#include <openssl/evp.h>
-#include <openssl/kdf.h>
+
+/** The HKDF of RFC5869 with SHA-256, an empty salt, and info || aad as 
+    its info. Derives with the calling thread's HKDF context, rather than 
+    creating one per call.
+    @param key - The data to derive a key from.
+    @param key_length - The length of key, in bytes.
+    @param info - Additional bytes to pass into the Key Derivation Function.
+    In the context of SPAKE2, this value is hard-coded to "ConfirmationKeys".
+    @param info_length - The length of info, in bytes.
+    @param aad  - Additional associated data which may be shared by each 
+    endpoint. If it is shared, it must be identical between both parties.
+    @param aad_length - The length of aad, in bytes.
+    @param output - Set to the derived key.
+    @param output_length - The number of bytes to derive into output.
+    @throw std::runtime_error If OpenSSL fails to derive the key.
+    @cite https://docs.openssl.org/3.2/man7/EVP_KDF-HKDF/
+*/
+KeyDerivationBytesFunction
+HKDF_RFC5869_BYTES = [](const unsigned char* key, 
+                        std::size_t          key_length,
+                        const unsigned char* info, 
+                        std::size_t          info_length,
+                        const unsigned char* aad,
+                        std::size_t          aad_length,
+                        unsigned char*       output,
+                        std::size_t          output_length)
+{
+  OpenSslContexts::hkdfSha256(key, 
+                              key_length,
+                              info, 
+                              info_length,
+                              aad, 
+                              aad_length,
+                              output,
+                              output_length);
+};
 
 /** A Key Derivation function which takes the following parameters.
     @param data - The data to derive a key from.
@@ -25,53 +58,24 @@
     In the context of SPAKE2, this value is hard-coded to "ConfirmationKeys".
     @param aad  - Additional associated data which may be shared by each 
     endpoint. If it is shared, it must be identical between both parties.
-    @return The KDF of data, with additional info with aad appended.
-    @cite https://docs.openssl.org/3.2/man3/EVP_PKEY_CTX_new/
+    @return The KDF of data, with additional info with aad appended, in hex.
 */
 KeyDerivationFunction
 HKDF_RFC5869 = [](const std::string& data, 
-                  const std::string& info_in, 
+                  const std::string& info, 
                   const std::string& aad) -> std::string
 {
   constexpr std::size_t output_len = 32;
-  std::vector<unsigned char> out_key(output_len);
-
-  std::string info = info_in;
-  info.append(aad);
-
-  EVP_PKEY_CTX* pctx = EVP_PKEY_CTX_new_id(EVP_PKEY_HKDF, nullptr);
-
-  if ( pctx == nullptr )
-  {
-    throw std::runtime_error("EVP_PKEY_CTX_new_id failed.");
-  }
-
-  if (EVP_PKEY_derive_init(pctx)                    <= 0 ||
-      EVP_PKEY_CTX_set_hkdf_md(pctx, EVP_sha256())  <= 0 ||
-      EVP_PKEY_CTX_set1_hkdf_salt(pctx, nullptr, 0) <= 0 ||
-      EVP_PKEY_CTX_set1_hkdf_key(pctx, 
-        reinterpret_cast<const unsigned char*>(
-          data.data()), data.size()) <= 0                ||
-      EVP_PKEY_CTX_add1_hkdf_info(pctx, 
-        reinterpret_cast<const unsigned char*>(
-          info.data()), info.size()) <= 0)
-  {
-    EVP_PKEY_CTX_free(pctx);
-    throw std::runtime_error("HKDF parameter setup failed.");
-  }
-
-  std::size_t len = output_len;
-  if ( EVP_PKEY_derive(pctx, out_key.data(), &len) <= 0 )
-  {
-    EVP_PKEY_CTX_free(pctx);
-    throw std::runtime_error("HKDF derivation failed.");
-  }
+  unsigned char         out_key[output_len];
 
-  EVP_PKEY_CTX_free(pctx);
-  if ( len != output_len ) 
-  {
-    throw std::runtime_error("Incorrect output length.");
-  }
+  HKDF_RFC5869_BYTES(reinterpret_cast<const unsigned char*>(data.data()), 
+                     data.size(), 
+                     reinterpret_cast<const unsigned char*>(info.data()), 
+                     info.size(),
+                     reinterpret_cast<const unsigned char*>(aad.data()), 
+                     aad.size(),
+                     out_key, 
+                     output_len);
    
-  return binaryToHexString(out_key.data(), out_key.size());
-};
\ No newline at end of file
+  return binaryToHexString(out_key, output_len);
+};
@@ -14,6 +14,7 @@
 #ifndef KEY_DERIVATION_FUNCTIONS_HPP
 #define KEY_DERIVATION_FUNCTIONS_HPP
 
+#include <cstddef>
 #include <functional>
 #include <map>
 #include <string>
@@ -34,8 +35,33 @@ using KeyDerivationFunction = std::function<std::string(const std::string&,
                                                         const std::string&, 
                                                         const std::string&)>;
 
-/// @brief The HKDF as specified by RFC5869.
-extern KeyDerivationFunction HKDF_RFC5869;
+/** A Key Derivation function over raw bytes, which writes the derived key 
+    into a buffer provided by the caller. info and aad are passed to the KDF 
+    as the concatenation info || aad, without copying either.
+    @param key - The data to derive a key from.
+    @param key_length - The length of key, in bytes.
+    @param info - Additional bytes to pass into the Key Derivation Function.
+    @param info_length - The length of info, in bytes.
+    @param aad  - Additional associated data which may be shared by each 
+    endpoint.
+    @param aad_length - The length of aad, in bytes.
+    @param output - Set to the derived key.
+    @param output_length - The number of bytes to derive into output.
+*/
+using KeyDerivationBytesFunction = std::function<void(const unsigned char*, 
+                                                      std::size_t, 
+                                                      const unsigned char*, 
+                                                      std::size_t, 
+                                                      const unsigned char*, 
+                                                      std::size_t, 
+                                                      unsigned char*, 
+                                                      std::size_t)>;
+
+/// @brief The HKDF as specified by RFC5869, over hex strings.
+extern KeyDerivationFunction      HKDF_RFC5869;
+
+/// @brief The HKDF as specified by RFC5869, over raw bytes.
+extern KeyDerivationBytesFunction HKDF_RFC5869_BYTES;
 
 /// @brief Map of available Key Derivation Functions
 const std::map<KeyDerivationFunctions, KeyDerivationFunction> key_derivation_functions = 
@@ -43,4 +69,11 @@ const std::map<KeyDerivationFunctions, KeyDerivationFunction> key_derivation_fun
   { KeyDerivationFunctions::HKDF, HKDF_RFC5869 }
 };
 
+/// @brief The byte-oriented forms of key_derivation_functions.
+const std::map<KeyDerivationFunctions, KeyDerivationBytesFunction> 
+key_derivation_bytes_functions = 
+{
+  { KeyDerivationFunctions::HKDF, HKDF_RFC5869_BYTES }
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,289 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+
+#include "KeySharePool.hpp"
+
+#include <stdexcept>
+
+#include "SecureRandom.hpp"
+#include "Spake2CipherSuite.hpp"
+#include "sodium.h"
+
+namespace
+{
+  /// @brief The number of values of Curves.
+  const std::size_t NUM_CURVES = 3u;
+
+  /// @brief The pool installed for each curve, if any.
+  std::atomic<KeySharePool*> installed_pools[NUM_CURVES];
+
+  /** @brief The number of takeInstalled() calls using each curve's pool. It 
+      lives outside of the pools, so it can be raised before a pool is loaded.
+  */
+  std::atomic<unsigned int> takes_in_flight[NUM_CURVES];
+
+  std::size_t getCurveIndex(Curves curve)
+  {
+    const std::size_t index = static_cast<std::size_t>(curve);
+    if ( index >= NUM_CURVES )
+    {
+      throw std::invalid_argument("Unsupported curve for a key share pool.");
+    }
+    return index;
+  }
+
+  std::atomic<KeySharePool*>& getInstalledPool(Curves curve)
+  {
+    return installed_pools[getCurveIndex(curve)];
+  }
+}
+
+// ============================================================================
+KeySharePool::KeyShare::KeyShare()
+  : point()
+{
+  mpz_init(scalar);
+}
+
+// ============================================================================
+KeySharePool::KeyShare::~KeyShare()
+{
+  /// An untaken scalar is still secret, so wipe every allocated limb.
+  const mp_size_t allocated = scalar->_mp_alloc;
+  sodium_memzero(mpz_limbs_modify(scalar, allocated), 
+                 allocated * sizeof(mp_limb_t));
+  mpz_clear(scalar);
+}
+
+// ============================================================================
+KeySharePool::KeySharePool(Curves curve, const Config& config)
+  : curve        (curve),
+    shared_curve (Spake2CipherSuite::getSharedCurve(curve)),
+    config       (config),
+    shares       (),
+    refilling    (true),
+    stopping     (false),
+    mutex        (),
+    refill_needed(),
+    filled       (),
+    hits         (0u),
+    misses       (0u),
+    generated    (0u),
+    threads      ()
+{
+  if ( config.depth == 0u || config.threads == 0u )
+  {
+    throw std::invalid_argument(
+      "A key share pool needs a non-zero depth and at least one thread.");
+  }
+  if ( config.low_watermark  >= config.high_watermark || 
+       config.high_watermark >  config.depth )
+  {
+    throw std::invalid_argument(
+      "The watermarks of a key share pool must satisfy low < high <= depth.");
+  }
+
+  /** The destructor does not run if the constructor throws, so threads 
+      which have already started must be stopped here. Otherwise they would 
+      be destroyed while still joinable, which calls std::terminate().
+  */
+  threads.reserve(config.threads);
+  try
+  {
+    for ( unsigned int i = 0; i < config.threads; ++i )
+    {
+      threads.emplace_back(&KeySharePool::fill, this);
+    }
+  }
+  catch ( ... )
+  {
+    stopThreads();
+    throw;
+  }
+}
+
+// ============================================================================
+KeySharePool::~KeySharePool()
+{
+  KeySharePool* expected = this;
+  getInstalledPool(curve).compare_exchange_strong(expected, nullptr);
+
+  /** A takeInstalled() may have loaded this pool just before it was 
+      uninstalled, or replaced by install(). Takes raise the count before 
+      loading the pool, so once it reaches zero no take can still hold it.
+  */
+  const std::atomic<unsigned int>& in_flight = 
+    takes_in_flight[getCurveIndex(curve)];
+  while ( in_flight != 0u )
+  {
+    std::this_thread::yield();
+  }
+
+  stopThreads();
+}
+
+// ============================================================================
+void KeySharePool::stopThreads()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  refill_needed.notify_all();
+
+  for ( std::thread& thread : threads )
+  {
+    thread.join();
+  }
+}
+
+// ============================================================================
+bool KeySharePool::take(mpz_t& scalar, EllipticCurve::Point& share)
+{
+  std::unique_ptr<KeyShare> taken;
+  bool                      wake = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if ( !shares.empty() )
+    {
+      taken = std::move(shares.front());
+      shares.pop_front();
+    }
+
+    if ( !refilling && shares.size() <= config.low_watermark )
+    {
+      refilling = true;
+      wake      = true;
+    }
+  }
+
+  if ( wake )
+  {
+    refill_needed.notify_all();
+  }
+
+  if ( !taken )
+  {
+    ++misses;
+    return false;
+  }
+
+  ++hits;
+
+  /// Swapping hands over the limbs without copying, or allocating.
+  mpz_swap(scalar, taken->scalar);
+  share = taken->point;
+  return true;
+}
+
+// ============================================================================
+void KeySharePool::waitUntilFilled()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  if ( !refilling && shares.size() < config.high_watermark )
+  {
+    refilling = true;
+    refill_needed.notify_all();
+  }
+
+  filled.wait(lock, [this]()
+  {
+    return shares.size() >= config.high_watermark;
+  });
+}
+
+// ============================================================================
+KeySharePool::Statistics KeySharePool::getStatistics() const
+{
+  Statistics statistics;
+  statistics.hits      = hits;
+  statistics.misses    = misses;
+  statistics.generated = generated;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  statistics.available = shares.size();
+  return statistics;
+}
+
+// ============================================================================
+void KeySharePool::install(KeySharePool& pool)
+{
+  getInstalledPool(pool.curve) = &pool;
+}
+
+// ============================================================================
+void KeySharePool::uninstall(Curves curve)
+{
+  getInstalledPool(curve) = nullptr;
+}
+
+// ============================================================================
+bool KeySharePool::takeInstalled(Curves                curve, 
+                                 mpz_t&                scalar, 
+                                 EllipticCurve::Point& share)
+{
+  std::atomic<KeySharePool*>& installed = getInstalledPool(curve);
+  std::atomic<unsigned int>&  in_flight = takes_in_flight[getCurveIndex(curve)];
+
+  /// Without a pool, skip the count, so the common case stays a single load.
+  if ( installed.load() == nullptr )
+  {
+    return false;
+  }
+
+  ++in_flight;
+  KeySharePool* const pool  = installed;
+  const bool          taken = pool != nullptr && pool->take(scalar, share);
+  --in_flight;
+  return taken;
+}
+
+// ============================================================================
+void KeySharePool::fill()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  while ( true )
+  {
+    refill_needed.wait(lock, [this]() { return stopping || refilling; });
+    if ( stopping )
+    {
+      return;
+    }
+
+    /// Shares are generated without the lock, so sessions may take others.
+    lock.unlock();
+    std::unique_ptr<KeyShare> share(new KeyShare());
+    SecureRandom::uniformScalar(share->scalar, shared_curve.getOrder());
+#ifdef CONSTANT_TIME_SCALAR_MULTIPLICATION
+    share->point = shared_curve.constantTimeScalarMultiplication(
+      share->scalar, shared_curve.getGenerator());
+#else
+    share->point = shared_curve.fixedBaseMultiplication(share->scalar);
+#endif
+    lock.lock();
+
+    /// With several threads, the last few shares may overshoot the depth.
+    if ( shares.size() < config.depth )
+    {
+      shares.push_back(std::move(share));
+      ++generated;
+    }
+
+    if ( shares.size() >= config.high_watermark )
+    {
+      refilling = false;
+      filled.notify_all();
+    }
+  }
+}
@@ -0,0 +1,206 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+
+#ifndef KEY_SHARE_POOL_HPP
+#define KEY_SHARE_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "EllipticCurve.hpp"
+#include "EllipticCurveConstants.hpp"
+
+#include <gmp.h>
+
+/** A queue of ephemeral key shares, (x, xG), kept topped up by background 
+    threads. Neither the private scalar nor its multiple of the generator 
+    depend on the password or the other party, so a Spake2 session which 
+    takes a share at construction leaves only w{M/N} and a point addition on 
+    the critical path of its setup phase.
+
+    Once the number of queued shares falls to the low watermark, the threads 
+    generate shares until the queue holds the high watermark. A session which
+    finds the queue empty counts a miss and generates its own scalar. Shares 
+    are generated with the same scalar multiplication as the setup phase, so 
+    with CONSTANT_TIME_SCALAR_MULTIPLICATION they use the constant-time 
+    ladder.
+
+    Spake2 sessions only draw from a pool once it is install()ed for its 
+    curve, and only while they are constructed. A pool is uninstalled by its 
+    destructor, which then waits for any takeInstalled() still using it to 
+    return, so a pool may be destroyed while sessions are being constructed.
+*/
+class KeySharePool
+{
+public:
+
+  /// @brief The size of the queue, and the number of threads filling it.
+  struct Config
+  {
+    Config()
+      : depth(256u), low_watermark(64u), high_watermark(256u), threads(1u)
+    {
+    }
+
+    /// The maximum number of queued shares.
+    std::size_t  depth;
+    /// Refilling starts once the queue holds this many shares or fewer.
+    std::size_t  low_watermark;
+    /// Refilling stops once the queue holds this many shares.
+    std::size_t  high_watermark;
+    /// The number of background threads generating shares.
+    unsigned int threads;
+  };
+
+  /// @brief Counters of the pool's use since it was constructed.
+  struct Statistics
+  {
+    /// Shares taken from the queue.
+    std::uint64_t hits;
+    /// Attempts to take a share which found the queue empty.
+    std::uint64_t misses;
+    /// Shares generated by the background threads.
+    std::uint64_t generated;
+    /// Shares currently queued.
+    std::size_t   available;
+  };
+
+  /** Construct a pool for a curve, and start its threads. The pool starts 
+      filling immediately, up to the high watermark.
+      @param curve The curve of the sessions which will take shares.
+      @param config The depth, watermarks and number of threads.
+      @throw std::invalid_argument If the depth or number of threads is zero,
+      or the watermarks do not satisfy low < high <= depth.
+  */
+  explicit KeySharePool(Curves curve, const Config& config = Config());
+
+  /** Uninstall the pool, wait for takeInstalled() calls using it to return, 
+      stop its threads, and wipe and clear the queued shares.
+  */
+  ~KeySharePool();
+
+  /** Take a share from the queue, and wake the threads if that leaves the 
+      queue at the low watermark.
+      @param scalar Set to the private scalar, x, uniform in [1, n). Must be 
+      initialized. Unchanged on a miss.
+      @param share Set to xG. Unchanged on a miss.
+      @return True if a share was taken, false if the queue was empty.
+  */
+  bool take(mpz_t& scalar, EllipticCurve::Point& share);
+
+  /** Block until the queue holds at least the high watermark, e.g. before a
+      server starts accepting connections. Starts refilling if needed.
+  */
+  void waitUntilFilled();
+
+  /** Accessor for the pool's counters.
+      @return A snapshot of the counters.
+  */
+  Statistics getStatistics() const;
+
+  /** Accessor for the curve of the pool's shares.
+      @return The curve the pool was constructed for.
+  */
+  Curves getCurve() const;
+
+  /** Make Spake2 sessions on the pool's curve take their key shares from 
+      the pool, replacing any pool installed for the curve before.
+      @param pool The pool to install.
+  */
+  static void install(KeySharePool& pool);
+
+  /** Stop Spake2 sessions on a curve from taking shares from a pool.
+      @param curve The curve to uninstall the pool of.
+  */
+  static void uninstall(Curves curve);
+
+  /** Take a share from the pool installed for a curve, if any. Lock-free 
+      when no pool is installed. Otherwise the pool's destructor waits for 
+      this to return.
+      @param curve The curve of the session.
+      @param scalar Set to the private scalar. Must be initialized. Unchanged
+      if no share was taken.
+      @param share Set to scalar * G. Unchanged if no share was taken.
+      @return True if a share was taken, false if no pool is installed for 
+      curve or its queue was empty.
+  */
+  static bool takeInstalled(Curves                curve, 
+                            mpz_t&                scalar, 
+                            EllipticCurve::Point& share);
+
+private:
+
+  /// @brief A private scalar, x, and its public multiple, xG.
+  struct KeyShare
+  {
+    KeyShare();
+    ~KeyShare();
+
+    mpz_t                scalar;
+    EllipticCurve::Point point;
+  };
+
+  /// @brief The loop of each background thread.
+  void fill();
+
+  /// @brief Wake every background thread to stop, and join it.
+  void stopThreads();
+
+  /// @brief The curve of the pool's shares.
+  const Curves         curve;
+
+  /// @brief The shared instance of the curve, with its generator table.
+  const EllipticCurve& shared_curve;
+
+  /// @brief The depth and watermarks.
+  const Config         config;
+
+  /// @brief The queued shares, guarded by mutex.
+  std::deque<std::unique_ptr<KeyShare>> shares;
+
+  /// @brief True while the threads should generate shares.
+  bool                 refilling;
+
+  /// @brief True once the destructor has asked the threads to exit.
+  bool                 stopping;
+
+  mutable std::mutex      mutex;
+  std::condition_variable refill_needed;
+  std::condition_variable filled;
+
+  std::atomic<std::uint64_t> hits;
+  std::atomic<std::uint64_t> misses;
+  std::atomic<std::uint64_t> generated;
+
+  std::vector<std::thread> threads;
+
+  /// Both copy assignment and copy constructors are deleted.
+  KeySharePool operator=(const KeySharePool& object) = delete;
+  KeySharePool          (const KeySharePool& object) = delete;
+};
+
+// ============================================================================
+inline Curves KeySharePool::getCurve() const
+{
+  return curve;
+}
+
+#endif
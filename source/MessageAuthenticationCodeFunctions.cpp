@@ -13,16 +13,39 @@
 
 #include "MessageAuthenticationCodeFunctions.hpp"
 
+#include "OpenSslContexts.hpp"
 #include "StringHelpers.hpp"
-#include <openssl/hmac.h>
 
 /** Perform the RFC2104 MAC function on the given message with the given key.
-    Assumes SHA-256.
+    Assumes SHA-256. Re-keys the calling thread's HMAC context, rather than 
+    creating one per call.
+    @param key The key for the MAC function.
+    @param key_length The length of key, in bytes.
+    @param message The message to execute MAC on.
+    @param message_length The length of message, in bytes.
+    @param mac Set to the MAC of message with the given key.
+    @return The length of the MAC, in bytes.
+    @throw std::runtime_error If OpenSSL fails to compute the MAC.
+    @cite https://docs.openssl.org/3.0/man3/EVP_MAC/
+*/
+MessageAuthenticationCodeBytesFunction 
+HMAC_RFC2104_BYTES = [](const unsigned char* key, 
+                        std::size_t          key_length,
+                        const unsigned char* message,
+                        std::size_t          message_length,
+                        unsigned char*       mac) -> std::size_t
+{
+  return OpenSslContexts::hmacSha256(key, key_length, message, message_length,
+                                     mac);
+};
+
+/** Perform the RFC2104 MAC function on the given message with the given key.
+    Assumes SHA-256. Re-keys the calling thread's HMAC context, rather than 
+    creating one per call.
     @param key The key for the MAC function. Should be a hexadecimal string.
     @param message The message to execute MAC on. Should be a hexadecimal 
     string.
     @return The MAC of message with the given key.
-    @cite https://docs.openssl.org/3.0/man3/HMAC/
 */
 MessageAuthenticationCodeFunction 
 HMAC_RFC2104 = [](const std::string& key, 
@@ -31,13 +54,11 @@ HMAC_RFC2104 = [](const std::string& key,
   auto key_bytes = hexStringToBytes(key);
   auto msg_bytes = hexStringToBytes(message);
 
-  unsigned int  len = EVP_MAX_MD_SIZE;
-  unsigned char hmac[EVP_MAX_MD_SIZE];
-
-  if ( HMAC(EVP_sha256(), key_bytes.data(), key_bytes.size(), msg_bytes.data(), 
-            msg_bytes.size(), hmac, &len) == NULL )
-  {
-    throw std::runtime_error("HMAC threw error!");
-  } 
+  unsigned char     hmac[MAX_MAC_BYTES];
+  const std::size_t len = HMAC_RFC2104_BYTES(key_bytes.data(), 
+                                             key_bytes.size(), 
+                                             msg_bytes.data(), 
+                                             msg_bytes.size(), 
+                                             hmac);
   return binaryToHexString(hmac, len);
-};
\ No newline at end of file
+};
@@ -14,20 +14,45 @@
 #ifndef MESSAGE_AUTHENTICATION_CODE_FUNCTIONS_HPP
 #define MESSAGE_AUTHENTICATION_CODE_FUNCTIONS_HPP
 
+#include <cstddef>
 #include <functional>
 #include <map>
 #include <string>
 
+#include <openssl/evp.h>
+
 enum class MessageAuthenticationCodeFunctions
 {
   HMAC,
 };
 
+/// @brief The largest MAC of any MAC function, in bytes.
+constexpr std::size_t MAX_MAC_BYTES = EVP_MAX_MD_SIZE;
+
 using MessageAuthenticationCodeFunction = 
   std::function<std::string(const std::string&, const std::string&)>;
 
-/// @brief HMAC MAC specified by RFC2104.
-extern MessageAuthenticationCodeFunction HMAC_RFC2104;
+/** A MAC function over raw bytes, which writes the MAC into a buffer 
+    provided by the caller.
+    @param key - The key for the MAC function.
+    @param key_length - The length of key, in bytes.
+    @param message - The message to compute the MAC of.
+    @param message_length - The length of message, in bytes.
+    @param mac - Set to the MAC. Must hold MAX_MAC_BYTES.
+    @return The length of the MAC, in bytes.
+*/
+using MessageAuthenticationCodeBytesFunction = 
+  std::function<std::size_t(const unsigned char*, 
+                            std::size_t, 
+                            const unsigned char*, 
+                            std::size_t, 
+                            unsigned char*)>;
+
+/// @brief HMAC MAC specified by RFC2104, over hex strings.
+extern MessageAuthenticationCodeFunction      HMAC_RFC2104;
+
+/// @brief HMAC MAC specified by RFC2104, over raw bytes.
+extern MessageAuthenticationCodeBytesFunction HMAC_RFC2104_BYTES;
 
 /// @brief Map of available MAC functitons. Currently limited to RFC2104.
 const 
@@ -36,4 +61,11 @@ std::map<MessageAuthenticationCodeFunctions, MessageAuthenticationCodeFunction>
   { MessageAuthenticationCodeFunctions::HMAC, HMAC_RFC2104 }
 };
 
+/// @brief The byte-oriented forms of mac_functions.
+const std::map<MessageAuthenticationCodeFunctions, 
+               MessageAuthenticationCodeBytesFunction> mac_bytes_functions = 
+{
+  { MessageAuthenticationCodeFunctions::HMAC, HMAC_RFC2104_BYTES }
+};
+
 #endif
\ No newline at end of file
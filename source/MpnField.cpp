@@ -0,0 +1,237 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+#include "MpnField.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+// ============================================================================
+MpnField::MpnField(const mpz_t& p_in, const mpz_t& a_in)
+  : modulus             (),
+    square_root_exponent(),
+    limb_count          (mpz_size(p_in)),
+    prime               (),
+    prime_inverse       (0),
+    one                 (),
+    r_squared           (),
+    r_cubed             (),
+    a                   (),
+    invert_scratch_size (0)
+{
+  if ( mpz_even_p(p_in) || mpz_cmp_ui(p_in, 1ul) <= 0 || 
+       limb_count > static_cast<mp_size_t>(MAX_LIMBS) )
+  {
+    throw std::invalid_argument("MpnField requires an odd prime modulus of at "
+                                "most MAX_LIMBS limbs.");
+  }
+
+  if ( mpn_sec_add_1_itch(limb_count) > static_cast<mp_size_t>(ADD_SCRATCH_LIMBS) )
+  {
+    throw std::runtime_error("mpn_sec_add_1() needs more scratch than reduce() "
+                             "reserves.");
+  }
+
+  mpz_init_set(modulus, p_in);
+  loadLimbs   (prime,   p_in);
+
+  /// Newton's iteration doubles the number of correct low bits each step, 
+  /// starting from the 3 bits given by p * p == 1 mod 8.
+  mp_limb_t inverse = prime[0];
+  for ( unsigned int i = 0; i < 6u; ++i )
+  {
+    inverse *= 2 - prime[0] * inverse;
+  }
+  prime_inverse = -inverse;
+
+  /// R^k mod p, for k = 1, 2, 3.
+  mpz_t power;
+  mpz_init  (power);
+  mpz_setbit(power, GMP_NUMB_BITS * limb_count);
+  mpz_mod  (power, power, modulus);
+  loadLimbs(one.limbs, power);
+
+  mpz_mul  (power, power, power);
+  mpz_mod  (power, power, modulus);
+  loadLimbs(r_squared.limbs, power);
+
+  mpz_mul_2exp(power, power, GMP_NUMB_BITS * limb_count);
+  mpz_mod     (power, power, modulus);
+  loadLimbs   (r_cubed.limbs, power);
+  mpz_clear   (power);
+
+  fromMpz(a, a_in);
+
+  invert_scratch_size = mpn_sec_invert_itch(limb_count);
+
+  mpz_init_set   (square_root_exponent, modulus);
+  mpz_add_ui     (square_root_exponent, square_root_exponent, 1ul);
+  mpz_fdiv_q_2exp(square_root_exponent, square_root_exponent, 2ul);
+}
+
+// ============================================================================
+MpnField::~MpnField()
+{
+  mpz_clears(modulus, square_root_exponent, nullptr);
+}
+
+// ============================================================================
+void MpnField::loadLimbs(mp_limb_t* result, const mpz_t& value) const
+{
+  const mp_size_t size = mpz_size(value);
+
+  mpn_copyi(result,        mpz_limbs_read(value), size);
+  mpn_zero (result + size, limb_count - size);
+}
+
+// ============================================================================
+void MpnField::fromMpz(Element& result, const mpz_t& value) const
+{
+  Element reduced;
+
+  if ( mpz_sgn(value) < 0 || mpz_cmp(value, modulus) >= 0 )
+  {
+    /// Out of range values are rare, so take the slow path.
+    mpz_t remainder;
+    mpz_init (remainder);
+    mpz_mod  (remainder, value, modulus);
+    loadLimbs(reduced.limbs, remainder);
+    mpz_clear(remainder);
+  }
+  else
+  {
+    loadLimbs(reduced.limbs, value);
+  }
+
+  /// xR = x * R^2 * R^-1
+  mul(result, reduced, r_squared);
+}
+
+// ============================================================================
+void MpnField::toMpz(mpz_t result, const Element& value) const
+{
+  mp_limb_t product[2 * MAX_LIMBS];
+  Element   normal;
+
+  /// x = xR * 1 * R^-1
+  mpn_copyi(product,              value.limbs, limb_count);
+  mpn_zero (product + limb_count, limb_count);
+  reduce   (normal,               product);
+
+  mp_limb_t* const limbs = mpz_limbs_write(result, limb_count);
+  mpn_copyi       (limbs,  normal.limbs, limb_count);
+  mpz_limbs_finish(result, limb_count);
+}
+
+// ============================================================================
+void MpnField::invert(Element& result, const Element& value) const
+{
+  /// The scratch fits on the stack unless GMP asks for more than 4n limbs.
+  mp_limb_t              stack_scratch[INVERT_SCRATCH_LIMBS];
+  std::vector<mp_limb_t> heap_scratch;
+  mp_limb_t*             scratch = stack_scratch;
+  if ( invert_scratch_size > static_cast<mp_size_t>(INVERT_SCRATCH_LIMBS) )
+  {
+    heap_scratch.resize(invert_scratch_size);
+    scratch = heap_scratch.data();
+  }
+
+  Element input(value);
+
+  /// (xR)^-1 = x^-1 R^-1, and x^-1 R^-1 * R^3 * R^-1 = x^-1 R.
+  if ( mpn_sec_invert(result.limbs, 
+                      input.limbs, 
+                      prime, 
+                      limb_count, 
+                      2 * GMP_NUMB_BITS * limb_count, 
+                      scratch) == 0 )
+  {
+    setZero(result);
+    return;
+  }
+
+  mul(result, result, r_cubed);
+}
+
+// ============================================================================
+void MpnField::invertVariableTime(Element& result, const Element& value) const
+{
+  mp_size_t value_size = limb_count;
+  while ( value_size > 0 && value.limbs[value_size - 1] == 0 )
+  {
+    --value_size;
+  }
+
+  /// mpn_gcdext() needs the first operand to have at least as many limbs as p.
+  if ( value_size < static_cast<mp_size_t>(limb_count) )
+  {
+    invert(result, value);
+    return;
+  }
+
+  /// mpn_gcdext() destroys its operands, and needs a spare limb in each.
+  mp_limb_t u[MAX_LIMBS + 1];
+  mp_limb_t v[MAX_LIMBS + 1];
+  mp_limb_t gcd[MAX_LIMBS];
+  mp_limb_t cofactor[MAX_LIMBS + 1];
+  mp_size_t cofactor_size = 0;
+  mpn_copyi(u, value.limbs, limb_count);
+  mpn_copyi(v, prime,       limb_count);
+
+  /// 1 = (xR) * S + p * T, so S = (xR)^-1, which may be negative.
+  const mp_size_t gcd_size = 
+    mpn_gcdext(gcd, cofactor, &cofactor_size, u, limb_count, v, limb_count);
+  if ( gcd_size != 1 || gcd[0] != 1 )
+  {
+    setZero(result);
+    return;
+  }
+
+  const mp_size_t magnitude = cofactor_size < 0 ? -cofactor_size : cofactor_size;
+  mpn_copyi(result.limbs,             cofactor, magnitude);
+  mpn_zero (result.limbs + magnitude, limb_count - magnitude);
+  if ( cofactor_size < 0 )
+  {
+    mpn_sub_n(result.limbs, prime, result.limbs, limb_count);
+  }
+
+  /// (xR)^-1 = x^-1 R^-1, and x^-1 R^-1 * R^3 * R^-1 = x^-1 R.
+  mul(result, result, r_cubed);
+}
+
+// ============================================================================
+bool MpnField::squareRoot(Element& result, const Element& value) const
+{
+  if ( mpz_fdiv_ui(modulus, 4ul) != 3ul )
+  {
+    throw std::invalid_argument("Square roots require p = 3 mod 4.");
+  }
+
+  Element root;
+  setOne(root);
+  for ( std::size_t bit = mpz_sizeinbase(square_root_exponent, 2); bit-- > 0; )
+  {
+    sqr(root, root);
+    if ( mpz_tstbit(square_root_exponent, bit) )
+    {
+      mul(root, root, value);
+    }
+  }
+
+  Element difference;
+  sqr(difference, root);
+  sub(difference, difference, value);
+
+  result = root;
+  return isZero(difference);
+}
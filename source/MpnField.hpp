@@ -0,0 +1,330 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+#ifndef MPN_FIELD_HPP
+#define MPN_FIELD_HPP
+
+#include <cstddef>
+
+#include <gmp.h>
+
+/** Generic prime field arithmetic built on GMP's low-level mpn_ and mpn_sec_
+    functions. Elements live in fixed-size limb buffers on the stack and are 
+    kept in Montgomery form, i.e. x is stored as xR mod p where 
+    R = 2^(GMP_NUMB_BITS * n) for an n-limb prime. Multiplication uses a 
+    word-by-word Montgomery reduction in place of a division, inversion uses 
+    mpn_sec_invert(), and reductions after addition and subtraction are 
+    branch-free. Unlike P256Field, any odd prime of up to MAX_LIMBS limbs is 
+    supported.
+*/
+class MpnField
+{
+public:
+
+  /// @brief The largest supported prime, in limbs. Enough for P-521.
+  static const unsigned int MAX_LIMBS = 576u / GMP_NUMB_BITS;
+
+  /** @brief A field element in Montgomery form, stored as little-endian 
+      limbs. Only the first limb_count limbs of the field are used.
+  */
+  struct Element
+  {
+    mp_limb_t limbs[MAX_LIMBS];
+  };
+
+  /** Construct a new field.
+      @param p_in The prime modulus of the field. Must be odd.
+      @param a_in The curve's a parameter, reduced into the field.
+      @throw std::invalid_argument if p_in is even or larger than MAX_LIMBS 
+      limbs.
+      @throw std::runtime_error if GMP's mpn_sec_add_1() needs more than 
+      ADD_SCRATCH_LIMBS limbs of scratch.
+   */
+  MpnField(const mpz_t& p_in, const mpz_t& a_in);
+
+  /// @brief The destructor clears memory allocated by mpz_init().
+  ~MpnField();
+
+  /** Load an integer into the field, reducing it modulo p.
+      @param result The element to place the reduced value into.
+      @param value The integer to load.
+   */
+  void fromMpz(Element& result, const mpz_t& value) const;
+
+  /** Store a field element as an integer in [0, p).
+      @param result The integer to place the value into.
+      @param value The element to store.
+   */
+  void toMpz(mpz_t result, const Element& value) const;
+
+  /// @brief result = 0
+  void setZero(Element& result) const;
+
+  /// @brief result = 1
+  void setOne(Element& result) const;
+
+  /// @brief result = lhs + rhs mod p
+  void add(Element& result, const Element& lhs, const Element& rhs) const;
+
+  /// @brief result = lhs - rhs mod p
+  void sub(Element& result, const Element& lhs, const Element& rhs) const;
+
+  /// @brief result = lhs * rhs mod p
+  void mul(Element& result, const Element& lhs, const Element& rhs) const;
+
+  /// @brief result = value^2 mod p
+  void sqr(Element& result, const Element& value) const;
+
+  /// @brief result = -value mod p
+  void neg(Element& result, const Element& value) const;
+
+  /// @brief result = value^-1 mod p. The inverse of zero is zero.
+  void invert(Element& result, const Element& value) const;
+
+  /** invert() with mpz_invert(), which is several times faster than 
+      mpn_sec_invert(). Elements are in Montgomery form, so the inverse still
+      takes a multiplication by R^3.
+  */
+  void invertVariableTime(Element& result, const Element& value) const;
+
+  /** result = value^((p + 1) / 4) mod p, which is a square root of value 
+      whenever one exists. Requires p = 3 mod 4. Uses square and multiply 
+      over the public exponent.
+      @param result The element to place the root into.
+      @param value The element to take the square root of.
+      @return True if value is a square, i.e. result^2 == value.
+      @throw std::invalid_argument if p is not 3 mod 4.
+  */
+  bool squareRoot(Element& result, const Element& value) const;
+
+  /** result = value if condition is 1, otherwise result is left unchanged. 
+      Runs without branching on, or indexing by, condition.
+      @param result The element to conditionally overwrite.
+      @param value The element to copy.
+      @param condition Either 0 or 1.
+   */
+  void conditionalMove(Element&       result, 
+                       const Element& value, 
+                       unsigned int   condition) const;
+
+  /// @brief Test if value == 0.
+  bool isZero(const Element& value) const;
+
+  /// @brief Test if value == 1.
+  bool isOne(const Element& value) const;
+
+  /** Accessor for the memory held by a single field element.
+      @return The size of an element, in bytes.
+   */
+  std::size_t getElementBytes() const;
+
+  /** Accessor for the curve's a parameter as a field element.
+      @return Const-reference to a.
+   */
+  const Element& getA() const;
+
+private:
+
+  /** Montgomery reduction. Computes product * R^-1 mod p in [0, p).
+      @param result The element to place the reduced value into.
+      @param product A 2n-limb value less than pR. It is overwritten.
+   */
+  void reduce(Element& result, mp_limb_t product[2 * MAX_LIMBS]) const;
+
+  /** Copy a non-negative integer less than 2^(GMP_NUMB_BITS * n) into a 
+      buffer of limb_count limbs, without conversion to Montgomery form.
+      @param result The limbs to place value into.
+      @param value The integer to copy.
+   */
+  void loadLimbs(mp_limb_t* result, const mpz_t& value) const;
+
+  /// @brief The prime modulus as an integer, for out of range reductions.
+  mpz_t modulus;
+
+  /// @brief (p + 1) / 4, the exponent of squareRoot().
+  mpz_t square_root_exponent;
+
+  /// @brief The number of limbs in the prime modulus.
+  mp_size_t limb_count;
+
+  /// @brief The prime modulus, as limbs.
+  mp_limb_t prime[MAX_LIMBS];
+
+  /// @brief -p^-1 mod 2^GMP_NUMB_BITS, used by the Montgomery reduction.
+  mp_limb_t prime_inverse;
+
+  /// @brief R mod p, i.e. 1 in Montgomery form.
+  Element one;
+
+  /// @brief R^2 mod p, used to convert into Montgomery form.
+  Element r_squared;
+
+  /// @brief R^3 mod p, used to convert an inverse back into Montgomery form.
+  Element r_cubed;
+
+  /// @brief The curve's a parameter, in Montgomery form.
+  Element a;
+
+  /// @brief The number of scratch limbs needed by mpn_sec_invert().
+  mp_size_t invert_scratch_size;
+
+  /// @brief The stack scratch for mpn_sec_invert(), 4n limbs in GMP 6.
+  static const unsigned int INVERT_SCRATCH_LIMBS = 4u * MAX_LIMBS;
+
+  /// @brief The stack scratch for mpn_sec_add_1() in reduce(), n limbs in GMP 6.
+  static const unsigned int ADD_SCRATCH_LIMBS = MAX_LIMBS;
+
+  /// Both copy assignment and copy constructors are deleted.
+  MpnField operator=(const MpnField& object) = delete;
+  MpnField          (const MpnField& object) = delete;
+};
+
+// ============================================================================
+inline void MpnField::setZero(Element& result) const
+{
+  mpn_zero(result.limbs, limb_count);
+}
+
+// ============================================================================
+inline void MpnField::setOne(Element& result) const
+{
+  mpn_copyi(result.limbs, one.limbs, limb_count);
+}
+
+// ============================================================================
+inline void MpnField::conditionalMove(Element&       result, 
+                                      const Element& value, 
+                                      unsigned int   condition) const
+{
+  const mp_limb_t mask = 0 - static_cast<mp_limb_t>(condition & 1u);
+
+  for ( mp_size_t i = 0; i < limb_count; ++i )
+  {
+    result.limbs[i] ^= ( result.limbs[i] ^ value.limbs[i] ) & mask;
+  }
+}
+
+// ============================================================================
+inline bool MpnField::isZero(const Element& value) const
+{
+  /// Unlike mpn_zero_p(), every limb is read.
+  mp_limb_t bits = 0;
+  for ( mp_size_t i = 0; i < limb_count; ++i )
+  {
+    bits |= value.limbs[i];
+  }
+  return bits == 0;
+}
+
+// ============================================================================
+inline bool MpnField::isOne(const Element& value) const
+{
+  return mpn_cmp(value.limbs, one.limbs, limb_count) == 0;
+}
+
+// ============================================================================
+inline const MpnField::Element& MpnField::getA() const
+{
+  return a;
+}
+
+// ============================================================================
+inline std::size_t MpnField::getElementBytes() const
+{
+  return sizeof(Element);
+}
+
+// ============================================================================
+inline void 
+MpnField::add(Element& result, const Element& lhs, const Element& rhs) const
+{
+  mp_limb_t sum[MAX_LIMBS];
+
+  const mp_limb_t carry  = 
+    mpn_add_n(sum,          lhs.limbs, rhs.limbs, limb_count);
+  const mp_limb_t borrow = 
+    mpn_sub_n(result.limbs, sum,       prime,     limb_count);
+
+  /// Keep the unreduced sum only if it was already below p.
+  mpn_cnd_swap(borrow & ( carry ^ 1 ), result.limbs, sum, limb_count);
+}
+
+// ============================================================================
+inline void 
+MpnField::sub(Element& result, const Element& lhs, const Element& rhs) const
+{
+  const mp_limb_t borrow = 
+    mpn_sub_n(result.limbs, lhs.limbs, rhs.limbs, limb_count);
+
+  mpn_cnd_add_n(borrow, result.limbs, result.limbs, prime, limb_count);
+}
+
+// ============================================================================
+inline void 
+MpnField::mul(Element& result, const Element& lhs, const Element& rhs) const
+{
+  mp_limb_t product[2 * MAX_LIMBS];
+
+  mpn_mul_n(product, lhs.limbs, rhs.limbs, limb_count);
+  reduce   (result,  product);
+}
+
+// ============================================================================
+inline void MpnField::sqr(Element& result, const Element& value) const
+{
+  mp_limb_t product[2 * MAX_LIMBS];
+
+  mpn_sqr(product, value.limbs, limb_count);
+  reduce (result,  product);
+}
+
+// ============================================================================
+inline void MpnField::neg(Element& result, const Element& value) const
+{
+  Element zero;
+  setZero(zero);
+  sub    (result, zero, value);
+}
+
+// ============================================================================
+inline void 
+MpnField::reduce(Element& result, mp_limb_t product[2 * MAX_LIMBS]) const
+{
+  mp_limb_t carry = 0;
+  mp_limb_t scratch[ADD_SCRATCH_LIMBS];
+
+  /** Clear one limb per row by adding a multiple of p. Unlike mpn_add_1(), 
+      mpn_sec_add_1() propagates the row's carry through every limb, rather
+      than stopping once it is absorbed.
+  */
+  for ( mp_size_t i = 0; i < limb_count; ++i )
+  {
+    const mp_limb_t multiple  = product[i] * prime_inverse;
+    const mp_limb_t row_carry = 
+      mpn_addmul_1(product + i, prime, limb_count, multiple);
+
+    carry += mpn_sec_add_1(product + i + limb_count, 
+                           product + i + limb_count, 
+                           limb_count - i, 
+                           row_carry,
+                           scratch);
+  }
+
+  /// The upper half is now below 2p.
+  mp_limb_t* const upper  = product + limb_count;
+  const mp_limb_t  borrow = mpn_sub_n(result.limbs, upper, prime, limb_count);
+
+  mpn_cnd_swap(borrow & ( carry ^ 1 ), result.limbs, upper, limb_count);
+}
+
+#endif
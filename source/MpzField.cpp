@@ -0,0 +1,81 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+#include "MpzField.hpp"
+
+#include <stdexcept>
+
+// ============================================================================
+MpzField::MpzField(const mpz_t& p_in, const mpz_t& a_in)
+  : p(),
+    square_root_exponent(),
+    a()
+{
+  mpz_init_set(p, p_in);
+  fromMpz(a, a_in);
+
+  mpz_init_set   (square_root_exponent, p);
+  mpz_add_ui     (square_root_exponent, square_root_exponent, 1ul);
+  mpz_fdiv_q_2exp(square_root_exponent, square_root_exponent, 2ul);
+}
+
+// ============================================================================
+MpzField::~MpzField()
+{
+  mpz_clears(p, square_root_exponent, nullptr);
+}
+
+// ============================================================================
+void MpzField::fromMpz(Element& result, const mpz_t& value) const
+{
+  mpz_mod(result.value, value, p);
+}
+
+// ============================================================================
+void MpzField::toMpz(mpz_t result, const Element& value) const
+{
+  mpz_set(result, value.value);
+}
+
+// ============================================================================
+void MpzField::invert(Element& result, const Element& value) const
+{
+  if ( mpz_invert(result.value, value.value, p) == 0 )
+  {
+    mpz_set_ui(result.value, 0ul);
+  }
+}
+
+// ============================================================================
+void MpzField::invertVariableTime(Element& result, const Element& value) const
+{
+  invert(result, value);
+}
+
+// ============================================================================
+bool MpzField::squareRoot(Element& result, const Element& value) const
+{
+  if ( mpz_fdiv_ui(p, 4ul) != 3ul )
+  {
+    throw std::invalid_argument("Square roots require p = 3 mod 4.");
+  }
+
+  Element root;
+  mpz_powm(root.value, value.value, square_root_exponent, p);
+
+  Element squared;
+  sqr(squared, root);
+
+  mpz_swap(result.value, root.value);
+  return mpz_cmp(squared.value, value.value) == 0;
+}
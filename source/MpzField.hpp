@@ -0,0 +1,258 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+#ifndef MPZ_FIELD_HPP
+#define MPZ_FIELD_HPP
+
+#include <cstddef>
+
+#include <gmp.h>
+
+/** Generic prime field arithmetic backed by heap-allocated mpz_t integers. 
+    Every operation is followed by a reduction modulo p, so elements are 
+    always kept in [0, p). This backend supports any curve, and is the 
+    default for curves without a dedicated backend.
+*/
+class MpzField
+{
+public:
+
+  /// @brief A field element, owning a single mpz_t.
+  struct Element
+  {
+    Element()
+    {
+      mpz_init(value);
+    }
+
+    ~Element()
+    {
+      mpz_clear(value);
+    }
+
+    Element(const Element& other)
+    {
+      mpz_init_set(value, other.value);
+    }
+
+    Element& operator=(const Element& other)
+    {
+      if (this != &other)
+      {
+        mpz_set(value, other.value);
+      }
+      return *this;
+    }
+
+    mpz_t value;
+  };
+
+  /** Construct a new field.
+      @param p_in The prime modulus of the field.
+      @param a_in The curve's a parameter, reduced into the field.
+   */
+  MpzField(const mpz_t& p_in, const mpz_t& a_in);
+
+  /// @brief The destructor clears memory allocated by mpz_init().
+  ~MpzField();
+
+  /** Load an integer into the field, reducing it modulo p.
+      @param result The element to place the reduced value into.
+      @param value The integer to load.
+   */
+  void fromMpz(Element& result, const mpz_t& value) const;
+
+  /** Store a field element as an integer in [0, p).
+      @param result The integer to place the value into.
+      @param value The element to store.
+   */
+  void toMpz(mpz_t result, const Element& value) const;
+
+  /// @brief result = 0
+  void setZero(Element& result) const;
+
+  /// @brief result = 1
+  void setOne(Element& result) const;
+
+  /// @brief result = lhs + rhs mod p
+  void add(Element& result, const Element& lhs, const Element& rhs) const;
+
+  /// @brief result = lhs - rhs mod p
+  void sub(Element& result, const Element& lhs, const Element& rhs) const;
+
+  /// @brief result = lhs * rhs mod p
+  void mul(Element& result, const Element& lhs, const Element& rhs) const;
+
+  /// @brief result = value^2 mod p
+  void sqr(Element& result, const Element& value) const;
+
+  /// @brief result = -value mod p
+  void neg(Element& result, const Element& value) const;
+
+  /// @brief result = value^-1 mod p. The inverse of zero is zero.
+  void invert(Element& result, const Element& value) const;
+
+  /// @brief invert(), which is already variable time.
+  void invertVariableTime(Element& result, const Element& value) const;
+
+  /** result = value^((p + 1) / 4) mod p, which is a square root of value 
+      whenever one exists. Requires p = 3 mod 4.
+      @param result The element to place the root into.
+      @param value The element to take the square root of.
+      @return True if value is a square, i.e. result^2 == value.
+      @throw std::invalid_argument if p is not 3 mod 4.
+  */
+  bool squareRoot(Element& result, const Element& value) const;
+
+  /** result = value if condition is 1, otherwise result is left unchanged. 
+      mpz_t integers vary in size, so unlike the other backends this branches
+      on condition.
+      @param result The element to conditionally overwrite.
+      @param value The element to copy.
+      @param condition Either 0 or 1.
+   */
+  void conditionalMove(Element&       result, 
+                       const Element& value, 
+                       unsigned int   condition) const;
+
+  /// @brief Test if value == 0.
+  bool isZero(const Element& value) const;
+
+  /// @brief Test if value == 1.
+  bool isOne(const Element& value) const;
+
+  /** Accessor for the memory held by a single field element, including any
+      heap allocations.
+      @return The size of an element, in bytes.
+   */
+  std::size_t getElementBytes() const;
+
+  /** Accessor for the curve's a parameter as a field element.
+      @return Const-reference to a.
+   */
+  const Element& getA() const;
+
+private:
+
+  /// @brief The prime modulus.
+  mpz_t p;
+
+  /// @brief (p + 1) / 4, the exponent of squareRoot().
+  mpz_t square_root_exponent;
+
+  /// @brief The curve's a parameter, in [0, p).
+  Element a;
+
+  /// Both copy assignment and copy constructors are deleted.
+  MpzField operator=(const MpzField& object) = delete;
+  MpzField          (const MpzField& object) = delete;
+};
+
+// ============================================================================
+inline void MpzField::setZero(Element& result) const
+{
+  mpz_set_ui(result.value, 0ul);
+}
+
+// ============================================================================
+inline void MpzField::setOne(Element& result) const
+{
+  mpz_set_ui(result.value, 1ul);
+}
+
+// ============================================================================
+inline void MpzField::conditionalMove(Element&       result, 
+                                      const Element& value, 
+                                      unsigned int   condition) const
+{
+  if ( condition )
+  {
+    mpz_set(result.value, value.value);
+  }
+}
+
+// ============================================================================
+inline bool MpzField::isZero(const Element& value) const
+{
+  return mpz_sgn(value.value) == 0;
+}
+
+// ============================================================================
+inline bool MpzField::isOne(const Element& value) const
+{
+  return mpz_cmp_ui(value.value, 1ul) == 0;
+}
+
+// ============================================================================
+inline const MpzField::Element& MpzField::getA() const
+{
+  return a;
+}
+
+// ============================================================================
+inline std::size_t MpzField::getElementBytes() const
+{
+  return sizeof(Element) + mpz_size(p) * sizeof(mp_limb_t);
+}
+
+// ============================================================================
+inline void 
+MpzField::add(Element& result, const Element& lhs, const Element& rhs) const
+{
+  mpz_add(result.value, lhs.value, rhs.value);
+  if ( mpz_cmp(result.value, p) >= 0 )
+  {
+    mpz_sub(result.value, result.value, p);
+  }
+}
+
+// ============================================================================
+inline void 
+MpzField::sub(Element& result, const Element& lhs, const Element& rhs) const
+{
+  mpz_sub(result.value, lhs.value, rhs.value);
+  if ( mpz_sgn(result.value) < 0 )
+  {
+    mpz_add(result.value, result.value, p);
+  }
+}
+
+// ============================================================================
+inline void 
+MpzField::mul(Element& result, const Element& lhs, const Element& rhs) const
+{
+  mpz_mul   (result.value, lhs.value,    rhs.value);
+  mpz_tdiv_r(result.value, result.value, p);
+}
+
+// ============================================================================
+inline void MpzField::sqr(Element& result, const Element& value) const
+{
+  mpz_mul   (result.value, value.value,  value.value);
+  mpz_tdiv_r(result.value, result.value, p);
+}
+
+// ============================================================================
+inline void MpzField::neg(Element& result, const Element& value) const
+{
+  if ( mpz_sgn(value.value) == 0 )
+  {
+    mpz_set_ui(result.value, 0ul);
+  }
+  else
+  {
+    mpz_sub(result.value, p, value.value);
+  }
+}
+
+#endif
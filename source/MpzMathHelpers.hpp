@@ -14,31 +14,11 @@
 #ifndef MPZ_MATH_HELPERS_HPP
 #define MPZ_MATH_HELPERS_HPP
 
-#include <random>
 #include <string>
 
 #include "Constants.hpp"
 #include "gmp.h"
 
-/** Compute a uniform random number from [0, upper_bound)
-    @param value The value to put the random number into.
-    @param upper_bound The upper bound for the random number. Note that this 
-    bound is not included.
-*/
-inline void uniformRandomNumber(mpz_t& value, const mpz_t& upper_bound)
-{
-  static bool            initialized = false;
-  static gmp_randstate_t random_state;
-
-  if ( !initialized )
-  {
-    gmp_randinit_default(random_state);
-    gmp_randseed_ui     (random_state, std::random_device{}());
-    initialized = true;
-  }
-  mpz_urandomm(value, random_state, upper_bound);
-}
-
 /** Helper function to convert mpz_t into a padded string (without "0x" prefix).
     @param num The number to convert and potentially pad.
     @param width The desired padded width of num. If the width of num is less than this number, it is padded by padded_char.
@@ -53,7 +33,11 @@ inline std::string padMpz(const mpz_t& num,
 {
   char* hex_str = mpz_get_str(nullptr, base, num);
   std::string result(hex_str);
-  free(hex_str);
+
+  /// The string must be released through GMP's own memory functions.
+  void (*gmp_free)(void*, std::size_t) = nullptr;
+  mp_get_memory_functions(nullptr, nullptr, &gmp_free);
+  gmp_free(hex_str, result.length() + 1u);
 
   if (width > result.length())
   {
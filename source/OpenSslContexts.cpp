@@ -0,0 +1,167 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+
+#include "OpenSslContexts.hpp"
+
+#include <stdexcept>
+
+#include <openssl/core_names.h>
+#include <openssl/kdf.h>
+#include <openssl/params.h>
+#include <openssl/sha.h>
+
+namespace
+{
+  /// @brief The digest of the HMAC and HKDF contexts, as a parameter.
+  char digest_name[] = OSSL_DIGEST_NAME_SHA2_256;
+  const OSSL_PARAM digest_params[] =
+  {
+    OSSL_PARAM_construct_utf8_string(OSSL_ALG_PARAM_DIGEST, digest_name, 0),
+    OSSL_PARAM_construct_end()
+  };
+
+  /** The OpenSSL objects of a single thread. The HMAC and HKDF contexts 
+      have their digest set once, and are re-keyed by each call.
+  */
+  struct ThreadContexts
+  {
+    ThreadContexts()
+      : hmac        (EVP_MAC_fetch(nullptr, OSSL_MAC_NAME_HMAC, nullptr)),
+        hkdf        (EVP_KDF_fetch(nullptr, OSSL_KDF_NAME_HKDF, nullptr)),
+        hmac_context(hmac == nullptr ? nullptr : EVP_MAC_CTX_new(hmac)),
+        hkdf_context(hkdf == nullptr ? nullptr : EVP_KDF_CTX_new(hkdf))
+    {
+      if ( hmac_context == nullptr || hkdf_context == nullptr ||
+           EVP_MAC_CTX_set_params(hmac_context, digest_params) != 1 ||
+           EVP_KDF_CTX_set_params(hkdf_context, digest_params) != 1 )
+      {
+        release();
+        throw std::runtime_error("Failed to create the HMAC and HKDF contexts.");
+      }
+    }
+
+    ~ThreadContexts()
+    {
+      release();
+    }
+
+    void release()
+    {
+      EVP_MAC_CTX_free(hmac_context);
+      EVP_KDF_CTX_free(hkdf_context);
+      EVP_MAC_free    (hmac);
+      EVP_KDF_free    (hkdf);
+    }
+
+    EVP_MAC*     hmac;
+    EVP_KDF*     hkdf;
+    EVP_MAC_CTX* hmac_context;
+    EVP_KDF_CTX* hkdf_context;
+  };
+
+  /// @brief The calling thread's contexts, created on first use.
+  ThreadContexts& getThreadContexts()
+  {
+    thread_local ThreadContexts thread_contexts;
+    return thread_contexts;
+  }
+}
+
+// ============================================================================
+const EVP_MD* OpenSslContexts::getSha256()
+{
+  /// Fetched digests are reference counted, and may be shared by threads.
+  static EVP_MD* const sha256 = 
+    EVP_MD_fetch(nullptr, OSSL_DIGEST_NAME_SHA2_256, nullptr);
+  if ( sha256 == nullptr )
+  {
+    throw std::runtime_error("Failed to fetch SHA-256.");
+  }
+  return sha256;
+}
+
+// ============================================================================
+std::size_t OpenSslContexts::hmacSha256(const unsigned char* key, 
+                                        std::size_t          key_length,
+                                        const unsigned char* message,
+                                        std::size_t          message_length,
+                                        unsigned char*       mac)
+{
+  EVP_MAC_CTX* const context = getThreadContexts().hmac_context;
+
+  /// Initializing with a key keeps the digest, and reuses the context.
+  std::size_t length = 0u;
+  if ( EVP_MAC_init  (context, key, key_length, nullptr)    != 1 ||
+       EVP_MAC_update(context, message, message_length)      != 1 ||
+       EVP_MAC_final (context, mac, &length, EVP_MAX_MD_SIZE) != 1 )
+  {
+    throw std::runtime_error("HMAC threw error!");
+  }
+  return length;
+}
+
+// ============================================================================
+void OpenSslContexts::hkdfSha256(const unsigned char* key, 
+                                 std::size_t          key_length,
+                                 const unsigned char* first_info,
+                                 std::size_t          first_info_length,
+                                 const unsigned char* second_info,
+                                 std::size_t          second_info_length,
+                                 unsigned char*       output,
+                                 std::size_t          output_length)
+{
+  EVP_KDF_CTX* const context = getThreadContexts().hkdf_context;
+
+  /** RFC 5869 treats an empty salt as HashLen zero bytes, which is passed 
+      explicitly, as OpenSSL 3.0 does not accept a missing salt. Each info 
+      parameter replaces the info of the previous call, and repeated ones are 
+      concatenated. OpenSSL 3.0 does not accept an empty info parameter 
+      either, so an empty info instead resets the context.
+  */
+  static unsigned char zero_salt[SHA256_DIGEST_LENGTH] = { 0u };
+
+  if ( first_info_length == 0u && second_info_length == 0u )
+  {
+    EVP_KDF_CTX_reset(context);
+    if ( EVP_KDF_CTX_set_params(context, digest_params) != 1 )
+    {
+      throw std::runtime_error("HKDF parameter setup failed.");
+    }
+  }
+
+  OSSL_PARAM params[5];
+  std::size_t count = 0u;
+  params[count++] = OSSL_PARAM_construct_octet_string(
+    OSSL_KDF_PARAM_SALT, zero_salt,                       sizeof(zero_salt));
+  params[count++] = OSSL_PARAM_construct_octet_string(
+    OSSL_KDF_PARAM_KEY,  const_cast<unsigned char*>(key), key_length);
+  if ( first_info_length > 0u )
+  {
+    params[count++] = OSSL_PARAM_construct_octet_string(
+      OSSL_KDF_PARAM_INFO, const_cast<unsigned char*>(first_info), 
+      first_info_length);
+  }
+  if ( second_info_length > 0u )
+  {
+    params[count++] = OSSL_PARAM_construct_octet_string(
+      OSSL_KDF_PARAM_INFO, const_cast<unsigned char*>(second_info), 
+      second_info_length);
+  }
+  params[count] = OSSL_PARAM_construct_end();
+
+  if ( EVP_KDF_derive(context, output, output_length, params) != 1 )
+  {
+    throw std::runtime_error("HKDF derivation failed.");
+  }
+}
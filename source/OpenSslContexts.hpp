@@ -0,0 +1,83 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+
+#ifndef OPEN_SSL_CONTEXTS_HPP
+#define OPEN_SSL_CONTEXTS_HPP
+
+#include <cstddef>
+
+#include <openssl/evp.h>
+
+/** Per-thread OpenSSL objects for the SHA-256 based HMAC and HKDF. Each 
+    thread fetches the SHA-256, HMAC and HKDF implementations once, and 
+    creates one HMAC and one HKDF context with the digest already set. Each
+    call then only re-keys its thread's context, so no OpenSSL objects are 
+    created, fetched or freed per handshake.
+*/
+class OpenSslContexts
+{
+public:
+
+  /** Accessor for SHA-256, fetched once for the process. Unlike EVP_sha256(),
+      an explicitly fetched digest is not looked up again by every 
+      EVP_DigestInit_ex().
+      @return The SHA-256 message digest.
+      @throw std::runtime_error If SHA-256 cannot be fetched.
+  */
+  static const EVP_MD* getSha256();
+
+  /** Compute HMAC-SHA-256 with the calling thread's context.
+      @param key The key for the MAC.
+      @param key_length The length of key, in bytes.
+      @param message The message to compute the MAC of.
+      @param message_length The length of message, in bytes.
+      @param mac Set to the MAC. Must hold EVP_MAX_MD_SIZE bytes.
+      @return The length of the MAC, in bytes.
+      @throw std::runtime_error If OpenSSL fails to compute the MAC.
+  */
+  static std::size_t hmacSha256(const unsigned char* key, 
+                                std::size_t          key_length,
+                                const unsigned char* message,
+                                std::size_t          message_length,
+                                unsigned char*       mac);
+
+  /** Compute HKDF-SHA-256 (RFC 5869) with an empty salt and the info 
+      first_info || second_info, with the calling thread's context.
+      @param key The input keying material.
+      @param key_length The length of key, in bytes.
+      @param first_info The start of the info.
+      @param first_info_length The length of first_info, in bytes.
+      @param second_info The rest of the info. May be empty.
+      @param second_info_length The length of second_info, in bytes.
+      @param output Set to the derived key.
+      @param output_length The number of bytes to derive into output.
+      @throw std::runtime_error If OpenSSL fails to derive the key.
+  */
+  static void hkdfSha256(const unsigned char* key, 
+                         std::size_t          key_length,
+                         const unsigned char* first_info,
+                         std::size_t          first_info_length,
+                         const unsigned char* second_info,
+                         std::size_t          second_info_length,
+                         unsigned char*       output,
+                         std::size_t          output_length);
+
+private:
+
+  /// Both copy assignment and copy constructors are deleted.
+  OpenSslContexts operator=(const OpenSslContexts& object) = delete;
+  OpenSslContexts          (const OpenSslContexts& object) = delete;
+};
+
+#endif
@@ -0,0 +1,242 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+#include "P256Field.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+/// p = 2^256 - 2^224 + 2^192 + 2^96 - 1
+const P256Field::Element P256Field::prime = 
+{
+  { 0xffffffffffffffffull, 0x00000000ffffffffull, 
+    0x0000000000000000ull, 0xffffffff00000001ull }
+};
+
+/// a = -3 mod p
+const P256Field::Element P256Field::a = 
+{
+  { 0xfffffffffffffffcull, 0x00000000ffffffffull, 
+    0x0000000000000000ull, 0xffffffff00000001ull }
+};
+
+// ============================================================================
+P256Field::P256Field(const mpz_t& p_in, const mpz_t& a_in)
+{
+  mpz_t expected;
+  mpz_init(expected);
+
+  toMpz(expected, prime);
+  const bool valid_p = mpz_cmp(expected, p_in) == 0;
+
+  /// a == -3 mod p
+  mpz_add_ui(expected, a_in, 3ul);
+  const bool valid_a = mpz_divisible_p(expected, p_in) != 0;
+
+  mpz_clear(expected);
+
+  if ( !valid_p || !valid_a )
+  {
+    throw std::invalid_argument("P256Field requires the curve P-256.");
+  }
+}
+
+// ============================================================================
+P256Field::~P256Field()
+{
+}
+
+// ============================================================================
+void P256Field::fromMpz(Element& result, const mpz_t& value) const
+{
+  setZero(result);
+
+  if ( mpz_sgn(value) < 0 || mpz_sizeinbase(value, 2) > 64 * NUM_LIMBS )
+  {
+    /// Out of range values are rare, so take the slow path.
+    mpz_t reduced;
+    mpz_init(reduced);
+    toMpz  (reduced, prime);
+    mpz_mod(reduced, value, reduced);
+    mpz_export(result.limbs, nullptr, -1, sizeof(uint64_t), 0, 0, reduced);
+    mpz_clear(reduced);
+    return;
+  }
+
+  mpz_export(result.limbs, nullptr, -1, sizeof(uint64_t), 0, 0, value);
+
+  /// value < 2^256 < 2p, so a single subtraction suffices.
+  conditionalSubtractPrime(result, 0);
+}
+
+// ============================================================================
+void P256Field::toMpz(mpz_t result, const Element& value) const
+{
+  mpz_import(result, NUM_LIMBS, -1, sizeof(uint64_t), 0, 0, value.limbs);
+}
+
+// ============================================================================
+void P256Field::reduce(Element& result, const uint64_t product[2 * NUM_LIMBS])
+{
+  __extension__ typedef __int128 int128_t;
+
+  /// Split the product into sixteen 32-bit words, c0 ... c15.
+  int64_t c[4 * NUM_LIMBS];
+  for ( unsigned int i = 0; i < 2 * NUM_LIMBS; ++i )
+  {
+    c[2 * i]     = static_cast<int64_t>(product[i] & 0xffffffffull);
+    c[2 * i + 1] = static_cast<int64_t>(product[i] >> 32);
+  }
+
+  /** T = s1 + 2s2 + 2s3 + s4 + s5 - s6 - s7 - s8 - s9, computed one 32-bit 
+      word at a time. Each word fits comfortably in a signed 64-bit integer.
+  */
+  int64_t t[2 * NUM_LIMBS];
+  t[0] = c[0] + c[8]  + c[9]  - c[11] - c[12] - c[13] - c[14];
+  t[1] = c[1] + c[9]  + c[10] - c[12] - c[13] - c[14] - c[15];
+  t[2] = c[2] + c[10] + c[11] - c[13] - c[14] - c[15];
+  t[3] = c[3] + 2 * c[11] + 2 * c[12] + c[13] - c[15] - c[8]  - c[9];
+  t[4] = c[4] + 2 * c[12] + 2 * c[13] + c[14] - c[9]  - c[10];
+  t[5] = c[5] + 2 * c[13] + 2 * c[14] + c[15] - c[10] - c[11];
+  t[6] = c[6] + 3 * c[14] + 2 * c[15] + c[13] - c[8]  - c[9];
+  t[7] = c[7] + 3 * c[15] + c[8] - c[10] - c[11] - c[12] - c[13];
+
+  /// Recombine the words into 64-bit limbs, with signed headroom for carries.
+  int128_t limb0 = t[0] + ( static_cast<int128_t>(t[1]) << 32 );
+  int128_t limb1 = t[2] + ( static_cast<int128_t>(t[3]) << 32 );
+  int128_t limb2 = t[4] + ( static_cast<int128_t>(t[5]) << 32 );
+  int128_t limb3 = t[6] + ( static_cast<int128_t>(t[7]) << 32 );
+
+  /** Propagate carries, then fold the carry out of the top limb back in 
+      using 2^256 = 2^224 - 2^192 - 2^96 + 1 mod p. The first fold leaves a
+      carry of at most one in magnitude, and the second clears it.
+  */
+  const int128_t mask  = 0xffffffffffffffffull;
+  int64_t        carry = 0;
+  for ( unsigned int fold = 0; fold < 3; ++fold )
+  {
+    limb0 += carry;
+    limb1 -= static_cast<int128_t>(carry) << 32;
+    limb3 += ( static_cast<int128_t>(carry) << 32 ) - carry;
+
+    limb1 += limb0 >> 64;
+    limb0 &= mask;
+    limb2 += limb1 >> 64;
+    limb1 &= mask;
+    limb3 += limb2 >> 64;
+    limb2 &= mask;
+    carry  = static_cast<int64_t>(limb3 >> 64);
+    limb3 &= mask;
+  }
+
+  result.limbs[0] = static_cast<uint64_t>(limb0);
+  result.limbs[1] = static_cast<uint64_t>(limb1);
+  result.limbs[2] = static_cast<uint64_t>(limb2);
+  result.limbs[3] = static_cast<uint64_t>(limb3);
+
+  /// The result is now in [0, 2^256), which is less than 2p.
+  conditionalSubtractPrime(result, 0);
+}
+
+// ============================================================================
+void P256Field::invert(Element& result, const Element& value) const
+{
+  /// x_k = value^(2^k - 1)
+  Element x_2;
+  Element x_3;
+  Element x_6;
+  Element x_12;
+  Element x_15;
+  Element x_30;
+  Element x_32;
+  sqrRepeated(x_2,  value, 1u);   mul(x_2,  x_2,  value);
+  sqrRepeated(x_3,  x_2,   1u);   mul(x_3,  x_3,  value);
+  sqrRepeated(x_6,  x_3,   3u);   mul(x_6,  x_6,  x_3);
+  sqrRepeated(x_12, x_6,   6u);   mul(x_12, x_12, x_6);
+  sqrRepeated(x_15, x_12,  3u);   mul(x_15, x_15, x_3);
+  sqrRepeated(x_30, x_15,  15u);  mul(x_30, x_30, x_15);
+  sqrRepeated(x_32, x_30,  2u);   mul(x_32, x_32, x_2);
+
+  /** p - 2, in 32-bit words, is 
+      ffffffff 00000001 00000000 00000000 00000000 ffffffff ffffffff fffffffd.
+  */
+  Element accumulator;
+  sqrRepeated(accumulator, x_32,        32u);   mul(accumulator, accumulator, value);
+  sqrRepeated(accumulator, accumulator, 128u);  mul(accumulator, accumulator, x_32);
+  sqrRepeated(accumulator, accumulator, 32u);   mul(accumulator, accumulator, x_32);
+  sqrRepeated(accumulator, accumulator, 30u);   mul(accumulator, accumulator, x_30);
+  sqrRepeated(accumulator, accumulator, 2u);    mul(result,      accumulator, value);
+}
+
+// ============================================================================
+void P256Field::invertVariableTime(Element& result, const Element& value) const
+{
+  static_assert(sizeof(mp_limb_t) == sizeof(uint64_t), 
+                "P256Field::invertVariableTime() requires 64-bit GMP limbs.");
+
+  /** Every integer lives on the stack. mpz_invert() adds p to a negative
+      cofactor, so the inverse has room for one limb more than p.
+  */
+  mp_limb_t inverse_limbs[NUM_LIMBS + 1];
+  mpz_t     inverse;
+  inverse->_mp_alloc = NUM_LIMBS + 1;
+  inverse->_mp_size  = 0;
+  inverse->_mp_d     = inverse_limbs;
+
+  mpz_t p;
+  mpz_t input;
+  mpz_roinit_n(p,     reinterpret_cast<const mp_limb_t*>(prime.limbs), NUM_LIMBS);
+  mpz_roinit_n(input, reinterpret_cast<const mp_limb_t*>(value.limbs), NUM_LIMBS);
+
+  /// input reads value's limbs in place, so result is only written after.
+  const bool invertible = mpz_invert(inverse, input, p) != 0;
+
+  setZero(result);
+  if ( invertible )
+  {
+    std::copy(inverse_limbs, inverse_limbs + mpz_size(inverse), result.limbs);
+  }
+}
+
+// ============================================================================
+bool P256Field::squareRoot(Element& result, const Element& value) const
+{
+  /// x_k = value^(2^k - 1), doubling k at each step.
+  Element x_k;
+  Element shifted;
+  x_k = value;
+  for ( unsigned int k = 1; k < 32u; k *= 2 )
+  {
+    sqrRepeated(shifted, x_k, k);
+    mul        (x_k,     shifted, x_k);
+  }
+
+  /// value^((2^32 - 1) * 2^32 + 1)
+  Element root;
+  sqrRepeated(root, x_k, 32u);
+  mul        (root, root, value);
+
+  /// value^(((2^32 - 1) * 2^32 + 1) * 2^96 + 1)
+  sqrRepeated(root, root, 96u);
+  mul        (root, root, value);
+
+  /// value^((2^32 - 1) * 2^222 + 2^190 + 2^94)
+  sqrRepeated(root, root, 94u);
+
+  Element difference;
+  sqr(difference, root);
+  sub(difference, difference, value);
+
+  result = root;
+  return isZero(difference);
+}
@@ -0,0 +1,449 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+#ifndef P256_FIELD_HPP
+#define P256_FIELD_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include <gmp.h>
+
+#include "CurveTraits.hpp"
+
+/** Dedicated prime field arithmetic for curve P-256, where 
+    p = 2^256 - 2^224 + 2^192 + 2^96 - 1. Elements are stored on the stack as
+    four 64-bit limbs (least significant first) and are always kept in 
+    [0, p). Products are reduced with the NIST fast reduction (a Solinas 
+    reduction) instead of a generic division, and every operation runs on a 
+    fixed number of limbs without touching the heap.
+    @cite Appendix D.2.3 of https://nvlpubs.nist.gov/nistpubs/FIPS/NIST.FIPS.186-4.pdf
+*/
+class P256Field
+{
+public:
+
+  /// @brief The number of 64-bit limbs in a field element.
+  static const unsigned int NUM_LIMBS = CurveTraits<Curves::P256>::NUM_LIMBS;
+
+  /// @brief A field element, stored as little-endian 64-bit limbs.
+  struct Element
+  {
+    uint64_t limbs[NUM_LIMBS];
+  };
+
+  /** Construct a new field. The parameters are only validated - they must 
+      describe curve P-256.
+      @param p_in The prime modulus of the field. Must be the P-256 prime.
+      @param a_in The curve's a parameter. Must be -3 mod p.
+      @throw std::invalid_argument if the parameters are not those of P-256.
+   */
+  P256Field(const mpz_t& p_in, const mpz_t& a_in);
+
+  /// @brief The destructor does nothing.
+  ~P256Field();
+
+  /** Load an integer into the field, reducing it modulo p.
+      @param result The element to place the reduced value into.
+      @param value The integer to load.
+   */
+  void fromMpz(Element& result, const mpz_t& value) const;
+
+  /** Store a field element as an integer in [0, p).
+      @param result The integer to place the value into.
+      @param value The element to store.
+   */
+  void toMpz(mpz_t result, const Element& value) const;
+
+  /// @brief result = 0
+  void setZero(Element& result) const;
+
+  /// @brief result = 1
+  void setOne(Element& result) const;
+
+  /// @brief result = lhs + rhs mod p
+  void add(Element& result, const Element& lhs, const Element& rhs) const;
+
+  /// @brief result = lhs - rhs mod p
+  void sub(Element& result, const Element& lhs, const Element& rhs) const;
+
+  /// @brief result = lhs * rhs mod p
+  void mul(Element& result, const Element& lhs, const Element& rhs) const;
+
+  /// @brief result = value^2 mod p
+  void sqr(Element& result, const Element& value) const;
+
+  /// @brief result = -value mod p
+  void neg(Element& result, const Element& value) const;
+
+  /** result = value^-1 mod p, computed as value^(p - 2) by Fermat's little 
+      theorem. The inverse of zero is zero. The exponent is computed with a 
+      fixed addition chain of 255 squarings and 12 multiplications, so the 
+      running time does not depend on value.
+  */
+  void invert(Element& result, const Element& value) const;
+
+  /** result = value^-1 mod p, computed with mpz_invert()'s extended GCD. Much
+      faster than invert(), but its running time depends on value, so it must
+      only be used on public values. The inverse of zero is zero.
+  */
+  void invertVariableTime(Element& result, const Element& value) const;
+
+  /** result = value^((p + 1) / 4) mod p. As p = 3 mod 4, this is a square 
+      root of value whenever one exists. The exponent, 
+      (2^32 - 1) * 2^222 + 2^190 + 2^94, is computed with a fixed addition 
+      chain of 253 squarings and 7 multiplications.
+      @param result The element to place the root into.
+      @param value The element to take the square root of.
+      @return True if value is a square, i.e. result^2 == value.
+  */
+  bool squareRoot(Element& result, const Element& value) const;
+
+  /** result = value if condition is 1, otherwise result is left unchanged. 
+      Runs without branching on, or indexing by, condition.
+      @param result The element to conditionally overwrite.
+      @param value The element to copy.
+      @param condition Either 0 or 1.
+   */
+  void conditionalMove(Element&       result, 
+                       const Element& value, 
+                       unsigned int   condition) const;
+
+  /// @brief Test if value == 0.
+  bool isZero(const Element& value) const;
+
+  /// @brief Test if value == 1.
+  bool isOne(const Element& value) const;
+
+  /** Accessor for the memory held by a single field element.
+      @return The size of an element, in bytes.
+   */
+  std::size_t getElementBytes() const;
+
+  /** Accessor for the curve's a parameter (-3) as a field element.
+      @return Const-reference to a.
+   */
+  const Element& getA() const;
+
+private:
+
+  /// @brief The prime modulus, p.
+  static const Element prime;
+
+  /// @brief The curve's a parameter, p - 3.
+  static const Element a;
+
+  /** Reduce a 512-bit product modulo p with the NIST fast reduction.
+      @param result The element to place the reduced value into.
+      @param product The product to reduce, as eight little-endian limbs.
+   */
+  static void reduce(Element& result, const uint64_t product[2 * NUM_LIMBS]);
+
+  /** Compute accumulator + lhs * rhs + carry, placing the low limb into 
+      accumulator and the high limb into carry.
+  */
+  static void multiplyAccumulate(uint64_t& accumulator, 
+                                 uint64_t& carry,
+                                 uint64_t  lhs, 
+                                 uint64_t  rhs);
+
+  /** Subtract p from value if value >= p, without branching.
+      @param value The element to conditionally reduce. 
+      @param carry Any carry out of the top limb of value.
+  */
+  static void conditionalSubtractPrime(Element& value, uint64_t carry);
+
+  /** result = value^(2^count), by squaring count times. result may alias 
+      value.
+  */
+  void sqrRepeated(Element&       result, 
+                   const Element& value, 
+                   unsigned int   count) const;
+};
+
+// ============================================================================
+inline void P256Field::setZero(Element& result) const
+{
+  result.limbs[0] = result.limbs[1] = result.limbs[2] = result.limbs[3] = 0;
+}
+
+// ============================================================================
+inline void P256Field::setOne(Element& result) const
+{
+  result.limbs[0] = 1;
+  result.limbs[1] = result.limbs[2] = result.limbs[3] = 0;
+}
+
+// ============================================================================
+inline void P256Field::conditionalMove(Element&       result, 
+                                       const Element& value, 
+                                       unsigned int   condition) const
+{
+  const uint64_t mask = 0 - static_cast<uint64_t>(condition & 1u);
+
+  for ( unsigned int i = 0; i < NUM_LIMBS; ++i )
+  {
+    result.limbs[i] ^= ( result.limbs[i] ^ value.limbs[i] ) & mask;
+  }
+}
+
+// ============================================================================
+inline bool P256Field::isZero(const Element& value) const
+{
+  return ( value.limbs[0] | value.limbs[1] | 
+           value.limbs[2] | value.limbs[3] ) == 0;
+}
+
+// ============================================================================
+inline bool P256Field::isOne(const Element& value) const
+{
+  return ( ( value.limbs[0] ^ 1 ) | value.limbs[1] | 
+             value.limbs[2]       | value.limbs[3] ) == 0;
+}
+
+// ============================================================================
+inline const P256Field::Element& P256Field::getA() const
+{
+  return a;
+}
+
+// ============================================================================
+inline std::size_t P256Field::getElementBytes() const
+{
+  return sizeof(Element);
+}
+
+// ============================================================================
+inline void P256Field::neg(Element& result, const Element& value) const
+{
+  Element zero;
+  setZero(zero);
+  sub(result, zero, value);
+}
+
+// ============================================================================
+inline void P256Field::multiplyAccumulate(uint64_t& accumulator, 
+                                          uint64_t& carry,
+                                          uint64_t  lhs, 
+                                          uint64_t  rhs)
+{
+  __extension__ typedef unsigned __int128 uint128_t;
+
+  const uint128_t t = static_cast<uint128_t>(lhs) * rhs + accumulator + carry;
+  accumulator = static_cast<uint64_t>(t);
+  carry       = static_cast<uint64_t>(t >> 64);
+}
+
+// ============================================================================
+inline void 
+P256Field::mul(Element& result, const Element& lhs, const Element& rhs) const
+{
+  const uint64_t* a = lhs.limbs;
+  const uint64_t* b = rhs.limbs;
+  uint64_t        product[2 * NUM_LIMBS] = {0, 0, 0, 0, 0, 0, 0, 0};
+  uint64_t        carry;
+
+  /// Schoolbook multiplication into a 512-bit product, one row per limb.
+  carry = 0;
+  multiplyAccumulate(product[0], carry, a[0], b[0]);
+  multiplyAccumulate(product[1], carry, a[0], b[1]);
+  multiplyAccumulate(product[2], carry, a[0], b[2]);
+  multiplyAccumulate(product[3], carry, a[0], b[3]);
+  product[4] = carry;
+
+  carry = 0;
+  multiplyAccumulate(product[1], carry, a[1], b[0]);
+  multiplyAccumulate(product[2], carry, a[1], b[1]);
+  multiplyAccumulate(product[3], carry, a[1], b[2]);
+  multiplyAccumulate(product[4], carry, a[1], b[3]);
+  product[5] = carry;
+
+  carry = 0;
+  multiplyAccumulate(product[2], carry, a[2], b[0]);
+  multiplyAccumulate(product[3], carry, a[2], b[1]);
+  multiplyAccumulate(product[4], carry, a[2], b[2]);
+  multiplyAccumulate(product[5], carry, a[2], b[3]);
+  product[6] = carry;
+
+  carry = 0;
+  multiplyAccumulate(product[3], carry, a[3], b[0]);
+  multiplyAccumulate(product[4], carry, a[3], b[1]);
+  multiplyAccumulate(product[5], carry, a[3], b[2]);
+  multiplyAccumulate(product[6], carry, a[3], b[3]);
+  product[7] = carry;
+
+  reduce(result, product);
+}
+
+// ============================================================================
+inline void P256Field::sqr(Element& result, const Element& value) const
+{
+  __extension__ typedef unsigned __int128 uint128_t;
+
+  const uint64_t* a = value.limbs;
+  uint64_t        product[2 * NUM_LIMBS] = {0, 0, 0, 0, 0, 0, 0, 0};
+  uint64_t        carry;
+
+  /// The off-diagonal products a[i] * a[j], i < j, are computed once...
+  carry = 0;
+  multiplyAccumulate(product[1], carry, a[0], a[1]);
+  multiplyAccumulate(product[2], carry, a[0], a[2]);
+  multiplyAccumulate(product[3], carry, a[0], a[3]);
+  product[4] = carry;
+
+  carry = 0;
+  multiplyAccumulate(product[3], carry, a[1], a[2]);
+  multiplyAccumulate(product[4], carry, a[1], a[3]);
+  product[5] = carry;
+
+  carry = 0;
+  multiplyAccumulate(product[5], carry, a[2], a[3]);
+  product[6] = carry;
+
+  /// ...then doubled...
+  product[7] =   product[6] >> 63;
+  product[6] = ( product[6] << 1 ) | ( product[5] >> 63 );
+  product[5] = ( product[5] << 1 ) | ( product[4] >> 63 );
+  product[4] = ( product[4] << 1 ) | ( product[3] >> 63 );
+  product[3] = ( product[3] << 1 ) | ( product[2] >> 63 );
+  product[2] = ( product[2] << 1 ) | ( product[1] >> 63 );
+  product[1] =   product[1] << 1;
+
+  /// ...and the squares a[i]^2 are added along the diagonal.
+  uint128_t square;
+  uint128_t t;
+  square     = static_cast<uint128_t>(a[0]) * a[0];
+  t          = static_cast<uint128_t>(product[0]) + static_cast<uint64_t>(square);
+  product[0] = static_cast<uint64_t>(t);
+  t          = static_cast<uint128_t>(product[1]) + 
+               static_cast<uint64_t>(square >> 64) + ( t >> 64 );
+  product[1] = static_cast<uint64_t>(t);
+
+  square     = static_cast<uint128_t>(a[1]) * a[1];
+  t          = static_cast<uint128_t>(product[2]) + 
+               static_cast<uint64_t>(square) + ( t >> 64 );
+  product[2] = static_cast<uint64_t>(t);
+  t          = static_cast<uint128_t>(product[3]) + 
+               static_cast<uint64_t>(square >> 64) + ( t >> 64 );
+  product[3] = static_cast<uint64_t>(t);
+
+  square     = static_cast<uint128_t>(a[2]) * a[2];
+  t          = static_cast<uint128_t>(product[4]) + 
+               static_cast<uint64_t>(square) + ( t >> 64 );
+  product[4] = static_cast<uint64_t>(t);
+  t          = static_cast<uint128_t>(product[5]) + 
+               static_cast<uint64_t>(square >> 64) + ( t >> 64 );
+  product[5] = static_cast<uint64_t>(t);
+
+  square     = static_cast<uint128_t>(a[3]) * a[3];
+  t          = static_cast<uint128_t>(product[6]) + 
+               static_cast<uint64_t>(square) + ( t >> 64 );
+  product[6] = static_cast<uint64_t>(t);
+  t          = static_cast<uint128_t>(product[7]) + 
+               static_cast<uint64_t>(square >> 64) + ( t >> 64 );
+  product[7] = static_cast<uint64_t>(t);
+
+  reduce(result, product);
+}
+
+// ============================================================================
+inline void P256Field::sqrRepeated(Element&       result, 
+                                   const Element& value, 
+                                   unsigned int   count) const
+{
+  result = value;
+  for ( unsigned int i = 0; i < count; ++i )
+  {
+    sqr(result, result);
+  }
+}
+
+// ============================================================================
+inline void 
+P256Field::add(Element& result, const Element& lhs, const Element& rhs) const
+{
+  __extension__ typedef unsigned __int128 uint128_t;
+
+  uint128_t t;
+  t = static_cast<uint128_t>(lhs.limbs[0]) + rhs.limbs[0];
+  result.limbs[0] = static_cast<uint64_t>(t);
+  t = static_cast<uint128_t>(lhs.limbs[1]) + rhs.limbs[1] + ( t >> 64 );
+  result.limbs[1] = static_cast<uint64_t>(t);
+  t = static_cast<uint128_t>(lhs.limbs[2]) + rhs.limbs[2] + ( t >> 64 );
+  result.limbs[2] = static_cast<uint64_t>(t);
+  t = static_cast<uint128_t>(lhs.limbs[3]) + rhs.limbs[3] + ( t >> 64 );
+  result.limbs[3] = static_cast<uint64_t>(t);
+
+  conditionalSubtractPrime(result, static_cast<uint64_t>(t >> 64));
+}
+
+// ============================================================================
+inline void 
+P256Field::sub(Element& result, const Element& lhs, const Element& rhs) const
+{
+  __extension__ typedef unsigned __int128 uint128_t;
+
+  uint128_t t;
+  t = static_cast<uint128_t>(lhs.limbs[0]) - rhs.limbs[0];
+  result.limbs[0] = static_cast<uint64_t>(t);
+  t = static_cast<uint128_t>(lhs.limbs[1]) - rhs.limbs[1] - ( ( t >> 64 ) & 1 );
+  result.limbs[1] = static_cast<uint64_t>(t);
+  t = static_cast<uint128_t>(lhs.limbs[2]) - rhs.limbs[2] - ( ( t >> 64 ) & 1 );
+  result.limbs[2] = static_cast<uint64_t>(t);
+  t = static_cast<uint128_t>(lhs.limbs[3]) - rhs.limbs[3] - ( ( t >> 64 ) & 1 );
+  result.limbs[3] = static_cast<uint64_t>(t);
+
+  /// Add p back if the subtraction borrowed.
+  const uint64_t mask = 0 - static_cast<uint64_t>( ( t >> 64 ) & 1 );
+  t = static_cast<uint128_t>(result.limbs[0]) + ( prime.limbs[0] & mask );
+  result.limbs[0] = static_cast<uint64_t>(t);
+  t = static_cast<uint128_t>(result.limbs[1]) + ( prime.limbs[1] & mask ) 
+    + ( t >> 64 );
+  result.limbs[1] = static_cast<uint64_t>(t);
+  t = static_cast<uint128_t>(result.limbs[2]) + ( prime.limbs[2] & mask ) 
+    + ( t >> 64 );
+  result.limbs[2] = static_cast<uint64_t>(t);
+  t = static_cast<uint128_t>(result.limbs[3]) + ( prime.limbs[3] & mask ) 
+    + ( t >> 64 );
+  result.limbs[3] = static_cast<uint64_t>(t);
+}
+
+// ============================================================================
+inline void P256Field::conditionalSubtractPrime(Element& value, uint64_t carry)
+{
+  __extension__ typedef unsigned __int128 uint128_t;
+
+  uint64_t  difference[NUM_LIMBS];
+  uint128_t t;
+  t = static_cast<uint128_t>(value.limbs[0]) - prime.limbs[0];
+  difference[0] = static_cast<uint64_t>(t);
+  t = static_cast<uint128_t>(value.limbs[1]) - prime.limbs[1] 
+    - ( ( t >> 64 ) & 1 );
+  difference[1] = static_cast<uint64_t>(t);
+  t = static_cast<uint128_t>(value.limbs[2]) - prime.limbs[2] 
+    - ( ( t >> 64 ) & 1 );
+  difference[2] = static_cast<uint64_t>(t);
+  t = static_cast<uint128_t>(value.limbs[3]) - prime.limbs[3] 
+    - ( ( t >> 64 ) & 1 );
+  difference[3] = static_cast<uint64_t>(t);
+
+  /// Keep the difference if value + carry * 2^256 >= p.
+  const uint64_t borrow = static_cast<uint64_t>( t >> 64 ) & 1;
+  const uint64_t mask   = 0 - ( carry | ( borrow ^ 1 ) );
+  value.limbs[0] = ( difference[0] & mask ) | ( value.limbs[0] & ~mask );
+  value.limbs[1] = ( difference[1] & mask ) | ( value.limbs[1] & ~mask );
+  value.limbs[2] = ( difference[2] & mask ) | ( value.limbs[2] & ~mask );
+  value.limbs[3] = ( difference[3] & mask ) | ( value.limbs[3] & ~mask );
+}
+
+#endif
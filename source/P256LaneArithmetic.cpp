@@ -0,0 +1,436 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+
+#include "P256LaneArithmetic.hpp"
+
+#include <algorithm>
+#include <limits>
+
+// ============================================================================
+P256LaneArithmetic::P256LaneArithmetic(const mpz_t& p, 
+                                       const mpz_t& a, 
+                                       const mpz_t& b_in, 
+                                       bool         allow_ifma)
+  : P256Arithmetic(p, a, b_in),
+    lanes (allow_ifma),
+    lane_b()
+{
+  lanes.broadcast(lane_b, b);
+}
+
+// ============================================================================
+P256LaneArithmetic::~P256LaneArithmetic()
+{
+}
+
+// ============================================================================
+std::vector<EllipticCurve::Point> 
+P256LaneArithmetic::batchMultiScalarMultiplication(
+  const std::vector<std::vector<EllipticCurve::MultiplicationTerm>>& batch) const
+{
+  const unsigned int w         = CONSTANT_TIME_WINDOW_BITS;
+  const unsigned int num_lanes = P256LaneField::NUM_LANES;
+
+  bool        use_lanes   = lanes.usesIfma();
+  std::size_t scalar_bits = field_bits;
+
+  for ( std::size_t i = 0; i < batch.size() && use_lanes; ++i )
+  {
+    use_lanes = !batch[i].empty() && batch[i].size() == batch[0].size();
+
+    for ( const EllipticCurve::MultiplicationTerm& term : batch[i] )
+    {
+      scalar_bits = std::max<std::size_t>(scalar_bits, 
+                                          mpz_sizeinbase(term.scalar, 2));
+    }
+  }
+
+  /// Scalars too long for recodeRegular() take the single-lane path.
+  if ( !use_lanes || scalar_bits > MAX_REGULAR_DIGITS * w )
+  {
+    return P256Arithmetic::batchMultiScalarMultiplication(batch);
+  }
+
+  /// Every lane of every group runs the same number of windows.
+  const std::size_t          num_digits = ( scalar_bits + w - 1 ) / w;
+  std::vector<JacobianPoint> sums(batch.size());
+  Workspace                  workspace;
+
+  for ( std::size_t first = 0; first < batch.size(); first += num_lanes )
+  {
+    const std::size_t count = std::min<std::size_t>(num_lanes, 
+                                                    batch.size() - first);
+
+    unsigned int scalar_cost = 0;
+    for ( std::size_t i = first; i < first + count; ++i )
+    {
+      for ( const EllipticCurve::MultiplicationTerm& term : batch[i] )
+      {
+        scalar_cost += ( term.table != nullptr ) ? COMB_TERM_COST 
+                                                 : WINDOWED_TERM_COST;
+      }
+    }
+
+    if ( scalar_cost < LANE_TERM_COST * batch[first].size() )
+    {
+      for ( std::size_t i = first; i < first + count; ++i )
+      {
+        sumMultiples(sums[i], batch[i], workspace);
+      }
+      continue;
+    }
+
+    /// Spare lanes repeat the first entry of the group.
+    const Terms*  entries[P256LaneField::NUM_LANES];
+    JacobianPoint results[P256LaneField::NUM_LANES];
+
+    for ( unsigned int lane = 0; lane < num_lanes; ++lane )
+    {
+      entries[lane] = &batch[first + ( ( lane < count ) ? lane : 0 )];
+    }
+
+    multiplyLanes(results, entries, num_digits);
+    std::copy(results, results + count, sums.begin() + first);
+  }
+
+  /// One inversion normalizes every sum, so toAffine() needs no more.
+  normalize(sums);
+
+  std::vector<EllipticCurve::Point> points;
+  points.reserve(sums.size());
+  for ( const JacobianPoint& sum : sums )
+  {
+    points.push_back(toAffine(sum));
+  }
+
+  return points;
+}
+
+// ============================================================================
+void 
+P256LaneArithmetic::multiplyLanes(JacobianPoint      results[P256LaneField::NUM_LANES], 
+                                  const Terms* const entries[P256LaneField::NUM_LANES], 
+                                  std::size_t        num_digits) const
+{
+  const unsigned int w         = CONSTANT_TIME_WINDOW_BITS;
+  const unsigned int num_lanes = P256LaneField::NUM_LANES;
+  const std::size_t  num_terms = entries[0]->size();
+
+  /** Per term: the digits of each lane, the lanes whose scalar was even, and
+      the odd multiples (2j + 1)P of each lane's point.
+  */
+  std::vector<int>                              digits(num_terms * num_lanes * 
+                                                       MAX_REGULAR_DIGITS);
+  std::vector<P256LaneField::Mask>              even  (num_terms);
+  std::vector<std::vector<ProjectiveLanePoint>> tables(num_terms);
+
+  for ( std::size_t t = 0; t < num_terms; ++t )
+  {
+    JacobianLanePoint P;
+
+    for ( unsigned int lane = 0; lane < num_lanes; ++lane )
+    {
+      const EllipticCurve::MultiplicationTerm& term = ( *entries[lane] )[t];
+
+      /// The sign of the scalar is folded into P.
+      JacobianPoint P_lane;
+      toJacobian(P_lane, *term.point);
+      if ( mpz_sgn(term.scalar) < 0 )
+      {
+        field.neg(P_lane.Y, P_lane.Y);
+      }
+
+      lanes.setLane(P.X, lane, P_lane.X);
+      lanes.setLane(P.Y, lane, P_lane.Y);
+      lanes.setLane(P.Z, lane, P_lane.Z);
+
+      const unsigned int is_even = 
+        recodeRegular(&digits[( t * num_lanes + lane ) * MAX_REGULAR_DIGITS], 
+                      term.scalar, 
+                      num_digits);
+      even[t].lanes[lane] = 0 - static_cast<uint64_t>(is_even);
+    }
+
+    JacobianLanePoint   P_doubled;
+    ProjectiveLanePoint P_doubled_projective;
+    pointDoubling(P_doubled,            P);
+    toProjective (P_doubled_projective, P_doubled);
+
+    tables[t].resize(std::size_t(1) << ( w - 1 ));
+    toProjective(tables[t][0], P);
+    for ( std::size_t j = 1; j < tables[t].size(); ++j )
+    {
+      completeAddition(tables[t][j], tables[t][j - 1], P_doubled_projective);
+    }
+  }
+
+  /// The same ladder as constantTimeScalarMultiplication(), over every term.
+  int                 window[P256LaneField::NUM_LANES];
+  JacobianLanePoint   R;
+  ProjectiveLanePoint R_projective;
+  ProjectiveLanePoint T;
+
+  for ( std::size_t t = 0; t < num_terms; ++t )
+  {
+    for ( unsigned int lane = 0; lane < num_lanes; ++lane )
+    {
+      window[lane] = 
+        digits[( t * num_lanes + lane ) * MAX_REGULAR_DIGITS + num_digits - 1];
+    }
+
+    selectMultiple(T, window, tables[t]);
+    if ( t == 0 )
+    {
+      R_projective = T;
+    }
+    else
+    {
+      completeAddition(R_projective, R_projective, T);
+    }
+  }
+
+  for ( std::size_t i = num_digits - 1; i-- > 0; )
+  {
+    fromProjective(R, R_projective);
+    for ( unsigned int j = 0; j < w; ++j )
+    {
+      pointDoubling(R, R);
+    }
+    toProjective(R_projective, R);
+
+    for ( std::size_t t = 0; t < num_terms; ++t )
+    {
+      for ( unsigned int lane = 0; lane < num_lanes; ++lane )
+      {
+        window[lane] = digits[( t * num_lanes + lane ) * MAX_REGULAR_DIGITS + i];
+      }
+
+      selectMultiple  (T,            window,       tables[t]);
+      completeAddition(R_projective, R_projective, T);
+    }
+  }
+
+  /// Add -P in the lanes whose scalar was even, and infinity in the others.
+  for ( std::size_t t = 0; t < num_terms; ++t )
+  {
+    ProjectiveLanePoint correction;
+    lanes.setZero(correction.X);
+    lanes.setOne (correction.Y);
+    lanes.setZero(correction.Z);
+
+    T = tables[t][0];
+    lanes.neg            (T.Y,          T.Y);
+    lanes.conditionalMove(correction.X, T.X, even[t]);
+    lanes.conditionalMove(correction.Y, T.Y, even[t]);
+    lanes.conditionalMove(correction.Z, T.Z, even[t]);
+
+    completeAddition(R_projective, R_projective, correction);
+  }
+
+  fromProjective(R, R_projective);
+  sodium_memzero(digits.data(), digits.size() * sizeof(int));
+  sodium_memzero(window,        sizeof(window));
+
+  for ( unsigned int lane = 0; lane < num_lanes; ++lane )
+  {
+    lanes.getLane(results[lane].X, R.X, lane);
+    lanes.getLane(results[lane].Y, R.Y, lane);
+    lanes.getLane(results[lane].Z, R.Z, lane);
+  }
+}
+
+// ============================================================================
+void P256LaneArithmetic::toProjective(ProjectiveLanePoint&     result, 
+                                      const JacobianLanePoint& P) const
+{
+  /// (X / Z^2, Y / Z^3) = (XZ / Z^3, Y / Z^3). Infinity becomes (0 : Y : 0).
+  lanes.sqr(result.Z, P.Z);
+  lanes.mul(result.Z, result.Z, P.Z);
+  lanes.mul(result.X, P.X,      P.Z);
+  result.Y = P.Y;
+}
+
+// ============================================================================
+void P256LaneArithmetic::fromProjective(JacobianLanePoint&         result, 
+                                        const ProjectiveLanePoint& P) const
+{
+  P256LaneField::Mask at_infinity;
+  lanes.isZero(at_infinity, P.Z);
+
+  LaneElement z_squared;
+  LaneElement one;
+
+  /// (X / Z, Y / Z) = (XZ / Z^2, YZ^2 / Z^3).
+  lanes.sqr(z_squared, P.Z);
+  lanes.mul(result.X,  P.X, P.Z);
+  lanes.mul(result.Y,  P.Y, z_squared);
+  result.Z = P.Z;
+
+  /// Infinity would map to (0, 0, 0), so replace it with (1, 1, 0).
+  lanes.setOne         (one);
+  lanes.conditionalMove(result.X, one, at_infinity);
+  lanes.conditionalMove(result.Y, one, at_infinity);
+}
+
+// ============================================================================
+void P256LaneArithmetic::
+selectMultiple(ProjectiveLanePoint&                    result, 
+               const int                               digits[P256LaneField::NUM_LANES], 
+               const std::vector<ProjectiveLanePoint>& table) const
+{
+  const unsigned int sign_bit  = std::numeric_limits<unsigned int>::digits - 1;
+  const unsigned int num_lanes = P256LaneField::NUM_LANES;
+
+  unsigned int        index[P256LaneField::NUM_LANES];
+  P256LaneField::Mask negative;
+
+  for ( unsigned int lane = 0; lane < num_lanes; ++lane )
+  {
+    const unsigned int digit     = static_cast<unsigned int>(digits[lane]);
+    const unsigned int sign      = digit >> sign_bit;
+    const unsigned int magnitude = ( digit ^ ( 0u - sign ) ) + sign;
+
+    index[lane]          = magnitude >> 1;
+    negative.lanes[lane] = 0 - static_cast<uint64_t>(sign);
+  }
+
+  result = table[0];
+  for ( unsigned int j = 1; j < table.size(); ++j )
+  {
+    /// The top bit of ~d & (d - 1) is set only when d == 0.
+    P256LaneField::Mask match;
+    for ( unsigned int lane = 0; lane < num_lanes; ++lane )
+    {
+      const unsigned int difference = index[lane] ^ j;
+      match.lanes[lane] = 0 - static_cast<uint64_t>(
+        ( ~difference & ( difference - 1u ) ) >> sign_bit);
+    }
+
+    lanes.conditionalMove(result.X, table[j].X, match);
+    lanes.conditionalMove(result.Y, table[j].Y, match);
+    lanes.conditionalMove(result.Z, table[j].Z, match);
+  }
+
+  LaneElement negated_y;
+  lanes.neg            (negated_y, result.Y);
+  lanes.conditionalMove(result.Y,  negated_y, negative);
+}
+
+// ============================================================================
+void P256LaneArithmetic::completeAddition(ProjectiveLanePoint&       result, 
+                                          const ProjectiveLanePoint& P, 
+                                          const ProjectiveLanePoint& Q) const
+{
+  LaneElement t0;
+  LaneElement t1;
+  LaneElement t2;
+  LaneElement t3;
+  LaneElement t4;
+  LaneElement X3;
+  LaneElement Y3;
+  LaneElement Z3;
+
+  lanes.mul(t0, P.X,    Q.X);
+  lanes.mul(t1, P.Y,    Q.Y);
+  lanes.mul(t2, P.Z,    Q.Z);
+  lanes.add(t3, P.X,    P.Y);
+  lanes.add(t4, Q.X,    Q.Y);
+  lanes.mul(t3, t3,     t4);
+  lanes.add(t4, t0,     t1);
+  lanes.sub(t3, t3,     t4);
+  lanes.add(t4, P.Y,    P.Z);
+  lanes.add(X3, Q.Y,    Q.Z);
+  lanes.mul(t4, t4,     X3);
+  lanes.add(X3, t1,     t2);
+  lanes.sub(t4, t4,     X3);
+  lanes.add(X3, P.X,    P.Z);
+  lanes.add(Y3, Q.X,    Q.Z);
+  lanes.mul(X3, X3,     Y3);
+  lanes.add(Y3, t0,     t2);
+  lanes.sub(Y3, X3,     Y3);
+  lanes.mul(Z3, lane_b, t2);
+  lanes.sub(X3, Y3,     Z3);
+  lanes.add(Z3, X3,     X3);
+  lanes.add(X3, X3,     Z3);
+  lanes.sub(Z3, t1,     X3);
+  lanes.add(X3, t1,     X3);
+  lanes.mul(Y3, lane_b, Y3);
+  lanes.add(t1, t2,     t2);
+  lanes.add(t2, t1,     t2);
+  lanes.sub(Y3, Y3,     t2);
+  lanes.sub(Y3, Y3,     t0);
+  lanes.add(t1, Y3,     Y3);
+  lanes.add(Y3, t1,     Y3);
+  lanes.add(t1, t0,     t0);
+  lanes.add(t0, t1,     t0);
+  lanes.sub(t0, t0,     t2);
+  lanes.mul(t1, t4,     Y3);
+  lanes.mul(t2, t0,     Y3);
+  lanes.mul(Y3, X3,     Z3);
+  lanes.add(Y3, Y3,     t2);
+  lanes.mul(X3, t3,     X3);
+  lanes.sub(X3, X3,     t1);
+  lanes.mul(Z3, t4,     Z3);
+  lanes.mul(t1, t3,     t0);
+  lanes.add(Z3, Z3,     t1);
+
+  result.X = X3;
+  result.Y = Y3;
+  result.Z = Z3;
+}
+
+// ============================================================================
+void P256LaneArithmetic::pointDoubling(JacobianLanePoint&       result, 
+                                       const JacobianLanePoint& P) const
+{
+  LaneElement delta;
+  LaneElement gamma;
+  LaneElement beta;
+  LaneElement alpha;
+  LaneElement t;
+  LaneElement u;
+
+  lanes.sqr(delta, P.Z);
+  lanes.sqr(gamma, P.Y);
+  lanes.mul(beta,  P.X, gamma);
+
+  /// alpha = 3(X - delta)(X + delta), which is 3X^2 + aZ^4 for a = -3.
+  lanes.sub(t,     P.X,   delta);
+  lanes.add(u,     P.X,   delta);
+  lanes.mul(alpha, t,     u);
+  lanes.add(t,     alpha, alpha);
+  lanes.add(alpha, t,     alpha);
+
+  /// Z3 = (Y + Z)^2 - gamma - delta = 2YZ
+  lanes.add(t,        P.Y,      P.Z);
+  lanes.sqr(t,        t);
+  lanes.sub(t,        t,        gamma);
+  lanes.sub(result.Z, t,        delta);
+
+  /// X3 = alpha^2 - 8 beta
+  lanes.add(beta,     beta,     beta);
+  lanes.add(beta,     beta,     beta);
+  lanes.sqr(t,        alpha);
+  lanes.add(u,        beta,     beta);
+  lanes.sub(result.X, t,        u);
+
+  /// Y3 = alpha(4 beta - X3) - 8 gamma^2
+  lanes.sqr(gamma,    gamma);
+  lanes.add(gamma,    gamma,    gamma);
+  lanes.add(gamma,    gamma,    gamma);
+  lanes.add(gamma,    gamma,    gamma);
+  lanes.sub(t,        beta,     result.X);
+  lanes.mul(t,        t,        alpha);
+  lanes.sub(result.Y, t,        gamma);
+}
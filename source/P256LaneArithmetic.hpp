@@ -0,0 +1,149 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+
+#ifndef P256_LANE_ARITHMETIC_HPP
+#define P256_LANE_ARITHMETIC_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "CurveArithmetic.hpp"
+#include "CurveTraits.hpp"
+#include "EllipticCurve.hpp"
+#include "P256Field.hpp"
+#include "P256LaneField.hpp"
+
+#include <gmp.h>
+
+/// @brief The scalar arithmetic for curve P-256, specialized by its traits.
+typedef JacobianArithmetic<P256Field, CurveTraits<Curves::P256>> P256Arithmetic;
+
+/** Point arithmetic for curve P-256 which runs the entries of a batched 
+    multi-scalar multiplication side by side, one entry per lane of a 
+    P256LaneField. Groups of up to NUM_LANES entries share one instruction 
+    stream: every lane follows the same regular ladder as 
+    constantTimeScalarMultiplication(), doubling in Jacobian coordinates and 
+    adding with the complete formulas, so the lanes never need to branch 
+    apart. 
+
+    The lanes only pay off when the field multiplication is vectorized, so 
+    everything else, including batches on CPUs without AVX-512 IFMA, is left 
+    to P256Arithmetic.
+*/
+class P256LaneArithmetic : public P256Arithmetic
+{
+public:
+
+  /** Construct the arithmetic for a curve.
+      @param p The curve's prime modulus. Must be the P-256 prime.
+      @param a The curve's a parameter. Must be -3 mod p.
+      @param b The curve's b parameter.
+      @param allow_ifma If false, batches never run in lanes.
+  */
+  P256LaneArithmetic(const mpz_t& p, 
+                     const mpz_t& a, 
+                     const mpz_t& b, 
+                     bool         allow_ifma = true);
+
+  /// @brief The destructor does nothing.
+  ~P256LaneArithmetic();
+
+  /** Runs the batch in groups of NUM_LANES entries when AVX-512 IFMA is 
+      available and every entry has the same number of terms. Precomputed 
+      tables are not used by the lanes, so a group which is mostly empty, or 
+      whose terms mostly have tables, is left to the scalar code.
+  */
+  std::vector<EllipticCurve::Point> batchMultiScalarMultiplication(
+    const std::vector<std::vector<EllipticCurve::MultiplicationTerm>>& batch) const;
+
+private:
+
+  /** Rough costs of a term, measured on P-256: in the scalar code with a 
+      comb table, in the scalar code without one, and in lanes, where every 
+      term costs the same for the whole group.
+  */
+  static const unsigned int COMB_TERM_COST     = 1u;
+  static const unsigned int WINDOWED_TERM_COST = 4u;
+  static const unsigned int LANE_TERM_COST     = 5u;
+
+  typedef P256LaneField::Element                      LaneElement;
+  typedef std::vector<EllipticCurve::MultiplicationTerm> Terms;
+
+  /// @brief One point in Jacobian coordinates per lane.
+  struct JacobianLanePoint
+  {
+    LaneElement X;
+    LaneElement Y;
+    LaneElement Z;
+  };
+
+  /// @brief One point in homogeneous projective coordinates per lane.
+  struct ProjectiveLanePoint
+  {
+    LaneElement X;
+    LaneElement Y;
+    LaneElement Z;
+  };
+
+  /// @brief The per-lane field.
+  P256LaneField lanes;
+
+  /// @brief The curve's b parameter, in every lane.
+  LaneElement lane_b;
+
+  /** Run one multi-scalar multiplication in each lane, in lockstep.
+      @param results The Jacobian sum of each lane's terms.
+      @param entries The terms of each lane. Every entry has the same number 
+      of terms.
+      @param num_digits The number of ladder digits, enough for every scalar.
+  */
+  void multiplyLanes(JacobianPoint      results[P256LaneField::NUM_LANES], 
+                     const Terms* const entries[P256LaneField::NUM_LANES], 
+                     std::size_t        num_digits) const;
+
+  /// @brief toProjective() in every lane.
+  void toProjective(ProjectiveLanePoint& result, const JacobianLanePoint& P) const;
+
+  /// @brief fromProjective() in every lane.
+  void fromProjective(JacobianLanePoint& result, const ProjectiveLanePoint& P) const;
+
+  /** selectMultiple() in every lane, with each lane's own digit.
+      @param result The point to place digits[lane] * P into, in each lane.
+      @param digits The odd digit of each lane.
+      @param table The odd multiples P, 3P, 5P, ... of each lane.
+  */
+  void selectMultiple(ProjectiveLanePoint&                    result, 
+                      const int                               digits[P256LaneField::NUM_LANES], 
+                      const std::vector<ProjectiveLanePoint>& table) const;
+
+  /// @brief completeAdditionMinusThree() in every lane. result may alias P or Q.
+  void completeAddition(ProjectiveLanePoint&       result, 
+                        const ProjectiveLanePoint& P, 
+                        const ProjectiveLanePoint& Q) const;
+
+  /** Point doubling in Jacobian coordinates for a = -3, in every lane. Like 
+      pointDoublingBranchFree(), there are no exceptional cases on a curve 
+      point. result may alias P.
+      @cite https://hyperelliptic.org/EFD/g1p/auto-shortw-jacobian-3.html#doubling-dbl-2001-b
+      @param result The point to place 2P into.
+      @param P The point to double.
+  */
+  void pointDoubling(JacobianLanePoint& result, const JacobianLanePoint& P) const;
+
+  /// Both copy assignment and copy constructors are deleted.
+  P256LaneArithmetic operator=(const P256LaneArithmetic& object) = delete;
+  P256LaneArithmetic          (const P256LaneArithmetic& object) = delete;
+};
+
+#endif
@@ -0,0 +1,528 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+
+#include "P256LaneField.hpp"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define P256_LANE_FIELD_IFMA 1
+#include <immintrin.h>
+#endif
+
+namespace
+{
+  typedef P256LaneField::Element Element;
+
+  const unsigned int NUM_LANES = P256LaneField::NUM_LANES;
+  const unsigned int NUM_LIMBS = P256LaneField::NUM_LIMBS;
+  const unsigned int LIMB_BITS = P256LaneField::LIMB_BITS;
+
+  /// @brief Mask for the low 52 bits of a limb.
+  const uint64_t LIMB_MASK = ( uint64_t(1) << LIMB_BITS ) - 1u;
+
+  /// @brief p = 2^256 - 2^224 + 2^192 + 2^96 - 1
+  const uint64_t PRIME[NUM_LIMBS] = 
+  {
+    0xfffffffffffffull, 0x00fffffffffffull, 0x0000000000000ull, 
+    0x0001000000000ull, 0x0ffffffff0000ull
+  };
+
+  /// @brief R mod p, with R = 2^260.
+  const uint64_t ONE[NUM_LIMBS] = 
+  {
+    0x0000000000010ull, 0xf000000000000ull, 0xfffffffffffffull, 
+    0xffeffffffffffull, 0x00000000fffffull
+  };
+
+  /// @brief R^2 mod p.
+  const uint64_t R_SQUARED[NUM_LIMBS] = 
+  {
+    0x0000000000300ull, 0xffffffff00000ull, 0xffffefffffffbull, 
+    0xfdfffffffffffull, 0x000000004ffffffull
+  };
+
+  // ==========================================================================
+  /** Propagate the carries of a lane-wise sum below 2p, then subtract p from
+      the lanes which are at least p.
+      @param result The element to place the reduced sum into.
+      @param sum The unnormalized sum, below 2p, with limbs below 2^63.
+  */
+  void reducePortable(Element& result, const Element& sum)
+  {
+    Element  difference;
+    uint64_t carry [NUM_LANES] = {0, 0, 0, 0, 0, 0, 0, 0};
+    uint64_t borrow[NUM_LANES] = {0, 0, 0, 0, 0, 0, 0, 0};
+
+    for ( unsigned int i = 0; i < NUM_LIMBS; ++i )
+    {
+      for ( unsigned int lane = 0; lane < NUM_LANES; ++lane )
+      {
+        const uint64_t limb = sum.limbs[i][lane] + carry[lane];
+        const uint64_t kept = limb & LIMB_MASK;
+        const uint64_t less = kept - PRIME[i] - borrow[lane];
+
+        carry[lane]               = limb >> LIMB_BITS;
+        borrow[lane]              = less >> 63;
+        result.limbs[i][lane]     = kept;
+        difference.limbs[i][lane] = less & LIMB_MASK;
+      }
+    }
+
+    /// The sum is below 2p, so nothing carries out of the top limb.
+    for ( unsigned int i = 0; i < NUM_LIMBS; ++i )
+    {
+      for ( unsigned int lane = 0; lane < NUM_LANES; ++lane )
+      {
+        const uint64_t keep = 0 - borrow[lane];
+        result.limbs[i][lane] = ( result.limbs[i][lane]     &  keep ) | 
+                                ( difference.limbs[i][lane] & ~keep );
+      }
+    }
+  }
+
+  // ==========================================================================
+  /// @brief result = lhs + rhs mod p, one lane at a time.
+  void addPortable(Element& result, const Element& lhs, const Element& rhs)
+  {
+    Element sum;
+    for ( unsigned int i = 0; i < NUM_LIMBS; ++i )
+    {
+      for ( unsigned int lane = 0; lane < NUM_LANES; ++lane )
+      {
+        sum.limbs[i][lane] = lhs.limbs[i][lane] + rhs.limbs[i][lane];
+      }
+    }
+
+    reducePortable(result, sum);
+  }
+
+  // ==========================================================================
+  /// @brief result = lhs - rhs mod p, one lane at a time.
+  void subPortable(Element& result, const Element& lhs, const Element& rhs)
+  {
+    uint64_t borrow[NUM_LANES] = {0, 0, 0, 0, 0, 0, 0, 0};
+    uint64_t carry [NUM_LANES] = {0, 0, 0, 0, 0, 0, 0, 0};
+
+    for ( unsigned int i = 0; i < NUM_LIMBS; ++i )
+    {
+      for ( unsigned int lane = 0; lane < NUM_LANES; ++lane )
+      {
+        const uint64_t difference = 
+          lhs.limbs[i][lane] - rhs.limbs[i][lane] - borrow[lane];
+
+        result.limbs[i][lane] = difference & LIMB_MASK;
+        borrow[lane]          = difference >> 63;
+      }
+    }
+
+    /// Add p back to the lanes which went negative.
+    for ( unsigned int i = 0; i < NUM_LIMBS; ++i )
+    {
+      for ( unsigned int lane = 0; lane < NUM_LANES; ++lane )
+      {
+        const uint64_t sum = result.limbs[i][lane] + 
+                             ( PRIME[i] & ( 0 - borrow[lane] ) ) + carry[lane];
+
+        result.limbs[i][lane] = sum & LIMB_MASK;
+        carry[lane]           = sum >> LIMB_BITS;
+      }
+    }
+  }
+
+  // ==========================================================================
+  /// @brief result = value in the lanes where condition is set.
+  void conditionalMovePortable(Element&                   result, 
+                               const Element&             value, 
+                               const P256LaneField::Mask& condition)
+  {
+    for ( unsigned int i = 0; i < NUM_LIMBS; ++i )
+    {
+      for ( unsigned int lane = 0; lane < NUM_LANES; ++lane )
+      {
+        result.limbs[i][lane] ^= 
+          ( result.limbs[i][lane] ^ value.limbs[i][lane] ) & condition.lanes[lane];
+      }
+    }
+  }
+
+  // ==========================================================================
+  /** Montgomery multiplication, result = lhs * rhs / R mod p, one lane at a 
+      time with 64-bit integer arithmetic.
+  */
+  void mulPortable(Element& result, const Element& lhs, const Element& rhs)
+  {
+    __extension__ typedef unsigned __int128 uint128_t;
+
+    Element accumulated;
+
+    for ( unsigned int lane = 0; lane < NUM_LANES; ++lane )
+    {
+      uint64_t acc[NUM_LIMBS + 1] = {0, 0, 0, 0, 0, 0};
+
+      /** Mirror the IFMA instructions: split every 104-bit product into its 
+          low and high 52 bits, and add them into 64-bit column accumulators.
+          Since p = -1 mod 2^52, the Montgomery multiple of p is simply 
+          acc[0] mod 2^52.
+      */
+      for ( unsigned int i = 0; i < NUM_LIMBS; ++i )
+      {
+        for ( unsigned int j = 0; j < NUM_LIMBS; ++j )
+        {
+          const uint128_t t = static_cast<uint128_t>(lhs.limbs[i][lane]) * 
+                              rhs.limbs[j][lane];
+          acc[j]     += static_cast<uint64_t>(t) & LIMB_MASK;
+          acc[j + 1] += static_cast<uint64_t>(t >> LIMB_BITS);
+        }
+
+        const uint64_t m = acc[0] & LIMB_MASK;
+        for ( unsigned int j = 0; j < NUM_LIMBS; ++j )
+        {
+          const uint128_t t = static_cast<uint128_t>(m) * PRIME[j];
+          acc[j]     += static_cast<uint64_t>(t) & LIMB_MASK;
+          acc[j + 1] += static_cast<uint64_t>(t >> LIMB_BITS);
+        }
+
+        /// The low limb is now divisible by 2^52, so shift it out.
+        acc[1] += acc[0] >> LIMB_BITS;
+        for ( unsigned int j = 0; j < NUM_LIMBS; ++j )
+        {
+          acc[j] = acc[j + 1];
+        }
+        acc[NUM_LIMBS] = 0;
+      }
+
+      for ( unsigned int j = 0; j < NUM_LIMBS; ++j )
+      {
+        accumulated.limbs[j][lane] = acc[j];
+      }
+    }
+
+    /// Both inputs are below p < 2^256, so the result is below 2p.
+    reducePortable(result, accumulated);
+  }
+
+#ifdef P256_LANE_FIELD_IFMA
+
+  /** The AVX-512 versions below follow the portable ones step for step, with
+      one vector holding the same limb of every lane. Shifts are zero-masked, 
+      as the unmasked forms trip -Wuninitialized in GCC 12's headers.
+  */
+  const __mmask8 ALL_LANES = 0xff;
+
+  // ==========================================================================
+  /// @brief reducePortable() for all lanes at once, storing into result.
+  __attribute__((target("avx512f")))
+  inline void reduceVector(Element& result, __m512i sum[NUM_LIMBS])
+  {
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i mask = _mm512_set1_epi64(static_cast<long long>(LIMB_MASK));
+
+    __m512i carry  = zero;
+    __m512i borrow = zero;
+    __m512i difference[NUM_LIMBS];
+
+    for ( unsigned int j = 0; j < NUM_LIMBS; ++j )
+    {
+      const __m512i limb  = _mm512_add_epi64(sum[j], carry);
+      const __m512i prime = _mm512_set1_epi64(static_cast<long long>(PRIME[j]));
+
+      carry  = _mm512_maskz_srli_epi64(ALL_LANES, limb, LIMB_BITS);
+      sum[j] = _mm512_and_si512(limb, mask);
+
+      const __m512i less = 
+        _mm512_sub_epi64(_mm512_sub_epi64(sum[j], prime), borrow);
+      borrow        = _mm512_maskz_srli_epi64(ALL_LANES, less, 63);
+      difference[j] = _mm512_and_si512(less, mask);
+    }
+
+    const __mmask8 keep = _mm512_test_epi64_mask(borrow, borrow);
+    for ( unsigned int j = 0; j < NUM_LIMBS; ++j )
+    {
+      _mm512_storeu_si512(result.limbs[j], 
+                          _mm512_mask_blend_epi64(keep, difference[j], sum[j]));
+    }
+  }
+
+  // ==========================================================================
+  /// @brief addPortable() for all lanes at once.
+  __attribute__((target("avx512f")))
+  void addVector(Element& result, const Element& lhs, const Element& rhs)
+  {
+    __m512i sum[NUM_LIMBS];
+    for ( unsigned int j = 0; j < NUM_LIMBS; ++j )
+    {
+      sum[j] = _mm512_add_epi64(_mm512_loadu_si512(lhs.limbs[j]), 
+                                _mm512_loadu_si512(rhs.limbs[j]));
+    }
+
+    reduceVector(result, sum);
+  }
+
+  // ==========================================================================
+  /// @brief subPortable() for all lanes at once.
+  __attribute__((target("avx512f")))
+  void subVector(Element& result, const Element& lhs, const Element& rhs)
+  {
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i mask = _mm512_set1_epi64(static_cast<long long>(LIMB_MASK));
+
+    __m512i difference[NUM_LIMBS];
+    __m512i borrow = zero;
+    for ( unsigned int j = 0; j < NUM_LIMBS; ++j )
+    {
+      const __m512i limb = 
+        _mm512_sub_epi64(_mm512_sub_epi64(_mm512_loadu_si512(lhs.limbs[j]), 
+                                          _mm512_loadu_si512(rhs.limbs[j])), 
+                         borrow);
+      borrow        = _mm512_maskz_srli_epi64(ALL_LANES, limb, 63);
+      difference[j] = _mm512_and_si512(limb, mask);
+    }
+
+    /// Add p back to the lanes which went negative.
+    const __mmask8 negative = _mm512_test_epi64_mask(borrow, borrow);
+    __m512i        carry    = zero;
+    for ( unsigned int j = 0; j < NUM_LIMBS; ++j )
+    {
+      const __m512i prime = _mm512_maskz_mov_epi64(
+        negative, _mm512_set1_epi64(static_cast<long long>(PRIME[j])));
+      const __m512i limb  = 
+        _mm512_add_epi64(_mm512_add_epi64(difference[j], prime), carry);
+
+      carry = _mm512_maskz_srli_epi64(ALL_LANES, limb, LIMB_BITS);
+      _mm512_storeu_si512(result.limbs[j], _mm512_and_si512(limb, mask));
+    }
+  }
+
+  // ==========================================================================
+  /// @brief conditionalMovePortable() for all lanes at once.
+  __attribute__((target("avx512f")))
+  void conditionalMoveVector(Element&                   result, 
+                             const Element&             value, 
+                             const P256LaneField::Mask& condition)
+  {
+    const __m512i  lanes = _mm512_loadu_si512(condition.lanes);
+    const __mmask8 move  = _mm512_test_epi64_mask(lanes, lanes);
+
+    for ( unsigned int j = 0; j < NUM_LIMBS; ++j )
+    {
+      const __m512i kept  = _mm512_loadu_si512(result.limbs[j]);
+      const __m512i moved = _mm512_loadu_si512(value.limbs[j]);
+      _mm512_storeu_si512(result.limbs[j], 
+                          _mm512_mask_blend_epi64(move, kept, moved));
+    }
+  }
+
+  // ==========================================================================
+  /// @brief mulPortable() for all lanes at once, with AVX-512 IFMA.
+  __attribute__((target("avx512f,avx512ifma")))
+  void mulVector(Element& result, const Element& lhs, const Element& rhs)
+  {
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i mask = _mm512_set1_epi64(static_cast<long long>(LIMB_MASK));
+
+    __m512i a[NUM_LIMBS];
+    __m512i b[NUM_LIMBS];
+    __m512i p[NUM_LIMBS];
+    __m512i acc[NUM_LIMBS + 1];
+
+    for ( unsigned int j = 0; j < NUM_LIMBS; ++j )
+    {
+      a[j]   = _mm512_loadu_si512(lhs.limbs[j]);
+      b[j]   = _mm512_loadu_si512(rhs.limbs[j]);
+      p[j]   = _mm512_set1_epi64(static_cast<long long>(PRIME[j]));
+      acc[j] = zero;
+    }
+    acc[NUM_LIMBS] = zero;
+
+    for ( unsigned int i = 0; i < NUM_LIMBS; ++i )
+    {
+      for ( unsigned int j = 0; j < NUM_LIMBS; ++j )
+      {
+        acc[j]     = _mm512_madd52lo_epu64(acc[j],     a[i], b[j]);
+        acc[j + 1] = _mm512_madd52hi_epu64(acc[j + 1], a[i], b[j]);
+      }
+
+      /// Limb 2 of p is zero, so its products are skipped.
+      const __m512i m = _mm512_and_si512(acc[0], mask);
+      for ( unsigned int j = 0; j < NUM_LIMBS; ++j )
+      {
+        if ( PRIME[j] != 0 )
+        {
+          acc[j]     = _mm512_madd52lo_epu64(acc[j],     m, p[j]);
+          acc[j + 1] = _mm512_madd52hi_epu64(acc[j + 1], m, p[j]);
+        }
+      }
+
+      acc[1] = _mm512_add_epi64(
+        acc[1], _mm512_maskz_srli_epi64(ALL_LANES, acc[0], LIMB_BITS));
+      for ( unsigned int j = 0; j < NUM_LIMBS; ++j )
+      {
+        acc[j] = acc[j + 1];
+      }
+      acc[NUM_LIMBS] = zero;
+    }
+
+    reduceVector(result, acc);
+  }
+
+#endif
+}
+
+// ============================================================================
+P256LaneField::P256LaneField(bool allow_ifma)
+  : use_ifma(allow_ifma && isIfmaSupported()),
+    one(),
+    r_squared()
+{
+  for ( unsigned int i = 0; i < NUM_LIMBS; ++i )
+  {
+    for ( unsigned int lane = 0; lane < NUM_LANES; ++lane )
+    {
+      one.limbs[i][lane]       = ONE[i];
+      r_squared.limbs[i][lane] = R_SQUARED[i];
+    }
+  }
+}
+
+// ============================================================================
+P256LaneField::~P256LaneField()
+{
+}
+
+// ============================================================================
+bool P256LaneField::isIfmaSupported()
+{
+#ifdef P256_LANE_FIELD_IFMA
+  /// Also checks that the operating system saves the AVX-512 registers.
+  return __builtin_cpu_supports("avx512f") && 
+         __builtin_cpu_supports("avx512ifma");
+#else
+  return false;
+#endif
+}
+
+// ============================================================================
+void P256LaneField::setLane(Element&                  result, 
+                            unsigned int              lane, 
+                            const P256Field::Element& value) const
+{
+  const uint64_t* a = value.limbs;
+
+  Element plain;
+  setZero(plain);
+  plain.limbs[0][lane] =   a[0]                      & LIMB_MASK;
+  plain.limbs[1][lane] = ( a[0] >> 52 | a[1] << 12 ) & LIMB_MASK;
+  plain.limbs[2][lane] = ( a[1] >> 40 | a[2] << 24 ) & LIMB_MASK;
+  plain.limbs[3][lane] = ( a[2] >> 28 | a[3] << 36 ) & LIMB_MASK;
+  plain.limbs[4][lane] =   a[3] >> 16;
+
+  /// Montgomery multiplication by R^2 yields xR mod p.
+  mul(plain, plain, r_squared);
+  for ( unsigned int i = 0; i < NUM_LIMBS; ++i )
+  {
+    result.limbs[i][lane] = plain.limbs[i][lane];
+  }
+}
+
+// ============================================================================
+void P256LaneField::getLane(P256Field::Element& result, 
+                            const Element&      value, 
+                            unsigned int        lane) const
+{
+  Element plain;
+  Element unit;
+  setZero(plain);
+  setZero(unit);
+  for ( unsigned int i = 0; i < NUM_LIMBS; ++i )
+  {
+    plain.limbs[i][lane] = value.limbs[i][lane];
+  }
+
+  /// Montgomery multiplication by 1 yields x / R mod p, i.e. the plain value.
+  unit.limbs[0][lane] = 1;
+  mul(plain, plain, unit);
+
+  uint64_t l[NUM_LIMBS];
+  for ( unsigned int i = 0; i < NUM_LIMBS; ++i )
+  {
+    l[i] = plain.limbs[i][lane];
+  }
+
+  result.limbs[0] = l[0]       | l[1] << 52;
+  result.limbs[1] = l[1] >> 12 | l[2] << 40;
+  result.limbs[2] = l[2] >> 24 | l[3] << 28;
+  result.limbs[3] = l[3] >> 36 | l[4] << 16;
+}
+
+// ============================================================================
+void P256LaneField::broadcast(Element& result, const P256Field::Element& value) const
+{
+  for ( unsigned int lane = 0; lane < NUM_LANES; ++lane )
+  {
+    setLane(result, lane, value);
+  }
+}
+
+// ============================================================================
+void P256LaneField::add(Element& result, const Element& lhs, const Element& rhs) const
+{
+#ifdef P256_LANE_FIELD_IFMA
+  if ( use_ifma )
+  {
+    addVector(result, lhs, rhs);
+    return;
+  }
+#endif
+  addPortable(result, lhs, rhs);
+}
+
+// ============================================================================
+void P256LaneField::sub(Element& result, const Element& lhs, const Element& rhs) const
+{
+#ifdef P256_LANE_FIELD_IFMA
+  if ( use_ifma )
+  {
+    subVector(result, lhs, rhs);
+    return;
+  }
+#endif
+  subPortable(result, lhs, rhs);
+}
+
+// ============================================================================
+void P256LaneField::mul(Element& result, const Element& lhs, const Element& rhs) const
+{
+#ifdef P256_LANE_FIELD_IFMA
+  if ( use_ifma )
+  {
+    mulVector(result, lhs, rhs);
+    return;
+  }
+#endif
+  mulPortable(result, lhs, rhs);
+}
+
+// ============================================================================
+void P256LaneField::conditionalMove(Element&       result, 
+                                    const Element& value, 
+                                    const Mask&    condition) const
+{
+#ifdef P256_LANE_FIELD_IFMA
+  if ( use_ifma )
+  {
+    conditionalMoveVector(result, value, condition);
+    return;
+  }
+#endif
+  conditionalMovePortable(result, value, condition);
+}
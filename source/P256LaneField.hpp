@@ -0,0 +1,214 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+
+#ifndef P256_LANE_FIELD_HPP
+#define P256_LANE_FIELD_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "P256Field.hpp"
+
+/** P-256 field arithmetic on NUM_LANES independent elements at once, for 
+    running many scalar multiplications in lockstep. Elements are stored as a
+    structure of arrays: five limbs of 52 bits, each holding one limb of every
+    lane, so that a single vector instruction can work on the same limb of 
+    all lanes. Elements are kept in Montgomery form with R = 2^260, and are 
+    always fully reduced into [0, p).
+
+    When the CPU supports them, multiplication uses the AVX-512 IFMA 
+    instructions (vpmadd52luq and vpmadd52huq), which multiply eight pairs of
+    52-bit limbs at once, and additions work on all eight lanes with AVX-512.
+    Otherwise each lane is processed in turn with 64-bit arithmetic, which 
+    gives identical results. Every operation runs without 
+    branching on the values of the lanes.
+    @cite Gueron, Krasnov. Accelerating Big Integer Arithmetic Using Intel 
+    IFMA Extensions. ARITH 2016.
+*/
+class P256LaneField
+{
+public:
+
+  /// @brief The number of elements processed by each operation.
+  static const unsigned int NUM_LANES = 8u;
+
+  /// @brief The number of 52-bit limbs in a field element.
+  static const unsigned int NUM_LIMBS = 5u;
+
+  /// @brief The number of bits in each limb.
+  static const unsigned int LIMB_BITS = 52u;
+
+  /** @brief NUM_LANES field elements. limbs[i][lane] is limb i of the element
+      in the given lane, least significant limb first.
+  */
+  struct Element
+  {
+    uint64_t limbs[NUM_LIMBS][NUM_LANES];
+  };
+
+  /// @brief A condition per lane, where each lane is either all ones or zero.
+  struct Mask
+  {
+    uint64_t lanes[NUM_LANES];
+  };
+
+  /** Construct a new field, choosing the multiplication for this CPU.
+      @param allow_ifma If false, the portable arithmetic is always used.
+   */
+  explicit P256LaneField(bool allow_ifma = true);
+
+  /// @brief The destructor does nothing.
+  ~P256LaneField();
+
+  /** Check if this CPU supports the AVX-512 IFMA instructions, and the 
+      compiler was able to build the code which uses them.
+      @return True if the vectorized arithmetic is available.
+  */
+  static bool isIfmaSupported();
+
+  /** Accessor for the arithmetic in use.
+      @return True if the arithmetic uses AVX-512 IFMA.
+  */
+  bool usesIfma() const;
+
+  /** Copy a single element into one lane, converting it into Montgomery form.
+      @param result The element to place value into.
+      @param lane The lane to overwrite, in [0, NUM_LANES).
+      @param value The element to copy, in [0, p).
+   */
+  void setLane(Element& result, unsigned int lane, const P256Field::Element& value) const;
+
+  /** Copy one lane into a single element, converting it out of Montgomery 
+      form.
+      @param result The element to place the lane into.
+      @param value The element to copy from.
+      @param lane The lane to copy, in [0, NUM_LANES).
+   */
+  void getLane(P256Field::Element& result, const Element& value, unsigned int lane) const;
+
+  /** Copy a single element into every lane, converting it into Montgomery 
+      form.
+      @param result The element to place value into.
+      @param value The element to copy, in [0, p).
+   */
+  void broadcast(Element& result, const P256Field::Element& value) const;
+
+  /// @brief result = 0 in every lane
+  void setZero(Element& result) const;
+
+  /// @brief result = 1 in every lane
+  void setOne(Element& result) const;
+
+  /// @brief result = lhs + rhs mod p
+  void add(Element& result, const Element& lhs, const Element& rhs) const;
+
+  /// @brief result = lhs - rhs mod p
+  void sub(Element& result, const Element& lhs, const Element& rhs) const;
+
+  /// @brief result = lhs * rhs mod p
+  void mul(Element& result, const Element& lhs, const Element& rhs) const;
+
+  /// @brief result = value^2 mod p
+  void sqr(Element& result, const Element& value) const;
+
+  /// @brief result = -value mod p
+  void neg(Element& result, const Element& value) const;
+
+  /** result = value in every lane where condition is set. Other lanes are 
+      left unchanged.
+      @param result The element to conditionally overwrite.
+      @param value The element to copy.
+      @param condition The lanes to copy.
+   */
+  void conditionalMove(Element&       result, 
+                       const Element& value, 
+                       const Mask&    condition) const;
+
+  /** Test which lanes hold zero.
+      @param result Set in every lane where value == 0.
+      @param value The element to test.
+   */
+  void isZero(Mask& result, const Element& value) const;
+
+private:
+
+  /// @brief True if the arithmetic uses AVX-512 IFMA.
+  bool use_ifma;
+
+  /// @brief R mod p, i.e. 1 in Montgomery form, in every lane.
+  Element one;
+
+  /// @brief R^2 mod p, used to convert into Montgomery form, in every lane.
+  Element r_squared;
+
+  /// Both copy assignment and copy constructors are deleted.
+  P256LaneField operator=(const P256LaneField& object) = delete;
+  P256LaneField          (const P256LaneField& object) = delete;
+};
+
+// ============================================================================
+inline bool P256LaneField::usesIfma() const
+{
+  return use_ifma;
+}
+
+// ============================================================================
+inline void P256LaneField::setZero(Element& result) const
+{
+  for ( unsigned int i = 0; i < NUM_LIMBS; ++i )
+  {
+    for ( unsigned int lane = 0; lane < NUM_LANES; ++lane )
+    {
+      result.limbs[i][lane] = 0;
+    }
+  }
+}
+
+// ============================================================================
+inline void P256LaneField::setOne(Element& result) const
+{
+  result = one;
+}
+
+// ============================================================================
+inline void P256LaneField::sqr(Element& result, const Element& value) const
+{
+  mul(result, value, value);
+}
+
+// ============================================================================
+inline void P256LaneField::neg(Element& result, const Element& value) const
+{
+  Element zero;
+  setZero(zero);
+  sub    (result, zero, value);
+}
+
+// ============================================================================
+inline void P256LaneField::isZero(Mask& result, const Element& value) const
+{
+  for ( unsigned int lane = 0; lane < NUM_LANES; ++lane )
+  {
+    uint64_t bits = 0;
+    for ( unsigned int i = 0; i < NUM_LIMBS; ++i )
+    {
+      bits |= value.limbs[i][lane];
+    }
+
+    /// The top bit of bits | -bits is clear only when bits == 0.
+    result.lanes[lane] = ( ( bits | ( 0 - bits ) ) >> 63 ) - 1u;
+  }
+}
+
+#endif
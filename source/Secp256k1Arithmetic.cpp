@@ -0,0 +1,201 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+
+#include "Secp256k1Arithmetic.hpp"
+
+#include <stdexcept>
+
+#include "Constants.hpp"
+#include "EllipticCurveConstants.hpp"
+
+// ============================================================================
+Secp256k1Arithmetic::SplitTerm::SplitTerm()
+  : phi_P()
+{
+  mpz_inits(k1, k2, nullptr);
+}
+
+// ============================================================================
+Secp256k1Arithmetic::SplitTerm::~SplitTerm()
+{
+  mpz_clears(k1, k2, nullptr);
+}
+
+// ============================================================================
+Secp256k1Arithmetic::Secp256k1Arithmetic(const mpz_t& p_in, 
+                                         const mpz_t& a_in, 
+                                         const mpz_t& b_in)
+  : Secp256k1JacobianArithmetic(p_in, a_in, b_in)
+{
+  const CurveParameters& parameters = curve_parameters.at(Curves::SECP256K1);
+
+  mpz_inits(p, order, beta, a1, b1, a2, b2, nullptr);
+  mpz_set_str(p,     parameters.p, Base::DECIMAL);
+  mpz_set_str(order, parameters.n, Base::DECIMAL);
+
+  if ( mpz_cmp(p, p_in) != 0 || !mpz_divisible_p(a_in, p) )
+  {
+    mpz_clears(p, order, beta, a1, b1, a2, b2, nullptr);
+    throw std::invalid_argument("Secp256k1Arithmetic requires the curve secp256k1.");
+  }
+
+  /** beta has order 3 mod p, and lambda has order 3 mod n. The basis satisfies
+      a + b * lambda = 0 mod n, with every entry of about 128 bits.
+      @cite Section 3.5 of Hankerson, Menezes, Vanstone. Guide to Elliptic 
+      Curve Cryptography. Springer, 2004.
+  */
+  mpz_set_str(beta, "7ae96a2b657c07106e64479eac3434e99cf0497512f58995c1396c28719501ee", 
+              Base::HEX);
+  mpz_set_str(a1,   "3086d221a7d46bcde86c90e49284eb15",   Base::HEX);
+  mpz_set_str(b1,   "-e4437ed6010e88286f547fa90abfe4c3",  Base::HEX);
+  mpz_set_str(a2,   "114ca50f7a8e2f3f657c1108d9d44cfd8",  Base::HEX);
+  mpz_set    (b2,   a1);
+}
+
+// ============================================================================
+Secp256k1Arithmetic::~Secp256k1Arithmetic()
+{
+  mpz_clears(p, order, beta, a1, b1, a2, b2, nullptr);
+}
+
+// ============================================================================
+EllipticCurve::Point 
+Secp256k1Arithmetic::scalarMultiplication(const mpz_t&                scalar, 
+                                          const EllipticCurve::Point& P) const
+{
+  if ( P.at_infinity || mpz_sgn(scalar) == 0 )
+  {
+    return EllipticCurve::Point();
+  }
+
+  SplitTerm half;
+  splitScalar(half.k1, half.k2, scalar);
+  half.phi_P = endomorphism(P);
+
+  const Terms terms = { EllipticCurve::MultiplicationTerm(half.k1, P), 
+                        EllipticCurve::MultiplicationTerm(half.k2, half.phi_P) };
+  return Secp256k1JacobianArithmetic::multiScalarMultiplication(terms);
+}
+
+// ============================================================================
+EllipticCurve::Point Secp256k1Arithmetic::multiScalarMultiplication(
+  const std::vector<EllipticCurve::MultiplicationTerm>& terms) const
+{
+  Terms                        split;
+  std::unique_ptr<SplitTerm[]> storage;
+  splitTerms(split, storage, terms);
+
+  return Secp256k1JacobianArithmetic::multiScalarMultiplication(split);
+}
+
+// ============================================================================
+std::vector<EllipticCurve::Point> 
+Secp256k1Arithmetic::batchMultiScalarMultiplication(
+  const std::vector<std::vector<EllipticCurve::MultiplicationTerm>>& batch) const
+{
+  std::vector<Terms>                        split(batch.size());
+  std::vector<std::unique_ptr<SplitTerm[]>> storage(batch.size());
+  for ( std::size_t i = 0; i < batch.size(); ++i )
+  {
+    splitTerms(split[i], storage[i], batch[i]);
+  }
+
+  return Secp256k1JacobianArithmetic::batchMultiScalarMultiplication(split);
+}
+
+// ============================================================================
+void Secp256k1Arithmetic::splitScalar(mpz_t      k1, 
+                                      mpz_t      k2, 
+                                      mpz_srcptr scalar) const
+{
+  mpz_t k;
+  mpz_t c1;
+  mpz_t c2;
+  mpz_inits(k, c1, c2, nullptr);
+
+  mpz_mod(k, scalar, order);
+
+  /// c1 = round(b2 * k / n), computed as floor((2 * b2 * k + n) / 2n).
+  mpz_mul         (c1, b2, k);
+  mpz_mul_2exp    (c1, c1, 1ul);
+  mpz_add         (c1, c1, order);
+  mpz_fdiv_q      (c1, c1, order);
+  mpz_fdiv_q_2exp (c1, c1, 1ul);
+
+  /// c2 = round(-b1 * k / n)
+  mpz_mul         (c2, b1, k);
+  mpz_neg         (c2, c2);
+  mpz_mul_2exp    (c2, c2, 1ul);
+  mpz_add         (c2, c2, order);
+  mpz_fdiv_q      (c2, c2, order);
+  mpz_fdiv_q_2exp (c2, c2, 1ul);
+
+  /// k1 = k - c1 * a1 - c2 * a2
+  mpz_set   (k1, k);
+  mpz_submul(k1, c1, a1);
+  mpz_submul(k1, c2, a2);
+
+  /// k2 = -c1 * b1 - c2 * b2
+  mpz_set_ui(k2, 0ul);
+  mpz_submul(k2, c1, b1);
+  mpz_submul(k2, c2, b2);
+
+  mpz_clears(k, c1, c2, nullptr);
+}
+
+// ============================================================================
+EllipticCurve::Point 
+Secp256k1Arithmetic::endomorphism(const EllipticCurve::Point& P) const
+{
+  if ( P.at_infinity )
+  {
+    return P;
+  }
+
+  mpz_t x;
+  mpz_init(x);
+  mpz_mul (x, beta, P.x);
+  mpz_mod (x, x,    p);
+
+  const EllipticCurve::Point result(x, P.y);
+  mpz_clear(x);
+  return result;
+}
+
+// ============================================================================
+void Secp256k1Arithmetic::splitTerms(Terms&                        split, 
+                                     std::unique_ptr<SplitTerm[]>& storage, 
+                                     const Terms&                  terms) const
+{
+  storage.reset(new SplitTerm[terms.size()]);
+  split.clear();
+  split.reserve(2u * terms.size());
+
+  for ( std::size_t i = 0; i < terms.size(); ++i )
+  {
+    const EllipticCurve::MultiplicationTerm& term = terms[i];
+    if ( term.table != nullptr || term.point->at_infinity )
+    {
+      split.push_back(term);
+      continue;
+    }
+
+    SplitTerm& half = storage[i];
+    splitScalar(half.k1, half.k2, term.scalar);
+    half.phi_P = endomorphism(*term.point);
+
+    split.push_back(EllipticCurve::MultiplicationTerm(half.k1, *term.point));
+    split.push_back(EllipticCurve::MultiplicationTerm(half.k2, half.phi_P));
+  }
+}
@@ -0,0 +1,132 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+#ifndef SECP256K1_ARITHMETIC_HPP
+#define SECP256K1_ARITHMETIC_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "CurveArithmetic.hpp"
+#include "CurveTraits.hpp"
+#include "EllipticCurve.hpp"
+#include "MpnField.hpp"
+
+#include <gmp.h>
+
+/// @brief The scalar arithmetic for curve secp256k1, specialized by its traits.
+typedef JacobianArithmetic<MpnField, CurveTraits<Curves::SECP256K1>> 
+  Secp256k1JacobianArithmetic;
+
+/** Point arithmetic for curve secp256k1, which speeds up variable-base 
+    multiplication with the curve's efficiently computable endomorphism 
+    phi(x, y) = (beta * x, y) = lambda * (x, y). Each scalar k is split into 
+    k1 + k2 * lambda mod n, with k1 and k2 of about 128 bits, and k * P is 
+    computed as the joint multiplication k1 * P + k2 * phi(P). The two halves
+    share one chain of doublings, which is half as long as for k itself.
+
+    Terms with a precomputed table already use a comb, and are not split.
+    constantTimeScalarMultiplication() is left to Secp256k1JacobianArithmetic,
+    as the split itself is not constant time.
+    @cite Gallant, Lambert, Vanstone. Faster Point Multiplication on Elliptic 
+    Curves with Efficient Endomorphisms. CRYPTO 2001.
+*/
+class Secp256k1Arithmetic : public Secp256k1JacobianArithmetic
+{
+public:
+
+  /** Construct the arithmetic for a curve.
+      @param p The curve's prime modulus. Must be the secp256k1 prime.
+      @param a The curve's a parameter. Must be 0.
+      @param b The curve's b parameter.
+      @throw std::invalid_argument if the curve is not secp256k1.
+  */
+  Secp256k1Arithmetic(const mpz_t& p, const mpz_t& a, const mpz_t& b);
+
+  /// @brief The destructor clears memory allocated by mpz_inits().
+  ~Secp256k1Arithmetic();
+
+  /// @brief Computes k1 * P + k2 * phi(P) with multiScalarMultiplication().
+  EllipticCurve::Point 
+  scalarMultiplication(const mpz_t& scalar, const EllipticCurve::Point& P) const;
+
+  /// @brief Splits every term without a table before summing them.
+  EllipticCurve::Point multiScalarMultiplication(
+    const std::vector<EllipticCurve::MultiplicationTerm>& terms) const;
+
+  /// @brief Splits every term without a table before summing them.
+  std::vector<EllipticCurve::Point> batchMultiScalarMultiplication(
+    const std::vector<std::vector<EllipticCurve::MultiplicationTerm>>& batch) const;
+
+  /** Split a scalar into k1 + k2 * lambda mod n, rounding k against the short 
+      lattice basis {(a1, b1), (a2, b2)} of the decomposition.
+      @param k1 The integer to place k1 into, with |k1| < 2^128.
+      @param k2 The integer to place k2 into, with |k2| < 2^128.
+      @param scalar The scalar to split. May be negative or larger than n.
+  */
+  void splitScalar(mpz_t k1, mpz_t k2, mpz_srcptr scalar) const;
+
+  /** Apply the endomorphism to an affine point.
+      @param P The point on the curve to map.
+      @return phi(P) = (beta * x, y), which equals lambda * P.
+  */
+  EllipticCurve::Point endomorphism(const EllipticCurve::Point& P) const;
+
+private:
+
+  /// @brief The halves of one split term, which must outlive the new terms.
+  struct SplitTerm
+  {
+    SplitTerm();
+    ~SplitTerm();
+
+    mpz_t                k1;
+    mpz_t                k2;
+    EllipticCurve::Point phi_P;
+
+    /// Both copy assignment and copy constructors are deleted.
+    SplitTerm operator=(const SplitTerm& object) = delete;
+    SplitTerm          (const SplitTerm& object) = delete;
+  };
+
+  typedef std::vector<EllipticCurve::MultiplicationTerm> Terms;
+
+  /** Replace each term without a table by its two halves.
+      @param split The terms to place the result into.
+      @param storage Holds the new scalars and points, one per input term.
+      @param terms The terms to split.
+  */
+  void splitTerms(Terms&                        split, 
+                  std::unique_ptr<SplitTerm[]>& storage, 
+                  const Terms&                  terms) const;
+
+  /// @brief The prime modulus p and the group order n.
+  mpz_t p;
+  mpz_t order;
+
+  /// @brief beta, a cube root of unity mod p, so that phi(P) = lambda * P.
+  mpz_t beta;
+
+  /// @brief The short basis of the lattice {(x, y) : x + y * lambda = 0 mod n}.
+  mpz_t a1;
+  mpz_t b1;
+  mpz_t a2;
+  mpz_t b2;
+
+  /// Both copy assignment and copy constructors are deleted.
+  Secp256k1Arithmetic operator=(const Secp256k1Arithmetic& object) = delete;
+  Secp256k1Arithmetic          (const Secp256k1Arithmetic& object) = delete;
+};
+
+#endif
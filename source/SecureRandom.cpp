@@ -0,0 +1,118 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+
+#include "SecureRandom.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+#include "sodium.h"
+
+namespace
+{
+  std::once_flag sodium_flag;
+
+  /** The random bytes of a single thread. Bytes before offset have been handed
+      out and wiped.
+  */
+  struct ThreadBuffer
+  {
+    ThreadBuffer()
+      : offset(SecureRandom::BUFFER_BYTES)
+    {
+    }
+
+    ~ThreadBuffer()
+    {
+      sodium_memzero(bytes, sizeof(bytes));
+    }
+
+    void refill()
+    {
+      /// sodium_init() is thread safe, but takes a lock on every call.
+      std::call_once(sodium_flag, []()
+      {
+        if ( sodium_init() < 0 )
+        {
+          throw std::runtime_error("libsodium failed to initialize.");
+        }
+      });
+
+      randombytes_buf(bytes, sizeof(bytes));
+      offset = 0u;
+    }
+
+    unsigned char bytes[SecureRandom::BUFFER_BYTES];
+    std::size_t   offset;
+  };
+
+  thread_local ThreadBuffer thread_buffer;
+}
+
+const std::size_t SecureRandom::BUFFER_BYTES;
+const std::size_t SecureRandom::MAX_SCALAR_BYTES;
+
+// ============================================================================
+void SecureRandom::getBytes(unsigned char* bytes, std::size_t count)
+{
+  ThreadBuffer& buffer = thread_buffer;
+  while ( count > 0u )
+  {
+    if ( buffer.offset == BUFFER_BYTES )
+    {
+      buffer.refill();
+    }
+
+    const std::size_t taken = std::min(count, BUFFER_BYTES - buffer.offset);
+    unsigned char* const source = buffer.bytes + buffer.offset;
+    std::memcpy   (bytes, source, taken);
+    sodium_memzero(source, taken);
+
+    buffer.offset += taken;
+    bytes         += taken;
+    count         -= taken;
+  }
+}
+
+// ============================================================================
+void SecureRandom::uniformScalar(mpz_t& value, const mpz_t& upper_bound)
+{
+  if ( mpz_cmp_ui(upper_bound, 1u) <= 0 )
+  {
+    throw std::invalid_argument("The upper bound must be greater than one.");
+  }
+
+  const std::size_t bits  = mpz_sizeinbase(upper_bound, 2);
+  const std::size_t count = ( bits + 7u ) / 8u;
+  if ( count > MAX_SCALAR_BYTES )
+  {
+    throw std::invalid_argument("The upper bound is too large.");
+  }
+
+  /// Keep only the bits of upper_bound's length in the most significant byte.
+  const unsigned char mask = 
+    static_cast<unsigned char>(0xffu >> ( 8u * count - bits ));
+
+  unsigned char candidate[MAX_SCALAR_BYTES];
+  do
+  {
+    getBytes(candidate, count);
+    candidate[0] &= mask;
+    mpz_import(value, count, 1, 1, 1, 0, candidate);
+  } while ( mpz_sgn(value) == 0 || mpz_cmp(value, upper_bound) >= 0 );
+
+  sodium_memzero(candidate, sizeof(candidate));
+}
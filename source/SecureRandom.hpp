@@ -0,0 +1,64 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+
+#ifndef SECURE_RANDOM_HPP
+#define SECURE_RANDOM_HPP
+
+#include <cstddef>
+
+#include "gmp.h"
+
+/** The source of randomness for private scalars. Each thread draws from its
+    own buffer, which is refilled BUFFER_BYTES at a time from libsodium's 
+    CSPRNG (the kernel's getrandom, or ChaCha20 keyed from it), so threads 
+    never share state or take a lock after libsodium is initialized. Bytes are
+    wiped from the buffer as they are handed out.
+*/
+class SecureRandom
+{
+public:
+
+  /// @brief The number of random bytes buffered by each thread.
+  static const std::size_t BUFFER_BYTES = 4096u;
+
+  /// @brief The largest upper bound accepted by uniformScalar(), in bytes.
+  static const std::size_t MAX_SCALAR_BYTES = 64u;
+
+  /** Fill a buffer with cryptographically secure random bytes.
+      @param bytes The buffer to fill.
+      @param count The number of bytes to write to bytes.
+      @throw std::runtime_error If libsodium fails to initialize.
+  */
+  static void getBytes(unsigned char* bytes, std::size_t count);
+
+  /** Compute a uniform random number from [1, upper_bound), by rejection 
+      sampling. Candidates are masked to the bit length of upper_bound, so 
+      fewer than two are needed on average.
+      @param value The value to put the random number into.
+      @param upper_bound The upper bound for the random number. Note that this
+      bound is not included.
+      @throw std::invalid_argument If upper_bound is not greater than one, or 
+      is larger than MAX_SCALAR_BYTES.
+      @throw std::runtime_error If libsodium fails to initialize.
+  */
+  static void uniformScalar(mpz_t& value, const mpz_t& upper_bound);
+
+private:
+
+  /// Both copy assignment and copy constructors are deleted.
+  SecureRandom operator=(const SecureRandom& object) = delete;
+  SecureRandom          (const SecureRandom& object) = delete;
+};
+
+#endif
@@ -14,17 +14,23 @@
 #include "Spake2.hpp"
 
 #include <cassert>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <vector>
 
 #include "EllipticCurveConstants.hpp"
 #include "HashFunctions.hpp"
 #include "KeyDerivationFunctions.hpp"
+#include "KeySharePool.hpp"
 #include "MessageAuthenticationCodeFunctions.hpp"
+#include "SecureRandom.hpp"
 #include "Spake2Constants.hpp"
 #include "StringHelpers.hpp"
 #include "sodium.h"
 
+#include <openssl/crypto.h>
+
 using std::cout;
 using std::endl;
 // ============================================================================
@@ -38,34 +44,41 @@ Spake2::Spake2(const std::string&                 identity_in,
                MessageAuthenticationCodeFunctions mac_function)
   : identity                 (identity_in),
     mode                     (client ? Mode::CLIENT : Mode::SERVER),
-    cipher_suite             (curve, 
-                              hash_function, 
-                              key_derivation_function, 
-                              mac_function),
+    cipher_suite             (Spake2CipherSuite::getCipherSuite(
+                                curve, 
+                                hash_function, 
+                                key_derivation_function, 
+                                mac_function)),
+    key_share                (),
     k_pub                    (),
     K                        (),
-    transcript               (),
+    transcript               (cipher_suite.getMessageDigest()),
+    transcript_hex           (),
     transcript_hash          (),
+    transcript_hash_length   (0u),
     symmetric_secrets        (),
     mac_keys                 (),
     addl_auth_data           (addl_auth_data),
     confirmation_key         (),
     expected_key             (),
+    confirmation_key_length  (0u),
     other_party_identity     (),
-    other_party_public_key   ()
+    other_party_public_key   (),
+    cleared_public_key       ()
 {
   cout << "SPAKE2 with identity \"" << identity << "\" running in " 
             << getMode() << " mode. EC = "         
             << cipher_suite.getCurve().getCurveName() << endl;
   
-  transcript.      reserve(1024u);
-  transcript_hash. reserve(transcript.capacity());
-  confirmation_key.reserve(transcript.capacity());
-
   mpz_inits(w, xy, k_pri, nullptr);  
 
-  /// Pick x / y randomly and uniformly in the range [0, p)
-  uniformRandomNumber(k_pri, cipher_suite.getCurve().getPrimeModulus());
+  /** Pick x / y randomly and uniformly in the range [1, n), along with 
+      {x/y}P, from the installed KeySharePool if it has a share ready.
+  */
+  if ( !KeySharePool::takeInstalled(curve, k_pri, key_share) )
+  {
+    SecureRandom::uniformScalar(k_pri, cipher_suite.getCurve().getOrder());
+  }
 
   /// Compute the shared integer, w, assuming A and B have pre-shared password.
   computeW           (password_in);
@@ -75,6 +88,9 @@ Spake2::Spake2(const std::string&                 identity_in,
 Spake2::~Spake2()
 {
   mpz_clears(w, xy, k_pri, nullptr);  
+
+  sodium_memzero(&symmetric_secrets, sizeof(symmetric_secrets));
+  sodium_memzero(&mac_keys,          sizeof(mac_keys));
 }
 
 // ============================================================================
@@ -107,32 +123,33 @@ bool Spake2::readOtherPartiesPublicKey()
 
   std::string line;
 
-  std::string other_party_public_key_uncompressed;
+  std::string other_party_public_key_encoded;
   if ( std::getline(infile, line) )
   {
     std::istringstream stream(line);
     std::getline(stream, other_party_identity, ',');
-    std::getline(stream, other_party_public_key_uncompressed);
+    std::getline(stream, other_party_public_key_encoded);
   }
 
   cout << "Successfully read other party's identity as \""        
        << other_party_identity << "\"." << endl;
   
-  /// The public key is in uncompressed format. Convert to a compressed point.
-  /// Skip the leading 0x04
-  std::string other_party_public_key_no_prefix = 
-    other_party_public_key_uncompressed.substr(UNCOMPRESSED_PREFIX_LEN);
-  
-  std::size_t coordinate_length = other_party_public_key_no_prefix.length() / 2;
-
-  other_party_public_key.at_infinity = false;
-
-  mpz_set_str(other_party_public_key.x, 
-    other_party_public_key_no_prefix.substr(0, coordinate_length).c_str(),
-    Base::HEX);
-  mpz_set_str(other_party_public_key.y, 
-    other_party_public_key_no_prefix.substr(coordinate_length)   .c_str(),
-    Base::HEX);
+  /** The public key may be SEC1 uncompressed (0x04) or compressed (0x02/0x03),
+      or RFC 8032 encoded on edwards25519.
+  */
+  try
+  {
+    other_party_public_key = 
+      cipher_suite.getCurve().decodePoint(other_party_public_key_encoded);
+    cleared_public_key     = 
+      cipher_suite.getCurve().clearCofactor(other_party_public_key);
+  }
+  catch ( const std::invalid_argument& error )
+  {
+    std::cerr << "Error decoding other party's public key: " << error.what() 
+              << endl;
+    return false;
+  }
 
   infile.close();
   return true;
@@ -210,13 +227,13 @@ void Spake2::transmitPublicKey() const
     std::abort();
   }
 
-  outfile << identity << "," << getUncompressedPublicKey() << endl;
+  outfile << identity << "," << getEncodedPublicKey() << endl;
 
   outfile.close();
 
   cout << "Setup phase complete." << endl;
   gmp_printf(" w    = %#Zx\n", w);
-  cout << " kpub = " << getUncompressedPublicKey()   << endl;
+  cout << " kpub = " << getEncodedPublicKey()       << endl;
   cout << "Public key successfully written to file." << endl;
 }
 
@@ -233,15 +250,17 @@ void Spake2::transmitConfirmationKey() const
     std::abort();
   }
 
-  outfile << identity << "," << confirmation_key << endl;
+  outfile << identity << "," << getConfirmationKey() << endl;
 
   outfile.close();
 
   cout << "Confirmation key successfully written to file. " 
             << "Key derivation phase complete."             << endl;
-  cout << "  k_conf = " << confirmation_key                 << endl;
+  cout << "  k_conf = " << getConfirmationKey()             << endl;
   cout << "Will expect the following confirmation key: \n"
-            << "  " << expected_key                         << endl;
+            << "  " << binaryToHexString(expected_key, 
+                                         confirmation_key_length, 
+                                         true)              << endl;
 }
 
 // ============================================================================
@@ -274,120 +293,158 @@ void Spake2::computeW(const std::string& pw)
 // ============================================================================
 void Spake2::computeGroupElement()
 {
-  mpz_t    h_x_or_y;
-  mpz_init(h_x_or_y);
+  const EllipticCurve& curve = cipher_suite.getCurve();
 
-  /// w{M/N}
-  const EllipticCurve::Point wM_or_N = 
-    cipher_suite.getCurve().scalarMultiplication(w, 
-      ( mode == Mode::CLIENT ) ? cipher_suite.getN() : cipher_suite.getM());
+  mpz_t h_x_or_y_w;
+  mpz_init(h_x_or_y_w);
 
-  /// (p{A/B} - w*{M/N}
-  const EllipticCurve::Point temp    = 
-    cipher_suite.getCurve().operate(
-      other_party_public_key, cipher_suite.getCurve().negatePoint(wM_or_N));
+  const std::vector<EllipticCurve::MultiplicationTerm> terms = 
+    getGroupElementTerms(h_x_or_y_w);
 
-  mpz_mul(h_x_or_y, cipher_suite.getCurve().getCofactor(), k_pri);
-  
-  K = cipher_suite.getCurve().scalarMultiplication(h_x_or_y, temp);
+#ifdef CONSTANT_TIME_SCALAR_MULTIPLICATION
+  /// K = {x/y}(hp{B/A}) - (h{x/y}w){N/M}, with both terms in constant time.
+  K = curve.completeOperate(
+    curve.constantTimeScalarMultiplication(k_pri,      *terms[0].point),
+    curve.constantTimeScalarMultiplication(h_x_or_y_w, *terms[1].point));
+#else
+  K = curve.multiScalarMultiplication(terms);
+#endif
 
-  mpz_clear(h_x_or_y);
+  mpz_clear(h_x_or_y_w);
 }
 
 // ============================================================================
-void Spake2::computeTranscript()
+std::vector<EllipticCurve::MultiplicationTerm> 
+Spake2::getGroupElementTerms(mpz_t h_x_or_y_w) const
 {
-  std::ostringstream ostr;
-  ostr << HEX_PREFIX_LOWERCASE;
-
-  const std::string this_kpub   = 
-    k_pub.getUncompressedFormat(
-      cipher_suite.getCurve().getFieldSizeBytes(), false);
-  
-  const std::string other_kpub  = 
-    other_party_public_key.getUncompressedFormat(
-      cipher_suite.getCurve().getFieldSizeBytes(), false);
+  const EllipticCurve& curve  = cipher_suite.getCurve();
+  const bool           client = ( mode == Mode::CLIENT );
+
+  /// -h{x/y}w mod n
+  mpz_mul(h_x_or_y_w, curve.getCofactor(), k_pri);
+  mpz_mul(h_x_or_y_w, h_x_or_y_w,          w);
+  mpz_neg(h_x_or_y_w, h_x_or_y_w);
+  mpz_mod(h_x_or_y_w, h_x_or_y_w,          curve.getOrder());
+
+  /** K = h{x/y}(p{B/A} - w{N/M}) = {x/y}(hp{B/A}) - (h{x/y}w){N/M}. The 
+      cofactor was cleared from p{B/A} when it was received, so both points 
+      have order n. N and M reuse their precomputed tables, and both terms 
+      share a single chain of doublings.
+  */
+  return
+  {
+    { k_pri, cleared_public_key },
+    { h_x_or_y_w, 
+      client ? cipher_suite.getN()      : cipher_suite.getM(), 
+      client ? cipher_suite.getNTable() : cipher_suite.getMTable() }
+  };
+}
 
-  const std::string K_str       =
-    K.getUncompressedFormat(cipher_suite.getCurve().getFieldSizeBytes(), false);
+// ============================================================================
+void Spake2::computeTranscript()
+{
+  const EllipticCurve& curve = cipher_suite.getCurve();
 
-  std::size_t       w_num_bytes = ( mpz_sizeinbase(w, 2) + 7 ) / 8;
+  transcript.    reset();
+  transcript_hex.clear();
 
   /// len(A) || A || len(B) || B || len(pA) || pA || len(pB) || pB
   if ( mode == Mode::CLIENT )
   {
-    ostr << padValueLittleEndian(getIdentity(). length(),                           8) << stringToAsciiHex(getIdentity())
-         << padValueLittleEndian(other_party_identity.length(),                     8) << stringToAsciiHex(other_party_identity)
-         << padValueLittleEndian(k_pub.getUncompressedByteCount(),                  8) << this_kpub
-         << padValueLittleEndian(other_party_public_key.getUncompressedByteCount(), 8) << other_kpub;
+    transcript.append     (getIdentity());
+    transcript.append     (other_party_identity);
+    transcript.appendPoint(curve, k_pub);
+    transcript.appendPoint(curve, other_party_public_key);
   }
   else
   {
-    ostr << padValueLittleEndian(other_party_identity.length(),                     8) << stringToAsciiHex(other_party_identity) 
-         << padValueLittleEndian(getIdentity(). length(),                           8) << stringToAsciiHex(getIdentity())
-         << padValueLittleEndian(other_party_public_key.getUncompressedByteCount(), 8) << other_kpub
-         << padValueLittleEndian(k_pub.getUncompressedByteCount(),                  8) << this_kpub;
+    transcript.append     (other_party_identity);
+    transcript.append     (getIdentity());
+    transcript.appendPoint(curve, other_party_public_key);
+    transcript.appendPoint(curve, k_pub);
   }
-  
-  /// || len(K) || K || len(w) || w
-  ostr << padValueLittleEndian(K.getUncompressedByteCount(), 8) << K_str;
-  ostr << padValueLittleEndian(w_num_bytes, 8)                  << padMpz(w, w_num_bytes * 2);
 
-  transcript.assign(ostr.str());
+  /// || len(K) || K || len(w) || w
+  transcript.appendPoint  (curve, K);
+  transcript.appendInteger(w);
 }
 
 // ============================================================================
 void Spake2::computeTranscriptHash()
 {
-  transcript_hash.assign(cipher_suite.getHashFunction()(transcript));
+  /// The digest was updated as each field of TT was appended.
+  transcript_hash_length = transcript.finishDigest(transcript_hash);
 
   /// Ke || Ka = Hash(TT), where |Ke| == |Ka|
-  splitHexStringInHalf(transcript_hash, 
-                     symmetric_secrets.Ke, 
-                     symmetric_secrets.Ka);
-
-  assert(symmetric_secrets.Ke.length() == symmetric_secrets.Ka.length());
+  symmetric_secrets.length = transcript_hash_length / 2u;
+  std::memcpy(symmetric_secrets.Ke, 
+              transcript_hash, 
+              symmetric_secrets.length);
+  std::memcpy(symmetric_secrets.Ka, 
+              transcript_hash + symmetric_secrets.length, 
+              symmetric_secrets.length);
 
   /// Keys MUST be at least 128 bits in length.
-  assert(symmetric_secrets.Ke.length() >= 128u / BITS_PER_BYTE);
+  assert(symmetric_secrets.length >= 128u / BITS_PER_BYTE);
 }
 
 // ============================================================================
 void Spake2::computeSharedSymmetricSecrets()
 { 
-  /// Both parties use Ka to derive shared symmetric secrets.
-  std::vector<unsigned char> Kc = hexStringToBytes(symmetric_secrets.Ka);
-  const std::string keys = 
-    cipher_suite.getKeyDerivationFunction()(
-    std::string(reinterpret_cast<const char*>(Kc.data()), Kc.size()), "ConfirmationKeys", 
-    addl_auth_data);
+  /// Both parties use Ka to derive KcA || KcB, each as long as Ka.
+  unsigned char     keys[MAX_DIGEST_BYTES];
+  const std::size_t key_length = symmetric_secrets.length;
+  cipher_suite.getKeyDerivationBytesFunction()(
+    symmetric_secrets.Ka, 
+    key_length, 
+    reinterpret_cast<const unsigned char*>(CONFIRMATION_KEYS_INFO), 
+    CONFIRMATION_KEYS_INFO_LENGTH,
+    reinterpret_cast<const unsigned char*>(addl_auth_data.data()), 
+    addl_auth_data.size(),
+    keys, 
+    2u * key_length);
 
   /// Split the KDF's output in half.
-  splitHexStringInHalf(keys, mac_keys.KcA, mac_keys.KcB);
-
-  assert(mac_keys.KcA.length() == mac_keys.KcB.length());
+  mac_keys.length = key_length;
+  std::memcpy(mac_keys.KcA, keys,              key_length);
+  std::memcpy(mac_keys.KcB, keys + key_length, key_length);
+  sodium_memzero(keys, sizeof(keys));
 
   /// Keys MUST be at least 128 bits in length.
-  assert(mac_keys.KcA.length() >= 128u / BITS_PER_BYTE);
-  assert(mac_keys.KcB.length() >= 128u / BITS_PER_BYTE);
+  assert(mac_keys.length >= 128u / BITS_PER_BYTE);
 }
 
 // ============================================================================
 void Spake2::computeKeyConfirmationMessage()
 {
-  confirmation_key.assign(HEX_PREFIX_LOWERCASE + cipher_suite.getMacFunction()(
-    ( mode == Mode::CLIENT ) ? mac_keys.KcA : mac_keys.KcB, transcript));
+  const MessageAuthenticationCodeBytesFunction& mac    = 
+    cipher_suite.getMacBytesFunction();
+  const std::vector<unsigned char>&             TT     = transcript.getBytes();
+  const bool                                    client = ( mode == Mode::CLIENT );
+
+  confirmation_key_length = 
+    mac(client ? mac_keys.KcA : mac_keys.KcB, mac_keys.length, 
+        TT.data(), TT.size(), confirmation_key);
 
   /// Precompute what we expect the other's confirmation key to be.
-  expected_key.    assign(HEX_PREFIX_LOWERCASE + cipher_suite.getMacFunction()( 
-    ( mode == Mode::CLIENT ) ? mac_keys.KcB : mac_keys.KcA, transcript));
+  mac(client ? mac_keys.KcB : mac_keys.KcA, mac_keys.length, 
+      TT.data(), TT.size(), expected_key);
 }
 
 // ============================================================================
 bool Spake2::checkProtocolComplete() const
 {
-  bool success = !expected_key.empty() &&
-                  expected_key == other_party_confirmation_key;
+  /// The other party's key is decoded, then compared in constant time.
+  unsigned char other_key[MAX_MAC_BYTES];
+  std::size_t   other_key_length = 0u;
+  const bool    success = 
+    confirmation_key_length > 0u &&
+    hexStringToBytes(other_party_confirmation_key, 
+                     other_key, 
+                     sizeof(other_key), 
+                     other_key_length) &&
+    other_key_length == confirmation_key_length &&
+    CRYPTO_memcmp(other_key, expected_key, confirmation_key_length) == 0;
 
   if ( success )
   {
@@ -396,7 +453,9 @@ bool Spake2::checkProtocolComplete() const
   else
   {
     std::cerr << "SPAKE2 failure. Confirmation keys do not match."      << endl;
-    std::cerr << "Expected key  : \n  " << expected_key                 << endl;
+    std::cerr << "Expected key  : \n  " 
+              << binaryToHexString(expected_key, confirmation_key_length, true)
+              << endl;
     std::cerr << "Actual key    : \n  " << other_party_confirmation_key << endl;
   }
   return success;
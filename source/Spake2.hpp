@@ -14,12 +14,18 @@
 #ifndef SPAKE_2_HPP
 #define SPAKE_2_HPP
 
+#include <cstddef>
 #include <string>
+#include <vector>
 
 #include "EllipticCurveConstants.hpp"
+#include "GmpArena.hpp"
 #include "HashFunctions.hpp"
+#include "MessageAuthenticationCodeFunctions.hpp"
 #include "Spake2CipherSuite.hpp"
 #include "Spake2Constants.hpp"
+#include "Spake2Transcript.hpp"
+#include "StringHelpers.hpp"
 
 #include <gmp.h>
 
@@ -42,8 +48,9 @@
     putPublicKeyOther() and readOtherPartiesConfirmationKey() can be substituted
     with putConfirmationKeyOther(). This skips the need to prompt for user input
     to ensure the other party has performed their appropriate stage.
-    Currently, this class is limited to the PAKE2-P256-SHA256-HKDF-HMAC
-    ciphersuite. Future iterations could benefit for a wider selection.
+    The SPAKE2-P256-SHA256-HKDF-HMAC, SPAKE2-Edwards25519-SHA256-HKDF-HMAC and
+    SPAKE2-secp256k1-SHA256-HKDF-HMAC ciphersuites are supported, selected by 
+    the curve.
 
     Motivation/Source : https://www.rfc-editor.org/rfc/rfc9382.html
  */
@@ -60,7 +67,9 @@ public:
       @param client Is this SPAKE2 instance operating as the client or server?
       If true, will operate as the client. NOTE, one instance of SPAKE2 must 
       be running as the server.
-      @param curve_name The elliptic curve to use. Defaults to P-256.
+      @param curve_name The elliptic curve to use. Defaults to P-256. 
+      edwards25519 is considerably faster, and should be preferred where 
+      both parties support it.
       @param hash_function The hash function to use. Defaults to SHA256.
       @param key_derivation_function The key derivation function (KDF) to use.
       Defaults to HKDF.
@@ -82,15 +91,43 @@ public:
   /// @brief The MAC keys are expressed as KcA || KcB
   struct MacKeys
   {
-    std::string KcA;
-    std::string KcB;
+    /// @brief The length of each key, in bytes.
+    std::size_t   length;
+    unsigned char KcA[MAX_DIGEST_BYTES / 2];
+    unsigned char KcB[MAX_DIGEST_BYTES / 2];
+
+    /// @brief Format KcA in hex, with the "0x" prefix.
+    std::string getKcAHex() const
+    {
+      return binaryToHexString(KcA, length, true);
+    }
+
+    /// @brief Format KcB in hex, with the "0x" prefix.
+    std::string getKcBHex() const
+    {
+      return binaryToHexString(KcB, length, true);
+    }
   };
 
   /// @brief The symmetric secrets are expressed as Ke || Ka
   struct SymmetricSecrets
   {
-    std::string Ka;
-    std::string Ke;
+    /// @brief The length of each key, in bytes.
+    std::size_t   length;
+    unsigned char Ka[MAX_DIGEST_BYTES / 2];
+    unsigned char Ke[MAX_DIGEST_BYTES / 2];
+
+    /// @brief Format Ka in hex, with the "0x" prefix.
+    std::string getKaHex() const
+    {
+      return binaryToHexString(Ka, length, true);
+    }
+
+    /// @brief Format Ke in hex, with the "0x" prefix.
+    std::string getKeHex() const
+    {
+      return binaryToHexString(Ke, length, true);
+    }
   };
 
   /** Accessor for this instance's identity.
@@ -125,21 +162,37 @@ public:
   */
   std::string getUncompressedPublicKey() const;
 
+  /** Accessor for the public key (pA/pB) in the curve's standard encoding, 
+      as written for the other party and into the transcript: SEC1 
+      uncompressed for P-256, RFC 8032 for edwards25519.
+      Should not be called until after setupPhase().
+      @return The encoded public key.
+  */
+  std::string getEncodedPublicKey() const;
+
+  /** Accessor for the SEC1 compressed public key (pA/pB), half the size of 
+      the uncompressed key. readOtherPartiesPublicKey() accepts either form.
+      Should not be called until after setupPhase().
+      @return The compressed public key.
+  */
+  std::string getCompressedPublicKey() const;
+
   /** Accessor for the uncompressed group element, K.
       Should not be called until after setupPhase().
       @return Const-reference to the group element.
   */
   std::string getUncompressedGroupElement() const;
 
-  /** Accessor for the transcript, TT. 
+  /** Accessor for the transcript, TT, in hex. The hex is only produced on 
+      the first call after each keyDerivationPhase().
       @return Const-reference to the transcript.
   */
   const std::string& getTranscript() const;
 
   /** Accessor for the Hash of the transcript, Hash(TT).
-      @return Const-reference to the hash of the transcript.
+      @return The hash of the transcript, in hex.
   */
-  const std::string& getTranscriptHash() const;
+  std::string getTranscriptHash() const;
 
   /** Accessor for the shared symmetric secrets, Ke and Ka.
       @return Const-reference to the shared symmetric secrets.
@@ -151,10 +204,10 @@ public:
   */
   const MacKeys& getMacKeys() const;
 
-  /** Accessor for the MAC Keys, KcA and KcB.
-     @return Const-reference to the MAC Keys.
+  /** Accessor for the confirmation key, cA/cB, as sent to the other party.
+     @return The confirmation key, in hex.
   */
-  const std::string& getConfirmationKey() const;
+  std::string getConfirmationKey() const;
 
 #if defined CMAKE_TESTING_ENABLED
   /** Mutator for the private key. Should only be used in testing environments.
@@ -170,7 +223,8 @@ public:
 
   /** Execute the setup phase for Spake2. This is considered to be the first
       step in the Spake2 protocl. The setup phase consists of computing public 
-      keys, pA and pB, and transmitting to the other party.
+      keys, pA and pB, and transmitting to the other party. GMP allocates from
+      the thread's GmpArena, if installed, for the duration of the phase.
    */
   void setupPhase();
 
@@ -190,6 +244,8 @@ public:
 
   /** Execute the second phase of Spake2, the key derivation phase. This phase
       relies on having had received the other party's public key, pA or pB.
+      GMP allocates from the thread's GmpArena, if installed, for the duration
+      of the phase.
    */
   void keyDerivationPhase();
 
@@ -232,7 +288,8 @@ private:
   /// @brief This instances' mode of operation. Either CLIENT or SERVER.
   Mode                    mode;
   
-  const Spake2CipherSuite cipher_suite;
+  /// @brief The shared Ciphersuite for this instance.
+  const Spake2CipherSuite& cipher_suite;
 
   /// @brief A hash of the password, pw.
   mpz_t w;
@@ -240,8 +297,11 @@ private:
   /// @brief Private Key.
   mpz_t xy;
 
-  /// @brief Should be in [0, p)
+  /// @brief Should be in [1, n)
   mpz_t k_pri;
+
+  /// @brief {x/y}P, if taken from a KeySharePool. Otherwise at infinity.
+  EllipticCurve::Point key_share;
   
   /// @brief Publically-accessible public key. pA/pB
   EllipticCurve::Point k_pub;
@@ -249,11 +309,15 @@ private:
   /// @brief Publically-accessible group element. Ka/Kb
   EllipticCurve::Point K;
 
-  /// @brief The transcript, TT
-  std::string transcript;
+  /// @brief The transcript, TT, and the digest of it.
+  Spake2Transcript transcript;
+
+  /// @brief The hex of TT, produced by getTranscript() on first use.
+  mutable std::string transcript_hex;
 
   /// @brief The hash of the transcript, Hash(TT).
-  std::string transcript_hash;
+  unsigned char transcript_hash[MAX_DIGEST_BYTES];
+  std::size_t   transcript_hash_length;
 
   /// @brief Shared symmetric secrets.
   SymmetricSecrets symmetric_secrets;
@@ -265,16 +329,22 @@ private:
   std::string          addl_auth_data;
 
   /// @brief The confirmation key, cA/cB
-  std::string          confirmation_key;
+  unsigned char        confirmation_key[MAX_MAC_BYTES];
 
   /// @brief The expected confirmation key from the other party.
-  std::string          expected_key;
+  unsigned char        expected_key[MAX_MAC_BYTES];
+
+  /// @brief The length of both confirmation keys, in bytes.
+  std::size_t          confirmation_key_length;
 
   /// @brief Components of the other party's key derivation.
   std::string          other_party_identity;
   EllipticCurve::Point other_party_public_key;
   std::string          other_party_confirmation_key;
 
+  /// @brief hp{B/A}, the other party's public key with its cofactor cleared.
+  EllipticCurve::Point cleared_public_key;
+
   /** Compute the shared integer, w, using a Memory Hard Function to prevent
       brute-force attacks. The currently chosen Memory Hard Function is the 
       default libsodium algorithm, crypto_pwhash_ALG_DEFAULT. A constant salt
@@ -284,9 +354,24 @@ private:
   */
   void computeW(const std::string& pw);
 
-  /// Compute the public key, pA / pB, using w, M/N and X/Y. Done in setup phase.
+  /** Compute the public key, pA / pB, using w, M/N and X/Y, or the key share 
+      if one was taken from a KeySharePool. Done in setup phase.
+  */
   void computePublicKey();
 
+  /** Build the terms of the public key, p{A/B} = {x/y}P + w{M/N}.
+      @return The (scalar, point) pairs to sum.
+  */
+  std::vector<EllipticCurve::MultiplicationTerm> getPublicKeyTerms() const;
+
+  /** Build the terms of the group element, 
+      K = {x/y}(hp{B/A}) - (h{x/y}w){N/M}.
+      @param h_x_or_y_w Storage for -h{x/y}w mod n. Must be initialized.
+      @return The (scalar, point) pairs to sum, which refer to h_x_or_y_w.
+  */
+  std::vector<EllipticCurve::MultiplicationTerm> 
+  getGroupElementTerms(mpz_t h_x_or_y_w) const;
+
   /** Compute the transcript, TT. The transcript is defined as
       TT = len(A)  || A
         || len(B)  || B
@@ -320,6 +405,9 @@ private:
   */
   void transmitConfirmationKey() const;
 
+  /// Spake2Batch runs the phases of many instances together.
+  friend class Spake2Batch;
+
   /// Both copy assignment and copy constructors are deleted.
   Spake2 operator=(const Spake2& object) = delete;
   Spake2          (const Spake2& object) = delete;
@@ -352,6 +440,7 @@ inline const std::string& Spake2::getOtherMode() const
 inline void Spake2::putPrivateKey(const std::string& key)
 {
   mpz_init_set_str(k_pri, key.c_str(), 0);
+  key_share = EllipticCurve::Point();
 }
 
 // ============================================================================
@@ -374,6 +463,19 @@ inline std::string Spake2::getUncompressedPublicKey() const
     k_pub.getUncompressedFormat(cipher_suite.getCurve().getFieldSizeBytes());
 }
 
+// ============================================================================
+inline std::string Spake2::getEncodedPublicKey() const
+{
+  return cipher_suite.getCurve().encodePoint(k_pub);
+}
+
+// ============================================================================
+inline std::string Spake2::getCompressedPublicKey() const
+{
+  return 
+    k_pub.getCompressedFormat(cipher_suite.getCurve().getFieldSizeBytes());
+}
+
 // ============================================================================
 inline std::string Spake2::getUncompressedGroupElement() const
 {
@@ -384,13 +486,17 @@ inline std::string Spake2::getUncompressedGroupElement() const
 // ============================================================================
 inline const std::string& Spake2::getTranscript() const
 {
-  return transcript;
+  if ( transcript_hex.empty() && !transcript.getBytes().empty() )
+  {
+    transcript_hex.assign(transcript.toHex());
+  }
+  return transcript_hex;
 }
 
 // ============================================================================
-inline const std::string& Spake2::getTranscriptHash() const
+inline std::string Spake2::getTranscriptHash() const
 {
-  return transcript_hash;
+  return binaryToHexString(transcript_hash, transcript_hash_length, true);
 }
 
 // ============================================================================
@@ -400,9 +506,9 @@ inline const Spake2::MacKeys& Spake2::getMacKeys() const
 }
 
 // ============================================================================
-inline const std::string& Spake2::getConfirmationKey() const
+inline std::string Spake2::getConfirmationKey() const
 {
-  return confirmation_key;
+  return binaryToHexString(confirmation_key, confirmation_key_length, true);
 }
 
 // ============================================================================
@@ -412,6 +518,7 @@ void Spake2::putPublicKeyOther(const std::string&          identity_other,
 {
   other_party_identity   = identity_other;
   other_party_public_key = public_key_other;
+  cleared_public_key     = cipher_suite.getCurve().clearCofactor(public_key_other);
 }
 
 // ============================================================================
@@ -431,6 +538,8 @@ const Spake2::SymmetricSecrets& Spake2::getSharedSymmetricSecrets() const
 // ============================================================================
 inline void Spake2::setupPhase()
 {
+  GmpArena::Scope arena_scope;
+
   computePublicKey();
   transmitPublicKey();
 }
@@ -438,6 +547,8 @@ inline void Spake2::setupPhase()
 // ============================================================================
 inline void Spake2::keyDerivationPhase()
 {
+  GmpArena::Scope arena_scope;
+
   /// Both A and B calculate the group element, K.
   computeGroupElement();
 
@@ -462,18 +573,53 @@ inline void Spake2::keyDerivationPhase()
 // ============================================================================
 inline void Spake2::computePublicKey()
 {
-  /// {X/Y} = {x/y}P;
-  const EllipticCurve::Point X_or_Y = 
-    cipher_suite.getCurve().
-      scalarMultiplication(k_pri, cipher_suite.getCurve().getGenerator());
-
-  /// w{M/N}
-  const EllipticCurve::Point wM_or_N = 
-  cipher_suite.getCurve().scalarMultiplication(w, 
-      ( mode == Mode::CLIENT ) ? cipher_suite.getM() : cipher_suite.getN());
-  
-  /// p{A/B} = w*{M/N} + X/Y
-  k_pub = cipher_suite.getCurve().operate(X_or_Y, wM_or_N);
+  const EllipticCurve& curve = cipher_suite.getCurve();
+
+  if ( !key_share.at_infinity )
+  {
+    /// {x/y}P came from a KeySharePool, which leaves w{M/N} and the sum.
+    const bool client = ( mode == Mode::CLIENT );
+#ifdef CONSTANT_TIME_SCALAR_MULTIPLICATION
+    k_pub = curve.completeOperate(key_share,
+      curve.constantTimeScalarMultiplication(
+        w, client ? cipher_suite.getM() : cipher_suite.getN()));
+#else
+    k_pub = curve.operate(key_share, 
+      client ? cipher_suite.multiplyM(w) : cipher_suite.multiplyN(w));
+#endif
+    return;
+  }
+
+  const std::vector<EllipticCurve::MultiplicationTerm> terms = 
+    getPublicKeyTerms();
+
+#ifdef CONSTANT_TIME_SCALAR_MULTIPLICATION
+  /// p{A/B} = {x/y}P + w{M/N}, with both secret scalars in constant time.
+  k_pub = curve.completeOperate(
+    curve.constantTimeScalarMultiplication(k_pri, *terms[0].point),
+    curve.constantTimeScalarMultiplication(w,     *terms[1].point));
+#else
+  k_pub = curve.multiScalarMultiplication(terms);
+#endif
+}
+
+// ============================================================================
+inline std::vector<EllipticCurve::MultiplicationTerm> 
+Spake2::getPublicKeyTerms() const
+{
+  const EllipticCurve& curve  = cipher_suite.getCurve();
+  const bool           client = ( mode == Mode::CLIENT );
+
+  /** p{A/B} = {x/y}P + w{M/N}. Both terms use precomputed tables, and share
+      a single chain of doublings.
+  */
+  return
+  {
+    { k_pri, curve.getGenerator(), curve.getGeneratorTable() },
+    { w,     
+      client ? cipher_suite.getM()      : cipher_suite.getN(), 
+      client ? cipher_suite.getMTable() : cipher_suite.getNTable() }
+  };
 }
 
 #endif
@@ -0,0 +1,150 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+
+#include "Spake2Batch.hpp"
+
+#include <memory>
+#include <stdexcept>
+
+#include "EllipticCurve.hpp"
+#include "GmpArena.hpp"
+
+#include <gmp.h>
+
+// ============================================================================
+Spake2Batch::Spake2Batch()
+  : sessions()
+{
+}
+
+// ============================================================================
+Spake2Batch::~Spake2Batch()
+{
+}
+
+// ============================================================================
+void Spake2Batch::addSession(Spake2& session)
+{
+  if ( !sessions.empty() && 
+       &sessions.front()->cipher_suite != &session.cipher_suite )
+  {
+    throw std::invalid_argument(
+      "Every session in a batch must use the same ciphersuite.");
+  }
+
+  sessions.push_back(&session);
+}
+
+// ============================================================================
+void Spake2Batch::setupPhase()
+{
+  if ( sessions.empty() )
+  {
+    return;
+  }
+
+  GmpArena::Scope arena_scope;
+
+#ifdef CONSTANT_TIME_SCALAR_MULTIPLICATION
+  /// The constant-time ladder returns affine points, so there is no sharing.
+  for ( Spake2* session : sessions )
+  {
+    session->computePublicKey();
+  }
+#else
+  /// Sessions with a pooled key share only have a single term left.
+  std::vector<Spake2*>                                        batched;
+  std::vector<std::vector<EllipticCurve::MultiplicationTerm>> batch;
+  batch.reserve(sessions.size());
+  for ( Spake2* session : sessions )
+  {
+    if ( !session->key_share.at_infinity )
+    {
+      session->computePublicKey();
+      continue;
+    }
+
+    batched.push_back(session);
+    batch.  push_back(session->getPublicKeyTerms());
+  }
+
+  if ( batch.empty() )
+  {
+    return;
+  }
+
+  const std::vector<EllipticCurve::Point> public_keys = 
+    sessions.front()->cipher_suite.getCurve().batchMultiScalarMultiplication(batch);
+
+  for ( std::size_t i = 0; i < batched.size(); ++i )
+  {
+    batched[i]->k_pub = public_keys[i];
+  }
+#endif
+}
+
+// ============================================================================
+void Spake2Batch::keyDerivationPhase()
+{
+  if ( sessions.empty() )
+  {
+    return;
+  }
+
+  GmpArena::Scope arena_scope;
+
+#ifdef CONSTANT_TIME_SCALAR_MULTIPLICATION
+  for ( Spake2* session : sessions )
+  {
+    session->computeGroupElement();
+  }
+#else
+  /// Each session's terms refer to its own scalar.
+  const std::size_t        num_scalars = sessions.size();
+  std::unique_ptr<mpz_t[]> scalars(new mpz_t[num_scalars]);
+  for ( std::size_t i = 0; i < num_scalars; ++i )
+  {
+    mpz_init(scalars[i]);
+  }
+
+  std::vector<std::vector<EllipticCurve::MultiplicationTerm>> batch;
+  batch.reserve(sessions.size());
+  for ( std::size_t i = 0; i < sessions.size(); ++i )
+  {
+    batch.push_back(
+      sessions[i]->getGroupElementTerms(scalars[i]));
+  }
+
+  const std::vector<EllipticCurve::Point> group_elements = 
+    sessions.front()->cipher_suite.getCurve().batchMultiScalarMultiplication(batch);
+
+  for ( std::size_t i = 0; i < sessions.size(); ++i )
+  {
+    sessions[i]->K = group_elements[i];
+  }
+
+  for ( std::size_t i = 0; i < num_scalars; ++i )
+  {
+    mpz_clear(scalars[i]);
+  }
+#endif
+
+  for ( Spake2* session : sessions )
+  {
+    session->computeTranscript();
+    session->computeTranscriptHash();
+    session->computeSharedSymmetricSecrets();
+    session->computeKeyConfirmationMessage();
+  }
+}
@@ -0,0 +1,85 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+
+#ifndef SPAKE_2_BATCH_HPP
+#define SPAKE_2_BATCH_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "Spake2.hpp"
+
+/** Runs the elliptic curve math of the SPAKE2 phases for many sessions 
+    together, e.g. for a server handling a burst of handshakes. The points of
+    every session are kept in projective coordinates, and converted to affine
+    coordinates with a single shared field inversion (Montgomery's trick) 
+    rather than one inversion per session. The results of each session are 
+    identical to those of its own setupPhase() and keyDerivationPhase().
+    Unlike those, nothing is written to file - public keys and confirmation 
+    keys are read through each session's accessors instead.
+    Sessions are not owned by the batch, and must outlive it.
+*/
+class Spake2Batch
+{
+public:
+
+  /// @brief Construct an empty batch.
+  Spake2Batch();
+
+  /// @brief The destructor does nothing.
+  ~Spake2Batch();
+
+  /** Add a session to the batch. Every session must use the same 
+      ciphersuite.
+      @param session The session to add.
+      @throw std::invalid_argument if the session's ciphersuite differs from 
+      the other sessions'.
+  */
+  void addSession(Spake2& session);
+
+  /** Accessor for the number of sessions in the batch.
+      @return The number of sessions.
+  */
+  std::size_t getNumSessions() const;
+
+  /** Compute the public key, pA / pB, of every session. Read each key with 
+      Spake2::getPublicKey().
+  */
+  void setupPhase();
+
+  /** Compute the group element, K, of every session, then derive each 
+      session's transcript, shared secrets and confirmation keys. Every 
+      session must already hold the other party's public key, see 
+      Spake2::putPublicKeyOther(). Read each confirmation key with 
+      Spake2::getConfirmationKey().
+  */
+  void keyDerivationPhase();
+
+private:
+
+  /// @brief The sessions in the batch, in the order they were added.
+  std::vector<Spake2*> sessions;
+
+  /// Both copy assignment and copy constructors are deleted.
+  Spake2Batch operator=(const Spake2Batch& object) = delete;
+  Spake2Batch          (const Spake2Batch& object) = delete;
+};
+
+// ============================================================================
+inline std::size_t Spake2Batch::getNumSessions() const
+{
+  return sessions.size();
+}
+
+#endif
@@ -13,6 +13,13 @@
 
 #include "Spake2CipherSuite.hpp"
 
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+#include "CurveArithmetic.hpp"
+
 #include "EllipticCurveConstants.hpp"
 #include "HashFunctions.hpp"
 #include "KeyDerivationFunctions.hpp"
@@ -26,15 +33,109 @@ Spake2CipherSuite(Curves                             curve,
                   MessageAuthenticationCodeFunctions mac_function)
   : M            (spake_2_parameters.at(curve).M),
     N            (spake_2_parameters.at(curve).N),
-    curve        (curve),
+    curve        (getSharedCurve(curve)),
     hash_function(hash_functions.at(hash_function)),
+    hash_bytes_function(hash_bytes_functions.at(hash_function)),
+    message_digest(::getMessageDigest(hash_function)),
     key_derivation_function(
       key_derivation_functions.at(key_derivation_function)),
-    mac_function(mac_functions.at(mac_function))
+    key_derivation_bytes_function(
+      key_derivation_bytes_functions.at(key_derivation_function)),
+    mac_function(mac_functions.at(mac_function)),
+    mac_bytes_function(mac_bytes_functions.at(mac_function)),
+    M_table     (this->curve.createFixedBaseTable(M, FIXED_BASE_TABLE_BYTES)),
+    N_table     (this->curve.createFixedBaseTable(N, FIXED_BASE_TABLE_BYTES))
 {
 }
 
 // ============================================================================
 Spake2CipherSuite::~Spake2CipherSuite()
 {
-}
\ No newline at end of file
+}
+
+// ============================================================================
+EllipticCurve::Point Spake2CipherSuite::multiplyM(const mpz_t& scalar) const
+{
+  if ( !M_table )
+  {
+    return curve.scalarMultiplication(scalar, M);
+  }
+
+  return curve.fixedBaseMultiplication(scalar, *M_table);
+}
+
+// ============================================================================
+EllipticCurve::Point Spake2CipherSuite::multiplyN(const mpz_t& scalar) const
+{
+  if ( !N_table )
+  {
+    return curve.scalarMultiplication(scalar, N);
+  }
+
+  return curve.fixedBaseMultiplication(scalar, *N_table);
+}
+
+// ============================================================================
+const Spake2CipherSuite& Spake2CipherSuite::
+getCipherSuite(Curves                             curve,
+               HashFunctions                      hash_function,
+               KeyDerivationFunctions             key_derivation_function,
+               MessageAuthenticationCodeFunctions mac_function)
+{
+  typedef std::tuple<Curves, 
+                     HashFunctions, 
+                     KeyDerivationFunctions, 
+                     MessageAuthenticationCodeFunctions> Key;
+
+  static std::mutex                                        mutex;
+  static std::map<Key, std::unique_ptr<Spake2CipherSuite>> cipher_suites;
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  std::unique_ptr<Spake2CipherSuite>& cipher_suite = cipher_suites[
+    Key(curve, hash_function, key_derivation_function, mac_function)];
+  if ( !cipher_suite )
+  {
+    cipher_suite.reset(new Spake2CipherSuite(curve, 
+                                             hash_function, 
+                                             key_derivation_function, 
+                                             mac_function));
+  }
+
+  return *cipher_suite;
+}
+
+// ============================================================================
+ArithmeticBackends Spake2CipherSuite::getPreferredArithmeticBackend(Curves curve)
+{
+  switch ( curve )
+  {
+    case Curves::P256:
+      return ArithmeticBackends::P256;
+    case Curves::EDWARDS25519:
+      return ArithmeticBackends::ED25519;
+    case Curves::SECP256K1:
+      return ArithmeticBackends::SECP256K1;
+    default:
+      return ArithmeticBackends::MPN;
+  }
+}
+
+// ============================================================================
+const EllipticCurve& Spake2CipherSuite::getSharedCurve(Curves curve)
+{
+  static std::mutex                                       mutex;
+  static std::map<Curves, std::unique_ptr<EllipticCurve>> curves;
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  std::unique_ptr<EllipticCurve>& shared_curve = curves[curve];
+  if ( !shared_curve )
+  {
+    shared_curve.reset(new EllipticCurve(curve, 
+                                         getPreferredArithmeticBackend(curve),
+                                         FIXED_BASE_TABLE_BYTES));
+  }
+
+  return *shared_curve;
+}
@@ -14,6 +14,7 @@
 #ifndef SPAKE_2_CIPHER_SUITE_HPP
 #define SPAKE_2_CIPHER_SUITE_HPP
 
+#include <memory>
 #include <string>
 
 #include "EllipticCurve.hpp"
@@ -23,7 +24,11 @@
 
 /** Class to represent a Ciphersuite for SPAKE2. A Ciphersuite is comprised of
     an Elliptic Curve, Hash Function, Key Derivation Function, and MAC function.
-    The currently supported CipherSuite is PAKE2-P256-SHA256-HKDF-HMAC
+    The currently supported CipherSuites are SPAKE2-P256-SHA256-HKDF-HMAC,
+    SPAKE2-Edwards25519-SHA256-HKDF-HMAC and SPAKE2-secp256k1-SHA256-HKDF-HMAC,
+    the last of which is not part of RFC 9382.
+    Ciphersuites precompute multiples of M and N, so sessions should share a 
+    single instance obtained from getCipherSuite().
 
     SPAKE2 Source       : https://www.rfc-editor.org/rfc/rfc9382.html
     Source of M/N Value : https://github.com/jiep/spake2plus/blob/main/spake2plus/ciphersuites/ciphersuites.py#L14
@@ -44,22 +49,20 @@ public:
                     KeyDerivationFunctions             key_derivation_function,
                     MessageAuthenticationCodeFunctions mac_function);
   
-  /// @brief The destructor does nothing.
+  /// @brief The destructor frees the precomputed tables.
   ~Spake2CipherSuite();
 
   /** Accessor for the Point Generation Point M.
       @return The M Point Generation Point.
-      @note This is currently fixed to the value of the point generation seed
-      for P-256 as given in the paper at the top of this class. The value of
-      the point of this seed was obtained from the second link at the top of this class.
+      @note M is the point generated from the seed for this Ciphersuite's 
+      curve, as listed in spake_2_parameters: RFC 9382's values for P-256 and
+      edwards25519, and the same procedure's output for secp256k1.
    */
   const EllipticCurve::Point& getM() const;
 
   /** Accessor for the Point Generation Point N.
       @return The N Point Generation Point.
-      @note This is currently fixed to the value of the point generation seed
-      for P-256 as given in the paper at the top of this class. The value of
-      the point of this seed was obtained from the second link at the top of this class.
+      @note N is generated per curve, in the same way as M.
   */
   const EllipticCurve::Point& getN() const;
 
@@ -73,34 +76,124 @@ public:
   */
   const HashFunction& getHashFunction() const;
 
+  /** Accessor for the byte-oriented form of this Ciphersuite's Hash Function.
+      @return Const-reference to the chosen Hash Function.
+  */
+  const HashBytesFunction& getHashBytesFunction() const;
+
+  /** Accessor for the OpenSSL digest of this Ciphersuite's Hash Function, 
+      used to hash the transcript as it is built.
+      @return The OpenSSL message digest.
+  */
+  const EVP_MD* getMessageDigest() const;
+
   /** Accessor for this Ciphersuite's Key Derivation Function.
       @return Const-reference to the chosen Key Derivation Function.
   */
   const KeyDerivationFunction& getKeyDerivationFunction() const;
 
+  /** Accessor for the byte-oriented form of this Ciphersuite's Key 
+      Derivation Function.
+      @return Const-reference to the chosen Key Derivation Function.
+  */
+  const KeyDerivationBytesFunction& getKeyDerivationBytesFunction() const;
+
   /** Accessor for this Ciphersuite's MAC Function.
       @return Const-reference to the chosen MAC Function.
   */
   const MessageAuthenticationCodeFunction& getMacFunction() const;
 
+  /** Accessor for the byte-oriented form of this Ciphersuite's MAC Function.
+      @return Const-reference to the chosen MAC Function.
+  */
+  const MessageAuthenticationCodeBytesFunction& getMacBytesFunction() const;
+
+  /** Multiply the blinding point M by a scalar, using this Ciphersuite's 
+      precomputed table of M.
+      @param scalar The scalar to multiply M by.
+      @return scalar * M.
+  */
+  EllipticCurve::Point multiplyM(const mpz_t& scalar) const;
+
+  /** Multiply the blinding point N by a scalar, using this Ciphersuite's 
+      precomputed table of N.
+      @param scalar The scalar to multiply N by.
+      @return scalar * N.
+  */
+  EllipticCurve::Point multiplyN(const mpz_t& scalar) const;
+
+  /** Accessor for the precomputed table of M.
+      @return Pointer to the table of M, or nullptr if there is no table.
+  */
+  const FixedBaseTable* getMTable() const;
+
+  /** Accessor for the precomputed table of N.
+      @return Pointer to the table of N, or nullptr if there is no table.
+  */
+  const FixedBaseTable* getNTable() const;
+
+  /** Accessor for the process-wide instance of a Ciphersuite. Each 
+      Ciphersuite, along with its precomputed tables, is built once on first 
+      use and shared by every SPAKE2 session. Thread-safe.
+      @param curve The desired Elliptic Curve.
+      @param hash_function The desired Hash Function.
+      @param key_derivation_function The desired key derivation function.
+      @param mac_function The desired MAC function.
+      @return Const-reference to the shared Ciphersuite.
+  */
+  static const Spake2CipherSuite& 
+  getCipherSuite(Curves                             curve,
+                 HashFunctions                      hash_function,
+                 KeyDerivationFunctions             key_derivation_function,
+                 MessageAuthenticationCodeFunctions mac_function);
+
+  /** Select the fastest arithmetic backend available for a curve. Curves
+      without a dedicated backend use the generic mpn_ Montgomery arithmetic.
+      edwards25519 always uses libsodium, and secp256k1 its GLV endomorphism.
+      @param curve The desired Elliptic Curve.
+      @return The arithmetic backend to construct curve with.
+  */
+  static ArithmeticBackends getPreferredArithmeticBackend(Curves curve);
+
 protected:
 private:
 
+  /** Accessor for the process-wide instance of a curve. Each curve, along 
+      with its precomputed generator table, is built once on first use and 
+      shared by every Ciphersuite. Thread-safe.
+      @param curve The desired Elliptic Curve.
+      @return Const-reference to the shared Elliptic Curve.
+  */
+  static const EllipticCurve& getSharedCurve(Curves curve);
+
   /// @brief Blinding factors
   const EllipticCurve::Point M;
   const EllipticCurve::Point N;
 
   /// @brief The Elliptic Curve this Ciphersuite is using.
-  EllipticCurve                     curve;
+  const EllipticCurve&              curve;
 
   /// @brief The Hash Function this Ciphersuite is using.
-  HashFunction                      hash_function;
+  HashFunction                           hash_function;
+  HashBytesFunction                      hash_bytes_function;
+
+  /// @brief The OpenSSL digest of the Hash Function.
+  const EVP_MD*                          message_digest;
 
   /// @brief The Key Derivation Function this Ciphersuite is using.
-  KeyDerivationFunction             key_derivation_function; 
+  KeyDerivationFunction                  key_derivation_function; 
+  KeyDerivationBytesFunction             key_derivation_bytes_function; 
 
   /// @brief The MAC Function this Ciphersuite is using.
-  MessageAuthenticationCodeFunction mac_function;
+  MessageAuthenticationCodeFunction      mac_function;
+  MessageAuthenticationCodeBytesFunction mac_bytes_function;
+
+  /// @brief Precomputed multiples of the blinding factors. May be empty.
+  std::unique_ptr<FixedBaseTable>        M_table;
+  std::unique_ptr<FixedBaseTable>        N_table;
+
+  /// KeySharePool generates shares on the shared curve.
+  friend class KeySharePool;
 
   /// @brief Copy constructor and assignment operator are deleted.
   Spake2CipherSuite          (const Spake2CipherSuite& object) = delete;
@@ -118,6 +211,18 @@ inline const EllipticCurve::Point& Spake2CipherSuite::getN() const
   return N;
 }
 
+// ============================================================================
+inline const FixedBaseTable* Spake2CipherSuite::getMTable() const
+{
+  return M_table.get();
+}
+
+// ============================================================================
+inline const FixedBaseTable* Spake2CipherSuite::getNTable() const
+{
+  return N_table.get();
+}
+
 // ============================================================================
 inline const EllipticCurve& Spake2CipherSuite::getCurve() const
 {
@@ -130,6 +235,18 @@ inline const HashFunction& Spake2CipherSuite::getHashFunction() const
   return hash_function;
 }
 
+// ============================================================================
+inline const HashBytesFunction& Spake2CipherSuite::getHashBytesFunction() const
+{
+  return hash_bytes_function;
+}
+
+// ============================================================================
+inline const EVP_MD* Spake2CipherSuite::getMessageDigest() const
+{
+  return message_digest;
+}
+
 // ============================================================================
 inline 
 const KeyDerivationFunction& Spake2CipherSuite::getKeyDerivationFunction() const
@@ -137,10 +254,24 @@ const KeyDerivationFunction& Spake2CipherSuite::getKeyDerivationFunction() const
   return key_derivation_function;
 }
 
+// ============================================================================
+inline const KeyDerivationBytesFunction& 
+Spake2CipherSuite::getKeyDerivationBytesFunction() const
+{
+  return key_derivation_bytes_function;
+}
+
 // ============================================================================
 inline const 
 MessageAuthenticationCodeFunction& Spake2CipherSuite::getMacFunction() const
 {
   return mac_function;
 }
+
+// ============================================================================
+inline const MessageAuthenticationCodeBytesFunction& 
+Spake2CipherSuite::getMacBytesFunction() const
+{
+  return mac_bytes_function;
+}
 #endif
\ No newline at end of file
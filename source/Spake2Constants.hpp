@@ -14,6 +14,7 @@
 #ifndef SPAKE_2_CONSTANTS_HPP
 #define SPAKE_2_CONSTANTS_HPP
 
+#include <cstddef>
 #include <map>
 
 #include "Constants.hpp"
@@ -26,6 +27,13 @@ enum Mode
   NUM_MODES = 2
 };
 
+/** @brief The KDF info from which KcA || KcB are derived. The length 
+    excludes the terminating NUL.
+    @cite Section 4 of https://www.rfc-editor.org/rfc/rfc9382.html
+*/
+const char        CONFIRMATION_KEYS_INFO[]      = "ConfirmationKeys";
+const std::size_t CONFIRMATION_KEYS_INFO_LENGTH = sizeof(CONFIRMATION_KEYS_INFO) - 1u;
+
 struct Spake2Keys
 {
   const EllipticCurve::Point M;
@@ -35,6 +43,12 @@ struct Spake2Keys
 /** @brief Blinding factors for SPAKE2.
     Future iterations of SPAKE2 should self-derive them.
     @cite https://github.com/jiep/spake2plus/blob/main/spake2plus/ciphersuites/ciphersuites.py#L14
+    @cite Section 4 of https://www.rfc-editor.org/rfc/rfc9382.html for 
+    edwards25519, whose M and N are given there in their RFC 8032 encoding.
+    RFC 9382 does not cover secp256k1, so its M and N were generated with the
+    procedure of Appendix A of RFC 9382, from the seeds 
+    "1.3.132.0.10 point generation seed (M)" and "... (N)". The same 
+    procedure reproduces the P-256 values above.
 */
 const std::map<Curves, Spake2Keys> spake_2_parameters =
 {
@@ -47,6 +61,30 @@ const std::map<Curves, Spake2Keys> spake_2_parameters =
                            "3544368724946236282841049099645644789675854804295951046212527731618188549095",
                             Base::DECIMAL)
     }
+  },
+  { Curves::EDWARDS25519, 
+    {
+      /// d048032c6ea0b6d697ddc2e86bda85a33adac920f1bf18e1b0c6d166a5cecdaf
+      EllipticCurve::Point("1209a780fc26087daca42ec0daa539de37b3f303982c1c351bbd6949477e45e7",
+                           "2fcdcea566d1c6b0e118bff120c9da3aa385da6be8c2dd97d6b6a06e2c0348d0",
+                            Base::HEX),
+      /// d3bfb518f44f3430f29d0c92af503865a1ed3281dc69b35dd868ba85f886c4ab
+      EllipticCurve::Point("17bfe667f20f5a892b153c2f99906e4debc9087f0d3a99d89cb3af556c27fc23",
+                           "2bc486f885ba68d85db369dc8132eda1653850af920c9df230344ff418b5bfd3",
+                            Base::HEX)
+    }
+  },
+  { Curves::SECP256K1, 
+    {
+      /// 03296e6069e5be42770ff60d6068e506ed4a5e06cc532b0a1eac166ab1cb03e50e
+      EllipticCurve::Point("296e6069e5be42770ff60d6068e506ed4a5e06cc532b0a1eac166ab1cb03e50e",
+                           "f291182024707a3d4c9e436423bd24de98ea693b45f8da251db8bd62e1e052fb",
+                            Base::HEX),
+      /// 03d46f1cf3c35a2cc380866367cc79c3795724933868a30144cf73c2666c585b04
+      EllipticCurve::Point("d46f1cf3c35a2cc380866367cc79c3795724933868a30144cf73c2666c585b04",
+                           "e7fc17946da5beee5f78ec2b1557818fbdea881093442c5dcccba704280aa8fb",
+                            Base::HEX)
+    }
   }
 };
 
@@ -0,0 +1,139 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+
+#include "Spake2Transcript.hpp"
+
+#include <stdexcept>
+
+#include "MpzMathHelpers.hpp"
+#include "StringHelpers.hpp"
+
+namespace
+{
+  /// @brief The size of each length field, in bytes.
+  const std::size_t LENGTH_BYTES = 8u;
+}
+
+const std::size_t Spake2Transcript::RESERVED_BYTES;
+
+// ============================================================================
+Spake2Transcript::Spake2Transcript(const EVP_MD* message_digest)
+  : bytes         (),
+    message_digest(message_digest),
+    digest_context(EVP_MD_CTX_new())
+{
+  if ( digest_context == nullptr )
+  {
+    throw std::runtime_error("Failed to create the transcript digest.");
+  }
+
+  bytes.reserve(RESERVED_BYTES);
+  reset();
+}
+
+// ============================================================================
+Spake2Transcript::~Spake2Transcript()
+{
+  EVP_MD_CTX_free(digest_context);
+}
+
+// ============================================================================
+void Spake2Transcript::reset()
+{
+  bytes.clear();
+  if ( EVP_DigestInit_ex(digest_context, message_digest, nullptr) != 1 )
+  {
+    throw std::runtime_error("Failed to initialize the transcript digest.");
+  }
+}
+
+// ============================================================================
+void Spake2Transcript::append(const unsigned char* data, std::size_t length)
+{
+  writeLength(length);
+  write      (data, length);
+}
+
+// ============================================================================
+void Spake2Transcript::append(const std::string& text)
+{
+  append(reinterpret_cast<const unsigned char*>(text.data()), text.length());
+}
+
+// ============================================================================
+void Spake2Transcript::appendPoint(const EllipticCurve&        curve, 
+                                   const EllipticCurve::Point& P)
+{
+  unsigned char     encoded[MAX_ENCODED_POINT_BYTES];
+  const std::size_t length = curve.encodePointBytes(P, encoded);
+
+  writeLength(curve.getEncodedByteCount(P));
+  write      (encoded, length);
+}
+
+// ============================================================================
+void Spake2Transcript::appendInteger(const mpz_t& value)
+{
+  unsigned char     encoded[MAX_FIELD_SIZE_BYTES];
+  const std::size_t length = getMpzNumBytes(value);
+  if ( length > sizeof(encoded) )
+  {
+    throw std::invalid_argument("The integer is too large for the transcript.");
+  }
+
+  /// Zero has no limbs to export, but still takes one byte.
+  encoded[0] = 0u;
+  mpz_export(encoded, nullptr, 1, 1, 1, 0, value);
+  append(encoded, length);
+}
+
+// ============================================================================
+std::size_t Spake2Transcript::finishDigest(unsigned char* digest)
+{
+  unsigned int length = 0u;
+  if ( EVP_DigestFinal_ex(digest_context, digest, &length) != 1 )
+  {
+    throw std::runtime_error("Failed to finish the transcript digest.");
+  }
+  return length;
+}
+
+// ============================================================================
+std::string Spake2Transcript::toHex() const
+{
+  return HEX_PREFIX_LOWERCASE + binaryToHexString(bytes.data(), bytes.size());
+}
+
+// ============================================================================
+void Spake2Transcript::write(const unsigned char* data, std::size_t length)
+{
+  bytes.insert(bytes.end(), data, data + length);
+  if ( length > 0u && 
+       EVP_DigestUpdate(digest_context, data, length) != 1 )
+  {
+    throw std::runtime_error("Failed to update the transcript digest.");
+  }
+}
+
+// ============================================================================
+void Spake2Transcript::writeLength(std::size_t length)
+{
+  unsigned char length_bytes[LENGTH_BYTES];
+  for ( std::size_t i = 0; i < LENGTH_BYTES; ++i )
+  {
+    length_bytes[i] = static_cast<unsigned char>( 
+      ( static_cast<unsigned long long>(length) >> ( 8u * i ) ) & 0xffu );
+  }
+  write(length_bytes, LENGTH_BYTES);
+}
@@ -0,0 +1,128 @@
+/**                           888                .d8888b.  
+                              888               d88P  Y88b 
+                              888                      888 
+   .d8888b  88888b.   8888b.  888  888  .d88b.       .d88P 
+   88K      888 "88b     "88b 888 .88P d8P  Y8b  .od888P"  
+   "Y8888b. 888  888 .d888888 888888K  88888888 d88P"      
+        X88 888 d88P 888  888 888 "88b Y8b.     888"       
+    88888P' 88888P"  "Y888888 888  888  "Y8888  888888888  
+            888                                            
+            888                                            
+            888                                            
+*/
+
+
+#ifndef SPAKE_2_TRANSCRIPT_HPP
+#define SPAKE_2_TRANSCRIPT_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "EllipticCurve.hpp"
+
+#include <gmp.h>
+#include <openssl/evp.h>
+
+/** Builds the SPAKE2 transcript, TT, as raw bytes. Each field is appended as
+    len(field) || field, with the length in eight little-endian bytes, and is
+    fed to an incremental digest as it is appended, so Hash(TT) is ready as 
+    soon as the last field is. The bytes are kept in a buffer reserved up 
+    front, for the MACs over TT, and a hex view is only produced on request.
+*/
+class Spake2Transcript
+{
+public:
+
+  /// @brief The capacity reserved for the transcript, in bytes.
+  static const std::size_t RESERVED_BYTES = 512u;
+
+  /** Construct an empty transcript.
+      @param message_digest The hash function of the ciphersuite.
+      @throw std::runtime_error If the digest context cannot be created.
+  */
+  explicit Spake2Transcript(const EVP_MD* message_digest);
+
+  /// @brief The destructor frees the digest context.
+  ~Spake2Transcript();
+
+  /** Discard the transcript, and restart the digest.
+      @throw std::runtime_error If the digest fails to initialize.
+  */
+  void reset();
+
+  /** Append len(data) || data.
+      @param data The field to append.
+      @param length The length of data, in bytes.
+      @throw std::runtime_error If the digest fails.
+  */
+  void append(const unsigned char* data, std::size_t length);
+
+  /** Append len(text) || text, e.g. an identity.
+      @param text The field to append.
+      @throw std::runtime_error If the digest fails.
+  */
+  void append(const std::string& text);
+
+  /** Append a point in the curve's standard encoding. The length written is
+      EllipticCurve::getEncodedByteCount(), as in the RFC 9382 test vectors.
+      @param curve The curve of P.
+      @param P The point to append.
+      @throw std::runtime_error If the digest fails.
+  */
+  void appendPoint(const EllipticCurve& curve, const EllipticCurve::Point& P);
+
+  /** Append a non-negative integer in big-endian, in as few bytes as hold it.
+      @param value The integer to append.
+      @throw std::invalid_argument If value is longer than MAX_FIELD_SIZE_BYTES.
+      @throw std::runtime_error If the digest fails.
+  */
+  void appendInteger(const mpz_t& value);
+
+  /** Finish the digest of the transcript. No more fields may be appended 
+      until reset().
+      @param digest Set to Hash(TT). Must hold at least EVP_MAX_MD_SIZE bytes.
+      @return The length of the digest, in bytes.
+      @throw std::runtime_error If the digest fails.
+  */
+  std::size_t finishDigest(unsigned char* digest);
+
+  /** Accessor for the transcript.
+      @return Const-reference to the bytes of TT.
+  */
+  const std::vector<unsigned char>& getBytes() const;
+
+  /** Format the transcript in hex.
+      @return TT in lowercase hex, with the "0x" prefix.
+  */
+  std::string toHex() const;
+
+private:
+
+  /// @brief The bytes of the transcript.
+  std::vector<unsigned char> bytes;
+
+  /// @brief The hash function of the ciphersuite.
+  const EVP_MD*              message_digest;
+
+  /// @brief The digest of the bytes appended so far.
+  EVP_MD_CTX*                digest_context;
+
+  /// @brief Append raw bytes, without a length.
+  void write(const unsigned char* data, std::size_t length);
+
+  /// @brief Append a length in eight little-endian bytes.
+  void writeLength(std::size_t length);
+
+  /// Both copy assignment and copy constructors are deleted.
+  Spake2Transcript operator=(const Spake2Transcript& object) = delete;
+  Spake2Transcript          (const Spake2Transcript& object) = delete;
+};
+
+// ============================================================================
+inline const std::vector<unsigned char>& Spake2Transcript::getBytes() const
+{
+  return bytes;
+}
+
+#endif
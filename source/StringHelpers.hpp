@@ -157,4 +157,52 @@ inline std::vector<unsigned char> hexStringToBytes(const std::string& input)
   return underlying_bytes;
 }
 
+/** Decode a Hex-encoded string into a buffer provided by the caller, without
+    allocating. The input may or may not start with the Hex identifier "0x" or
+    "0X".
+    @param input The Hex-encoded string to decode.
+    @param output The buffer to write the bytes encoded by input to.
+    @param capacity The size of output, in bytes.
+    @param length Set to the number of bytes written to output.
+    @return True if input held an even number of hex digits, which fit in 
+    output.
+ */
+inline bool hexStringToBytes(const std::string& input, 
+                             unsigned char*     output,
+                             std::size_t        capacity,
+                             std::size_t&       length)
+{
+  length = 0;
+
+  /// Skip the leading 0x prefix if it exists.
+  const std::size_t start = ( input.rfind(HEX_PREFIX_LOWERCASE) == 0 || 
+                              input.rfind(HEX_PREFIX_UPPERCASE) == 0 ) 
+                            ? HEX_PREFIX_LEN 
+                            : 0;
+
+  if ( ( input.length() - start ) % 2 != 0 || 
+       ( input.length() - start ) / 2 > capacity )
+  {
+    return false;
+  }
+
+  for ( std::size_t i = start; i < input.length(); i += 2 )
+  {
+    int nibbles[2];
+    for ( std::size_t j = 0; j < 2; ++j )
+    {
+      const char c = input[i + j];
+      nibbles[j] = ( c >= '0' && c <= '9' ) ? c - '0'      :
+                   ( c >= 'a' && c <= 'f' ) ? c - 'a' + 10 :
+                   ( c >= 'A' && c <= 'F' ) ? c - 'A' + 10 : -1;
+      if ( nibbles[j] < 0 )
+      {
+        return false;
+      }
+    }
+    output[length++] = static_cast<unsigned char>(nibbles[0] * 16 + nibbles[1]);
+  }
+  return true;
+}
+
 #endif
\ No newline at end of file
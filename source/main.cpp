@@ -27,6 +27,9 @@ int main(int argc, char* argv[])
   /// The shared password between both parties. 
   std::string shared_password               = "";
 
+  /// Both parties must use the same curve.
+  Curves curve                              = Curves::P256;
+
   for ( int arg = 1; arg < argc; ++arg )
   {
     const std::string argument = argv[arg];
@@ -47,6 +50,25 @@ int main(int argc, char* argv[])
     {
       shared_password = argv[++arg];
     }
+    else if ( ( argument == "-c" || argument == "-curve" ) && 
+              ( arg + 1 < argc ) )
+    {
+      const std::string curve_name = argv[++arg];
+      bool              found      = false;
+      for ( const auto& parameters : curve_parameters )
+      {
+        if ( curve_name == parameters.second.name )
+        {
+          curve = parameters.first;
+          found = true;
+        }
+      }
+
+      if ( !found )
+      {
+        displayUsage(argv[0]);
+      }
+    }
     else if ( ( argument == "-h" ) || ( argument == "-help" ) )
     {
       displayUsage(argv[0]);
@@ -61,7 +83,8 @@ int main(int argc, char* argv[])
   Spake2 spake2(identity, 
                 shared_password, 
                 client_mode, 
-                additional_authenticated_data);
+                additional_authenticated_data,
+                curve);
 
   /// The private key and password should be set before setupPhase().
   spake2.setupPhase();
@@ -96,6 +119,9 @@ Options:
   -aad <data>               Optional. Provide additional authentication data for
                             key derivation. If specified, both parties must use 
                             the same value.
+  -c, -curve <curve>        Optional. The curve to use, one of "P-256" (the 
+                            default), "edwards25519" or "secp256k1". 
+                            Both parties must use the same curve.
 Examples:
 )" << exec_name << R"( -s -pw foo 
       Runs SPAKE2 in server mode, with the password "foo".
@@ -105,6 +131,9 @@ Examples:
 
 )" << exec_name << R"( -s -i server -aad foo -pw bar
       Runs SPAKE2 using identity "server" and shared AAD "foo", with the password "bar".
+
+)" << exec_name << R"( -c edwards25519 -pw bar
+      Runs SPAKE2 in client mode over edwards25519, with the password "bar".
       
 Notes:
   - The pw value must be identical for both parties exercising SPAKE2.
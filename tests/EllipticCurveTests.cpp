@@ -1,6 +1,11 @@
 #include <gtest/gtest.h>
 
+#include "CurveArithmetic.hpp"
+#include "CurveTraits.hpp"
 #include "EllipticCurve.hpp"
+#include "MpzField.hpp"
+#include "Secp256k1Arithmetic.hpp"
+#include "Spake2Constants.hpp"
 
 // ============================================================================
 TEST(EllipticCurveTests, TestDoubleAndAdd)
@@ -21,3 +26,776 @@ TEST(EllipticCurveTests, TestDoubleAndAdd)
     ASSERT_TRUE(curve.scalarMultiplication(i, P) == expected_values[i - 1]);
   }
 }
+
+// ============================================================================
+TEST(EllipticCurveTests, TestOperateWithNegation)
+{
+  EllipticCurve        curve("foo", 2, 2, 17, 1, 21, 2);
+  EllipticCurve::Point P(5, 1);
+  
+  const EllipticCurve::Point negative_P = curve.negatePoint(P);
+
+  ASSERT_TRUE(negative_P == EllipticCurve::Point(5, 16));
+  ASSERT_TRUE(curve.operate(P, negative_P).at_infinity);
+  ASSERT_TRUE(curve.operate(P, P) == curve.scalarMultiplication(2, P));
+}
+
+// ============================================================================
+TEST(EllipticCurveTests, TestCompleteOperateMatchesOperate)
+{
+  gmp_randstate_t random_state;
+  gmp_randinit_default(random_state);
+  gmp_randseed_ui     (random_state, 256ul);
+
+  mpz_t scalar;
+  mpz_init(scalar);
+
+  const EllipticCurve::Point infinity;
+
+  for ( ArithmeticBackends backend : { ArithmeticBackends::MPZ, 
+                                       ArithmeticBackends::MPN,
+                                       ArithmeticBackends::P256 } )
+  {
+    const EllipticCurve         curve(Curves::P256, backend);
+    const EllipticCurve::Point& G = curve.getGenerator();
+
+    for ( unsigned int i = 0; i < 4u; ++i )
+    {
+      mpz_urandomm(scalar, random_state, curve.getOrder());
+      const EllipticCurve::Point P = curve.scalarMultiplication(scalar, G);
+
+      ASSERT_TRUE(curve.completeOperate(P, G) == curve.operate(P, G));
+      ASSERT_TRUE(curve.completeOperate(P, P) == curve.operate(P, P));
+      ASSERT_TRUE(curve.completeOperate(P, infinity) == P);
+      ASSERT_TRUE(curve.completeOperate(infinity, P) == P);
+      ASSERT_TRUE(curve.completeOperate(P, curve.negatePoint(P)).at_infinity);
+    }
+    ASSERT_TRUE(curve.completeOperate(infinity, infinity).at_infinity);
+  }
+
+  /// The toy curve has odd order, while a cofactor of 2 allows y = 0.
+  const EllipticCurve        toy_curve("foo", 2, 2, 17, 1, 21, 2);
+  const EllipticCurve        even_curve("foo", 2, 2, 17, 2, 21, 2);
+  const EllipticCurve::Point toy_P(5, 1);
+  ASSERT_TRUE(toy_curve.completeOperate(toy_P, toy_P) == EllipticCurve::Point(6, 3));
+  ASSERT_THROW(even_curve.completeOperate(toy_P, toy_P), std::runtime_error);
+
+  mpz_clear(scalar);
+  gmp_randclear(random_state);
+}
+
+// ============================================================================
+TEST(EllipticCurveTests, TestMpnBackendOnToyCurve)
+{
+  EllipticCurve        curve("foo", 2, 2, 17, 1, 21, 2, ArithmeticBackends::MPN);
+  EllipticCurve::Point P(5, 1);
+
+  ASSERT_TRUE(curve.scalarMultiplication(7, P) == EllipticCurve::Point(0, 6));
+  ASSERT_TRUE(curve.negatePoint(P)             == EllipticCurve::Point(5, 16));
+  ASSERT_TRUE(curve.operate(P, P)              == EllipticCurve::Point(6, 3));
+  ASSERT_TRUE(curve.operate(P, curve.negatePoint(P)).at_infinity);
+}
+
+// ============================================================================
+TEST(EllipticCurveTests, TestMinusThreeToyCurve)
+{
+  /// y^2 = x^3 - 3x + 1 over F_23, of prime order 23.
+  const unsigned int         num_tests = 22u;
+  const EllipticCurve::Point P(0, 1);
+
+  const EllipticCurve::Point expected_values[num_tests] =
+  {
+    { 0,  1}, { 8, 11}, {18, 11}, { 9, 17}, {20, 12}, {19, 15}, {22,  7}, 
+    {14, 14}, { 2,  7}, { 7,  1}, {16, 22}, {16,  1}, { 7, 22}, { 2, 16}, 
+    {14,  9}, {22, 16}, {19,  8}, {20, 11}, { 9,  6}, {18, 12}, { 8, 12}, 
+    { 0, 22}
+  };
+
+  for ( ArithmeticBackends backend : { ArithmeticBackends::MPZ, 
+                                       ArithmeticBackends::MPN } )
+  {
+    EllipticCurve curve("foo", 20, 1, 23, 1, 23, 1, backend);
+
+    for ( unsigned int i = 1; i <= num_tests; ++i )
+    {
+      ASSERT_TRUE(curve.scalarMultiplication(i, P) == expected_values[i - 1]);
+      ASSERT_TRUE(curve.operate(expected_values[i - 1], P) == 
+                  curve.scalarMultiplication(i + 1, P));
+    }
+    ASSERT_TRUE(curve.scalarMultiplication(23, P).at_infinity);
+  }
+}
+
+// ============================================================================
+TEST(EllipticCurveTests, TestBackendsMatchMpzBackend)
+{
+  EllipticCurve mpz_curve (Curves::P256, ArithmeticBackends::MPZ);
+  EllipticCurve mpn_curve (Curves::P256, ArithmeticBackends::MPN);
+  EllipticCurve p256_curve(Curves::P256, ArithmeticBackends::P256);
+
+  gmp_randstate_t random_state;
+  gmp_randinit_default(random_state);
+  gmp_randseed_ui     (random_state, 256ul);
+
+  mpz_t scalar;
+  mpz_init(scalar);
+
+  EllipticCurve::Point P = mpz_curve.getGenerator();
+
+  for ( unsigned int i = 0; i < 8u; ++i )
+  {
+    mpz_urandomm(scalar, random_state, mpz_curve.getOrder());
+
+    const EllipticCurve::Point expected = 
+      mpz_curve.scalarMultiplication(scalar, P);
+
+    ASSERT_TRUE(expected == mpn_curve. scalarMultiplication(scalar, P));
+    ASSERT_TRUE(expected == p256_curve.scalarMultiplication(scalar, P));
+    ASSERT_TRUE(mpz_curve. operate(expected, P) == 
+                mpn_curve. operate(expected, P));
+    ASSERT_TRUE(mpz_curve. operate(expected, P) == 
+                p256_curve.operate(expected, P));
+    ASSERT_TRUE(mpz_curve. negatePoint(expected) == 
+                mpn_curve. negatePoint(expected));
+    ASSERT_TRUE(mpz_curve. negatePoint(expected) == 
+                p256_curve.negatePoint(expected));
+    P = expected;
+  }
+
+  /// n * G is the point at infinity.
+  ASSERT_TRUE(mpn_curve.scalarMultiplication(
+    mpn_curve.getOrder(), mpn_curve.getGenerator()).at_infinity);
+  ASSERT_TRUE(p256_curve.scalarMultiplication(
+    p256_curve.getOrder(), p256_curve.getGenerator()).at_infinity);
+
+  mpz_clear(scalar);
+  gmp_randclear(random_state);
+}
+
+// ============================================================================
+TEST(EllipticCurveTests, TestFixedBaseMultiplicationMatchesScalarMultiplication)
+{
+  const ArithmeticBackends backends[]     = { ArithmeticBackends::MPZ, 
+                                              ArithmeticBackends::MPN, 
+                                              ArithmeticBackends::P256 };
+  const std::size_t        budget_bytes[] = { 0u, 100u, 4096u, 65536u };
+
+  gmp_randstate_t random_state;
+  gmp_randinit_default(random_state);
+  gmp_randseed_ui     (random_state, 256ul);
+
+  mpz_t scalar;
+  mpz_init(scalar);
+
+  for ( const ArithmeticBackends backend : backends )
+  {
+    for ( const std::size_t budget : budget_bytes )
+    {
+      EllipticCurve curve(Curves::P256, backend, budget);
+      ASSERT_LE(curve.getGeneratorTableBytes(), budget);
+
+      for ( unsigned int i = 0; i < 8u; ++i )
+      {
+        /// 0, n - 1, n, n + 1, a value larger than p, then random scalars.
+        switch ( i )
+        {
+          case 0:  mpz_set_ui  (scalar, 0ul);                          break;
+          case 1:  mpz_sub_ui  (scalar, curve.getOrder(),        1ul); break;
+          case 2:  mpz_set     (scalar, curve.getOrder());             break;
+          case 3:  mpz_add_ui  (scalar, curve.getOrder(),        1ul); break;
+          case 4:  mpz_mul_2exp(scalar, curve.getPrimeModulus(), 3ul); break;
+          default: mpz_urandomm(scalar, random_state, curve.getOrder());
+        }
+
+        ASSERT_TRUE(curve.fixedBaseMultiplication(scalar) == 
+                    curve.scalarMultiplication(scalar, curve.getGenerator()));
+      }
+    }
+  }
+
+  mpz_clear(scalar);
+  gmp_randclear(random_state);
+}
+
+// ============================================================================
+TEST(EllipticCurveTests, TestFixedBaseTableForArbitraryPoint)
+{
+  EllipticCurve        curve(Curves::P256, ArithmeticBackends::P256);
+  EllipticCurve::Point base = curve.scalarMultiplication(12345u, 
+                                                         curve.getGenerator());
+
+  std::unique_ptr<FixedBaseTable> table(curve.createFixedBaseTable(base, 
+                                                                   8192u));
+  ASSERT_TRUE(table != nullptr);
+  ASSERT_LE(table->getSizeBytes(), 8192u);
+  ASSERT_TRUE(curve.createFixedBaseTable(EllipticCurve::Point(), 8192u) == 
+              nullptr);
+
+  mpz_t scalar;
+  mpz_init_set_str(scalar, "deadbeefcafef00d0123456789abcdef", 16);
+  ASSERT_TRUE(curve.fixedBaseMultiplication(scalar, *table) == 
+              curve.scalarMultiplication(scalar, base));
+  mpz_clear(scalar);
+}
+
+// ============================================================================
+TEST(EllipticCurveTests, TestMultiScalarMultiplication)
+{
+  const ArithmeticBackends backends[] = { ArithmeticBackends::MPZ, 
+                                          ArithmeticBackends::MPN, 
+                                          ArithmeticBackends::P256 };
+
+  gmp_randstate_t random_state;
+  gmp_randinit_default(random_state);
+  gmp_randseed_ui     (random_state, 256ul);
+
+  mpz_t k1;
+  mpz_t k2;
+  mpz_t k3;
+  mpz_inits(k1, k2, k3, nullptr);
+
+  for ( const ArithmeticBackends backend : backends )
+  {
+    EllipticCurve              curve(Curves::P256, backend, 4096u);
+    const EllipticCurve::Point P = 
+      curve.scalarMultiplication(7u, curve.getGenerator());
+    const EllipticCurve::Point infinity;
+
+    std::unique_ptr<FixedBaseTable> table(curve.createFixedBaseTable(P, 4096u));
+
+    for ( unsigned int i = 0; i < 4u; ++i )
+    {
+      mpz_urandomm(k1, random_state, curve.getOrder());
+      mpz_urandomm(k2, random_state, curve.getOrder());
+
+      const EllipticCurve::Point expected = curve.operate(
+        curve.operate(curve.fixedBaseMultiplication(k1), 
+                      curve.scalarMultiplication(k2, P)),
+        curve.negatePoint(curve.scalarMultiplication(k2, curve.getGenerator())));
+
+      /// k3 = -k2, applied to G both with and without its table.
+      mpz_neg(k3, k2);
+      ASSERT_TRUE(expected == curve.multiScalarMultiplication(
+        { { k1, curve.getGenerator(), curve.getGeneratorTable() },
+          { k2, P,                    table.get()               },
+          { k3, curve.getGenerator()                            },
+          { k2, infinity                                        } }));
+      ASSERT_TRUE(expected == curve.multiScalarMultiplication(
+        { { k1, curve.getGenerator()                            },
+          { k2, P                                               },
+          { k3, curve.getGenerator(), curve.getGeneratorTable() } }));
+    }
+
+    /// Terms which cancel out yield the point at infinity.
+    mpz_neg(k2, k1);
+    ASSERT_TRUE(curve.multiScalarMultiplication(
+      { { k1, P }, { k2, P, table.get() } }).at_infinity);
+  }
+
+  mpz_clears(k1, k2, k3, nullptr);
+  gmp_randclear(random_state);
+}
+
+// ============================================================================
+TEST(EllipticCurveTests, TestBatchMultiScalarMultiplication)
+{
+  const ArithmeticBackends backends[] = { ArithmeticBackends::MPZ, 
+                                          ArithmeticBackends::MPN, 
+                                          ArithmeticBackends::P256 };
+
+  /// Enough entries to fill one group of lanes and part of another.
+  const unsigned int num_entries = 11u;
+
+  gmp_randstate_t random_state;
+  gmp_randinit_default(random_state);
+  gmp_randseed_ui     (random_state, 256ul);
+
+  mpz_t scalars[2 * num_entries];
+  for ( mpz_t& scalar : scalars )
+  {
+    mpz_init(scalar);
+  }
+
+  for ( const ArithmeticBackends backend : backends )
+  {
+    EllipticCurve              curve(Curves::P256, backend, 4096u);
+    const EllipticCurve::Point P = 
+      curve.scalarMultiplication(7u, curve.getGenerator());
+    const EllipticCurve::Point infinity;
+
+    for ( mpz_t& scalar : scalars )
+    {
+      mpz_urandomm(scalar, random_state, curve.getOrder());
+    }
+
+    /// Edge cases: 0 and 1, n - 1 and a negative scalar, and terms which cancel.
+    mpz_set_ui(scalars[0], 0ul);
+    mpz_set_ui(scalars[1], 1ul);
+    mpz_sub_ui(scalars[2], curve.getOrder(), 1ul);
+    mpz_neg   (scalars[3], scalars[3]);
+    mpz_neg   (scalars[5], scalars[4]);
+
+    std::vector<std::vector<EllipticCurve::MultiplicationTerm>> batch;
+    for ( unsigned int i = 0; i < num_entries; ++i )
+    {
+      batch.push_back(
+        { { scalars[2 * i],     curve.getGenerator(), 
+            ( i % 2 == 0 ) ? curve.getGeneratorTable() : nullptr },
+          { scalars[2 * i + 1], ( i == 2 ) ? curve.getGenerator() : 
+                                ( i == 6 ) ? infinity : P } });
+    }
+
+    const std::vector<EllipticCurve::Point> results = 
+      curve.batchMultiScalarMultiplication(batch);
+
+    ASSERT_EQ(batch.size(), results.size());
+    for ( unsigned int i = 0; i < num_entries; ++i )
+    {
+      ASSERT_TRUE(curve.multiScalarMultiplication(batch[i]) == results[i]);
+    }
+    ASSERT_TRUE(results[2].at_infinity);
+
+    /// Entries with differing numbers of terms.
+    batch[1].pop_back();
+    ASSERT_TRUE(curve.multiScalarMultiplication(batch[1]) == 
+                curve.batchMultiScalarMultiplication(batch)[1]);
+  }
+
+  for ( mpz_t& scalar : scalars )
+  {
+    mpz_clear(scalar);
+  }
+  gmp_randclear(random_state);
+}
+
+// ============================================================================
+TEST(EllipticCurveTests, TestWindowedMatchesDoubleAndAdd)
+{
+  EllipticCurve binary_toy_curve("foo", 2, 2, 17, 1, 21, 2);
+  EllipticCurve windowed_toy_curve("foo", 2, 2, 17, 1, 21, 2);
+  EllipticCurve binary_curve  (Curves::P256, ArithmeticBackends::P256);
+  EllipticCurve windowed_curve(Curves::P256, ArithmeticBackends::P256);
+
+  binary_toy_curve.setWindowBits(1u);
+  binary_curve.    setWindowBits(1u);
+
+  ASSERT_THROW(windowed_curve.setWindowBits(0u),                  
+               std::invalid_argument);
+  ASSERT_THROW(windowed_curve.setWindowBits(MAX_WINDOW_BITS + 1), 
+               std::invalid_argument);
+
+  gmp_randstate_t random_state;
+  gmp_randinit_default(random_state);
+  gmp_randseed_ui     (random_state, 256ul);
+
+  mpz_t scalar;
+  mpz_init(scalar);
+
+  const EllipticCurve::Point toy_P(5, 1);
+
+  for ( unsigned int window_bits = 2; window_bits <= MAX_WINDOW_BITS; ++window_bits )
+  {
+    windowed_toy_curve.setWindowBits(window_bits);
+    windowed_curve.    setWindowBits(window_bits);
+
+    /// Every multiple of the toy point, including its order.
+    for ( unsigned int i = 0; i <= 21u; ++i )
+    {
+      ASSERT_TRUE(binary_toy_curve.  scalarMultiplication(i, toy_P) == 
+                  windowed_toy_curve.scalarMultiplication(i, toy_P));
+    }
+
+    for ( unsigned int i = 0; i < 8u; ++i )
+    {
+      /// Runs of ones exercise the carries of the recoding.
+      if ( i == 0 )
+      {
+        mpz_set_ui  (scalar, 0ul);
+        mpz_setbit  (scalar, 256ul);
+        mpz_sub_ui  (scalar, scalar, 1ul);
+      }
+      else
+      {
+        mpz_urandomb(scalar, random_state, 256ul);
+      }
+
+      if ( i % 2 == 1 )
+      {
+        mpz_neg(scalar, scalar);
+      }
+
+      ASSERT_TRUE(
+        binary_curve.  scalarMultiplication(scalar, binary_curve.getGenerator()) ==
+        windowed_curve.scalarMultiplication(scalar, binary_curve.getGenerator()));
+    }
+  }
+
+  mpz_clear(scalar);
+  gmp_randclear(random_state);
+}
+
+// ============================================================================
+TEST(EllipticCurveTests, TestConstantTimeMatchesScalarMultiplication)
+{
+  EllipticCurve toy_curve("foo", 2, 2, 17, 1, 21, 2);
+  const EllipticCurve::Point toy_P(5, 1);
+
+  /// The toy point has order 19, so its table of odd multiples holds infinity.
+  mpz_t scalar;
+  mpz_init(scalar);
+  for ( int i = -40; i <= 40; ++i )
+  {
+    mpz_set_si(scalar, i);
+    ASSERT_TRUE(toy_curve.constantTimeScalarMultiplication(scalar, toy_P) == 
+                toy_curve.scalarMultiplication(scalar, toy_P));
+  }
+
+  gmp_randstate_t random_state;
+  gmp_randinit_default(random_state);
+  gmp_randseed_ui     (random_state, 8ul);
+
+  const ArithmeticBackends backends[] = 
+  {
+    ArithmeticBackends::MPZ, ArithmeticBackends::MPN, ArithmeticBackends::P256
+  };
+
+  for ( const ArithmeticBackends backend : backends )
+  {
+    EllipticCurve               curve(Curves::P256, backend);
+    const EllipticCurve::Point& G = curve.getGenerator();
+
+    for ( unsigned int i = 0; i < 10u; ++i )
+    {
+      /// Zero, one, the order n and its neighbours, then random scalars.
+      switch ( i )
+      {
+        case 0:  mpz_set_ui(scalar, 0ul);                            break;
+        case 1:  mpz_set_ui(scalar, 1ul);                            break;
+        case 2:  mpz_set   (scalar, curve.getOrder());               break;
+        case 3:  mpz_sub_ui(scalar, curve.getOrder(), 1ul);          break;
+        case 4:  mpz_add_ui(scalar, curve.getOrder(), 1ul);          break;
+        default: mpz_urandomm(scalar, random_state, curve.getOrder()); break;
+      }
+
+      if ( i > 6u && i % 2 == 1 )
+      {
+        mpz_neg(scalar, scalar);
+      }
+
+      ASSERT_TRUE(curve.constantTimeScalarMultiplication(scalar, G) == 
+                  curve.scalarMultiplication(scalar, G));
+    }
+
+    /// The digits are recoded on the stack, with room for twice the field.
+    mpz_set_ui(scalar, 0ul);
+    mpz_setbit(scalar, 16u * MAX_FIELD_SIZE_BYTES - 1u);
+    ASSERT_TRUE(curve.constantTimeScalarMultiplication(scalar, G) == 
+                curve.scalarMultiplication(scalar, G));
+    mpz_setbit(scalar, 16u * MAX_FIELD_SIZE_BYTES);
+    ASSERT_THROW(curve.constantTimeScalarMultiplication(scalar, G), 
+                 std::invalid_argument);
+  }
+
+  mpz_clear(scalar);
+  gmp_randclear(random_state);
+}
+
+// ============================================================================
+TEST(EllipticCurveTests, TestCompressedPointRoundTrip)
+{
+  const ArithmeticBackends backends[] = 
+  {
+    ArithmeticBackends::MPZ, ArithmeticBackends::MPN, ArithmeticBackends::P256
+  };
+
+  for ( const ArithmeticBackends backend : backends )
+  {
+    EllipticCurve        curve(Curves::P256, backend, 0u);
+    const unsigned int   size = curve.getFieldSizeBytes();
+    EllipticCurve::Point P    = curve.getGenerator();
+
+    /// Consecutive multiples of G cover both parities of y.
+    for ( unsigned int i = 0; i < 8u; ++i )
+    {
+      const std::string compressed = P.getCompressedFormat(size);
+      ASSERT_EQ(compressed.length(), 4u + 2u * size);
+      ASSERT_TRUE(curve.decodePoint(compressed)                       == P);
+      ASSERT_TRUE(curve.decodePoint(compressed.substr(2))             == P);
+      ASSERT_TRUE(curve.decodePoint(P.getUncompressedFormat(size))    == P);
+      P = curve.operate(P, curve.getGenerator());
+    }
+  }
+}
+
+// ============================================================================
+TEST(EllipticCurveTests, TestDecodePointRejectsInvalidEncodings)
+{
+  EllipticCurve      curve(Curves::P256, ArithmeticBackends::MPZ, 0u);
+  const unsigned int size = curve.getFieldSizeBytes();
+  const std::string  compressed = 
+    curve.getGenerator().getCompressedFormat(size);
+
+  ASSERT_THROW(curve.decodePoint(""),                      std::invalid_argument);
+  ASSERT_THROW(curve.decodePoint("0x05" + compressed.substr(4)), 
+               std::invalid_argument);
+  ASSERT_THROW(curve.decodePoint(compressed.substr(0, 10)), std::invalid_argument);
+  ASSERT_THROW(curve.decodePoint("0x02" + std::string(2u * size, 'g')), 
+               std::invalid_argument);
+
+  /// x = p is out of range, and x = 1 gives a non-square x^3 - 3x + b.
+  char p_hex[2u * 32u + 1u];
+  gmp_snprintf(p_hex, sizeof(p_hex), "%064Zx", curve.getPrimeModulus());
+  ASSERT_THROW(curve.decodePoint("0x02" + std::string(p_hex)), 
+               std::invalid_argument);
+  ASSERT_THROW(curve.decodePoint("0x02" + std::string(2u * size - 1u, '0') + "1"),
+               std::invalid_argument);
+
+  /// (Gx, Gy + 1) is in range, but lies on a curve with another b.
+  const EllipticCurve::Point& G = curve.getGenerator();
+  mpz_t off_curve_y;
+  mpz_init  (off_curve_y);
+  mpz_add_ui(off_curve_y, G.y, 1u);
+  const EllipticCurve::Point off_curve(G.x, off_curve_y);
+  mpz_clear (off_curve_y);
+  ASSERT_THROW(curve.decodePoint(off_curve.getUncompressedFormat(size)), 
+               std::invalid_argument);
+  ASSERT_TRUE (curve.decodePoint(G.getUncompressedFormat(size)) == G);
+
+  /// The toy curve has p = 1 mod 4, which the generic square root rejects.
+  EllipticCurve toy_curve("foo", 2, 2, 17, 1, 21, 2);
+  ASSERT_THROW(toy_curve.decodePoint("0x0205"), std::invalid_argument);
+}
+
+// ============================================================================
+TEST(EllipticCurveTests, TestCurveTraits)
+{
+  mpz_t p;
+  mpz_t a;
+  mpz_t b;
+  mpz_init_set_ui(p, 17ul);
+  mpz_init_set_ui(a, 2ul);
+  mpz_init_set_ui(b, 2ul);
+
+  /// The P-256 traits promise a = -3, which the toy curve does not have.
+  typedef JacobianArithmetic<MpzField, CurveTraits<Curves::P256>> Arithmetic;
+  ASSERT_THROW(Arithmetic(p, a, b), std::invalid_argument);
+
+  mpz_sub_ui(a, p, 3ul);
+  ASSERT_NO_THROW(Arithmetic(p, a, b));
+
+  mpz_clears(p, a, b, nullptr);
+
+  ASSERT_TRUE (EllipticCurve(Curves::P256, ArithmeticBackends::MPZ, 0u).hasUnitCofactor());
+  ASSERT_TRUE (EllipticCurve("foo", 2, 2, 17, 1, 21, 2).hasUnitCofactor());
+  ASSERT_FALSE(EllipticCurve("foo", 2, 2, 17, 4, 21, 2).hasUnitCofactor());
+}
+
+// ============================================================================
+TEST(EllipticCurveTests, TestEdwards25519Encodings)
+{
+  EllipticCurve curve(Curves::EDWARDS25519, ArithmeticBackends::ED25519, 0u);
+
+  /// The generator, and M and N as given in RFC 9382.
+  ASSERT_EQ(curve.encodePoint(curve.getGenerator(), false), 
+            "5866666666666666666666666666666666666666666666666666666666666666");
+  ASSERT_EQ(curve.encodePoint(spake_2_parameters.at(Curves::EDWARDS25519).M, false),
+            "d048032c6ea0b6d697ddc2e86bda85a33adac920f1bf18e1b0c6d166a5cecdaf");
+  ASSERT_EQ(curve.encodePoint(spake_2_parameters.at(Curves::EDWARDS25519).N, false),
+            "d3bfb518f44f3430f29d0c92af503865a1ed3281dc69b35dd868ba85f886c4ab");
+
+  /// 12345678901234567890 * G, computed independently.
+  const EllipticCurve::Point P = curve.scalarMultiplication(7u, curve.getGenerator());
+  mpz_t scalar;
+  mpz_init_set_str(scalar, "12345678901234567890", 10);
+  const EllipticCurve::Point Q = curve.scalarMultiplication(scalar, curve.getGenerator());
+  ASSERT_EQ(curve.encodePoint(Q, false), 
+            "7767a3242dc9b58bbc68488c1265cc6cc5f26c6f3c88a5d55e901b0734dca572");
+  ASSERT_TRUE(curve.decodePoint(curve.encodePoint(P)) == P);
+  ASSERT_TRUE(curve.decodePoint(curve.encodePoint(Q)) == Q);
+  ASSERT_TRUE(curve.decodePoint(curve.encodePoint(EllipticCurve::Point())).at_infinity);
+
+  /// y = 2 is not on the curve, and edwards25519 has no SEC1 encoding.
+  ASSERT_THROW(curve.decodePoint("02" + std::string(62, '0')), std::invalid_argument);
+  ASSERT_THROW(curve.decodePoint(P.getUncompressedFormat(32u)), std::invalid_argument);
+
+  /// y = p + 1 is a non-canonical encoding of the neutral element, y = 1.
+  ASSERT_THROW(curve.decodePoint("ee" + std::string(60, 'f') + "7f"), 
+               std::invalid_argument);
+  ASSERT_THROW(EllipticCurve(Curves::EDWARDS25519, ArithmeticBackends::MPN, 0u), 
+               std::invalid_argument);
+  ASSERT_THROW(EllipticCurve(Curves::P256, ArithmeticBackends::ED25519, 0u), 
+               std::invalid_argument);
+
+  mpz_clear(scalar);
+}
+
+// ============================================================================
+TEST(EllipticCurveTests, TestEdwards25519GroupLaw)
+{
+  EllipticCurve               curve(Curves::EDWARDS25519, ArithmeticBackends::ED25519);
+  const EllipticCurve::Point& G = curve.getGenerator();
+  const EllipticCurve::Point& M = spake_2_parameters.at(Curves::EDWARDS25519).M;
+
+  /// M has order n, so its table holds multiples of its own.
+  std::unique_ptr<FixedBaseTable> M_table(
+    curve.createFixedBaseTable(M, FIXED_BASE_TABLE_BYTES));
+  ASSERT_GT(M_table->getSizeBytes(), 1024u);
+
+  gmp_randstate_t random_state;
+  gmp_randinit_default(random_state);
+  gmp_randseed_ui     (random_state, 25519ul);
+
+  mpz_t a;
+  mpz_t b;
+  mpz_t sum;
+  mpz_inits(a, b, sum, nullptr);
+
+  for ( unsigned int i = 0; i < 8u; ++i )
+  {
+    mpz_urandomm(a, random_state, curve.getOrder());
+    mpz_urandomm(b, random_state, curve.getOrder());
+    mpz_add     (sum, a, b);
+
+    const EllipticCurve::Point aG = curve.scalarMultiplication(a, G);
+    const EllipticCurve::Point bG = curve.scalarMultiplication(b, G);
+    const EllipticCurve::Point bM = curve.scalarMultiplication(b, M);
+    ASSERT_TRUE(curve.operate(aG, bG) == curve.scalarMultiplication(sum, G));
+    ASSERT_TRUE(curve.fixedBaseMultiplication(a) == aG);
+    ASSERT_TRUE(curve.fixedBaseMultiplication(b, *M_table) == bM);
+    ASSERT_TRUE(curve.fixedBaseMultiplication(sum, *M_table) == 
+                curve.scalarMultiplication(sum, M));
+    ASSERT_TRUE(curve.operate(aG, curve.negatePoint(aG)).at_infinity);
+
+    const std::vector<EllipticCurve::MultiplicationTerm> terms = 
+    {
+      { a, G }, { b, M, M_table.get() }
+    };
+    ASSERT_TRUE(curve.multiScalarMultiplication(terms) == curve.operate(aG, bM));
+  }
+
+  ASSERT_TRUE(curve.scalarMultiplication(curve.getOrder(), G).at_infinity);
+  ASSERT_TRUE(curve.fixedBaseMultiplication(curve.getOrder(), *M_table).at_infinity);
+  mpz_neg(sum, b);
+  ASSERT_TRUE(curve.fixedBaseMultiplication(sum, *M_table) == 
+              curve.negatePoint(curve.scalarMultiplication(b, M)));
+
+  /// (0, -1) has order 2, so it is cleared by the cofactor, h = 8.
+  mpz_t zero;
+  mpz_t minus_one;
+  mpz_init   (zero);
+  mpz_init   (minus_one);
+  mpz_sub_ui (minus_one, curve.getPrimeModulus(), 1ul);
+  const EllipticCurve::Point T(zero, minus_one);
+  const EllipticCurve::Point aG = curve.scalarMultiplication(a, G);
+  const EllipticCurve::Point P  = curve.operate(aG, T);
+  ASSERT_FALSE(P == aG);
+  ASSERT_TRUE(curve.clearCofactor(T).at_infinity);
+  ASSERT_TRUE(curve.clearCofactor(P) == curve.scalarMultiplication(8u, aG));
+
+  /// Multiples of P keep its component of order 2, and T itself is refused.
+  const EllipticCurve::Point abG = curve.scalarMultiplication(b, aG);
+  const std::vector<EllipticCurve::MultiplicationTerm> torsion_terms = 
+  {
+    { b, P }
+  };
+  ASSERT_TRUE(curve.scalarMultiplication(1u, P)               == P);
+  ASSERT_TRUE(curve.scalarMultiplication(curve.getOrder(), P) == T);
+  ASSERT_TRUE(curve.multiScalarMultiplication(torsion_terms)  == 
+              ( mpz_odd_p(b) ? curve.operate(abG, T) : abG ));
+  ASSERT_THROW(curve.constantTimeScalarMultiplication(b, T), std::invalid_argument);
+
+  /// P is outside the subgroup of order n, so its table is only its encoding.
+  std::unique_ptr<FixedBaseTable> P_table(
+    curve.createFixedBaseTable(P, FIXED_BASE_TABLE_BYTES));
+  ASSERT_LT(P_table->getSizeBytes(), 1024u);
+  ASSERT_TRUE(curve.fixedBaseMultiplication(curve.getOrder(), *P_table) == T);
+
+  /// hn - 1 is past the 255 bits libsodium reads.
+  mpz_mul   (sum, curve.getOrder(), curve.getCofactor());
+  mpz_sub_ui(sum, sum, 1ul);
+  ASSERT_TRUE(curve.scalarMultiplication(sum, P) == curve.negatePoint(P));
+  ASSERT_TRUE (curve.scalarMultiplication(b, EllipticCurve::Point()).at_infinity);
+
+  mpz_clears(a, b, sum, zero, minus_one, nullptr);
+  gmp_randclear(random_state);
+}
+
+// ============================================================================
+TEST(EllipticCurveTests, TestSecp256k1Endomorphism)
+{
+  EllipticCurve               glv_curve(Curves::SECP256K1, ArithmeticBackends::SECP256K1);
+  EllipticCurve               mpn_curve(Curves::SECP256K1, ArithmeticBackends::MPN);
+  const EllipticCurve::Point& G = glv_curve.getGenerator();
+  const EllipticCurve::Point& M = spake_2_parameters.at(Curves::SECP256K1).M;
+  const EllipticCurve::Point& N = spake_2_parameters.at(Curves::SECP256K1).N;
+
+  ASSERT_THROW(EllipticCurve(Curves::P256, ArithmeticBackends::SECP256K1), 
+               std::invalid_argument);
+
+  /// M and N are on the curve, in the group generated by G.
+  ASSERT_TRUE(glv_curve.decodePoint(M.getCompressedFormat(32u)) == M);
+  ASSERT_TRUE(glv_curve.decodePoint(N.getCompressedFormat(32u)) == N);
+  ASSERT_TRUE(mpn_curve.scalarMultiplication(mpn_curve.getOrder(), M).at_infinity);
+  ASSERT_TRUE(mpn_curve.scalarMultiplication(mpn_curve.getOrder(), N).at_infinity);
+
+  const Secp256k1Arithmetic arithmetic(glv_curve.getPrimeModulus(), 
+                                       glv_curve.getA(), 
+                                       glv_curve.getB());
+
+  mpz_t lambda;
+  mpz_init_set_str(lambda, 
+    "5363ad4cc05c30e0a5261c028812645a122e22ea20816678df02967c1b23bd72", 16);
+  ASSERT_TRUE(arithmetic.endomorphism(G) == 
+              mpn_curve.scalarMultiplication(lambda, G));
+
+  std::unique_ptr<FixedBaseTable> M_table(glv_curve.createFixedBaseTable(M, 1024u));
+
+  gmp_randstate_t random_state;
+  gmp_randinit_default(random_state);
+  gmp_randseed_ui     (random_state, 256ul);
+
+  mpz_t k;
+  mpz_t k1;
+  mpz_t k2;
+  mpz_t j;
+  mpz_inits(k, k1, k2, j, nullptr);
+
+  for ( unsigned int i = 0; i < 8u; ++i )
+  {
+    mpz_urandomb(k, random_state, 260ul);
+    mpz_urandomm(j, random_state, glv_curve.getOrder());
+    if ( i % 2 == 1 )
+    {
+      mpz_neg(k, k);
+    }
+
+    /// k1 + k2 * lambda = k mod n, with both halves of about 128 bits.
+    arithmetic.splitScalar(k1, k2, k);
+    ASSERT_LE(mpz_sizeinbase(k1, 2), 129u);
+    ASSERT_LE(mpz_sizeinbase(k2, 2), 129u);
+    mpz_addmul(k1, k2, lambda);
+    mpz_sub   (k1, k1, k);
+    ASSERT_TRUE(mpz_divisible_p(k1, glv_curve.getOrder()) != 0);
+
+    const EllipticCurve::Point P = mpn_curve.scalarMultiplication(j, G);
+    ASSERT_TRUE(glv_curve.scalarMultiplication(k, P) == 
+                mpn_curve.scalarMultiplication(k, P));
+
+    const std::vector<EllipticCurve::MultiplicationTerm> terms = 
+    {
+      { k, P }, { j, M, M_table.get() }, { j, N }
+    };
+    const EllipticCurve::Point expected = mpn_curve.operate(
+      mpn_curve.scalarMultiplication(k, P), 
+      mpn_curve.operate(mpn_curve.scalarMultiplication(j, M), 
+                        mpn_curve.scalarMultiplication(j, N)));
+    ASSERT_TRUE(glv_curve.multiScalarMultiplication(terms) == expected);
+    ASSERT_TRUE(glv_curve.batchMultiScalarMultiplication({ terms, terms })[1] == 
+                expected);
+  }
+
+  ASSERT_TRUE(glv_curve.scalarMultiplication(glv_curve.getOrder(), G).at_infinity);
+
+  mpz_clears(lambda, k, k1, k2, j, nullptr);
+  gmp_randclear(random_state);
+}
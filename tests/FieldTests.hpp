@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include <gmp.h>
+
+#include "EllipticCurveConstants.hpp"
+
+/** The fixture shared by the field tests. p and a start as those of P-256,
+    and operands are drawn from a random state seeded by each fixture.
+*/
+class FieldTests : public::testing::Test
+{
+protected:
+  explicit FieldTests(unsigned long seed_in) : seed(seed_in) {}
+
+  void SetUp()
+  {
+    mpz_inits(p, a, lhs, rhs, expected, actual, nullptr);
+    mpz_set_str(p, curve_parameters.at(Curves::P256).p, 10);
+    mpz_set_str(a, curve_parameters.at(Curves::P256).a, 10);
+
+    gmp_randinit_default(random_state);
+    gmp_randseed_ui     (random_state, seed);
+  }
+
+  void TearDown()
+  {
+    gmp_randclear(random_state);
+    mpz_clears(p, a, lhs, rhs, expected, actual, nullptr);
+  }
+
+  /// Edge cases around 0 and p, followed by uniformly random elements.
+  void getOperand(unsigned int i, mpz_t value)
+  {
+    switch ( i )
+    {
+      case 0:  mpz_set_ui (value, 0ul);           break;
+      case 1:  mpz_set_ui (value, 1ul);           break;
+      case 2:  mpz_sub_ui (value, p, 1ul);        break;
+      case 3:  mpz_tdiv_q_2exp(value, p, 1ul);    break;
+      default: mpz_urandomm(value, random_state, p);
+    }
+  }
+
+  const unsigned long seed;
+
+  gmp_randstate_t random_state;
+  mpz_t           p;
+  mpz_t           a;
+  mpz_t           lhs;
+  mpz_t           rhs;
+  mpz_t           expected;
+  mpz_t           actual;
+};
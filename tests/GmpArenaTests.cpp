@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <gmp.h>
+
+#include <thread>
+#include <vector>
+
+#include "EllipticCurve.hpp"
+#include "EllipticCurveConstants.hpp"
+#include "GmpArena.hpp"
+
+class GmpArenaTests : public::testing::Test
+{
+protected:
+  void SetUp()
+  {
+    GmpArena::install();
+  }
+};
+
+// ============================================================================
+TEST_F(GmpArenaTests, TestScopesResetTheArena)
+{
+  ASSERT_TRUE(GmpArena::isInstalled());
+  ASSERT_EQ(GmpArena::getBytesInUse(), 0u);
+
+  {
+    GmpArena::Scope outer_scope;
+
+    mpz_t value;
+    mpz_init_set_str(value, curve_parameters.at(Curves::P256).p, 10);
+    const std::size_t outer_bytes = GmpArena::getBytesInUse();
+    ASSERT_GT(outer_bytes, 0u);
+
+    {
+      GmpArena::Scope inner_scope;
+      mpz_mul(value, value, value);
+      ASSERT_GT(GmpArena::getBytesInUse(), outer_bytes);
+    }
+
+    /// Only the outermost scope resets the arena.
+    ASSERT_GT(GmpArena::getBytesInUse(), outer_bytes);
+    ASSERT_EQ(mpz_sizeinbase(value, 2), 512u);
+    mpz_clear(value);
+  }
+
+  ASSERT_EQ(GmpArena::getBytesInUse(), 0u);
+}
+
+// ============================================================================
+TEST_F(GmpArenaTests, TestHeapReallocationStaysOnTheHeap)
+{
+  mpz_t heap_value;
+  mpz_t expected;
+  mpz_init_set_ui(heap_value, 3u);
+  mpz_init_set_ui(expected,   3u);
+  mpz_setbit     (expected,   4096u);
+
+  /// mpz_setbit() grows the integer with a reallocation.
+  {
+    GmpArena::Scope scope;
+    mpz_setbit(heap_value, 4096u);
+  }
+
+  /// Reuse the arena, which would overwrite heap_value had it moved there.
+  {
+    GmpArena::Scope scope;
+    mpz_t overwrite;
+    mpz_init_set_ui(overwrite, 0u);
+    mpz_setbit     (overwrite, 8192u);
+    mpz_sub_ui     (overwrite, overwrite, 1u);
+    mpz_clear      (overwrite);
+  }
+
+  ASSERT_EQ(mpz_cmp(heap_value, expected), 0);
+  mpz_clears(heap_value, expected, nullptr);
+}
+
+// ============================================================================
+TEST_F(GmpArenaTests, TestThreadsMatchDefaultAllocator)
+{
+  const unsigned int num_threads = 4u;
+  const EllipticCurve curve(Curves::P256, ArithmeticBackends::MPZ, 0u);
+
+  std::vector<EllipticCurve::Point> expected(num_threads);
+  for ( unsigned int i = 0; i < num_threads; ++i )
+  {
+    expected[i] = curve.scalarMultiplication(1000u + i, curve.getGenerator());
+  }
+
+  /// Each thread's arena is reset and reused by every multiplication.
+  std::vector<EllipticCurve::Point> actual(num_threads);
+  std::vector<std::thread>          threads;
+  for ( unsigned int i = 0; i < num_threads; ++i )
+  {
+    threads.emplace_back([&curve, &actual, i]()
+    {
+      for ( unsigned int round = 0; round < 8u; ++round )
+      {
+        GmpArena::Scope scope;
+        actual[i] = curve.scalarMultiplication(1000u + i, curve.getGenerator());
+      }
+    });
+  }
+
+  for ( std::thread& thread : threads )
+  {
+    thread.join();
+  }
+
+  for ( unsigned int i = 0; i < num_threads; ++i )
+  {
+    ASSERT_TRUE(actual[i] == expected[i]);
+  }
+}
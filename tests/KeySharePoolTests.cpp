@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include <gmp.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+#include "EllipticCurve.hpp"
+#include "EllipticCurveConstants.hpp"
+#include "KeySharePool.hpp"
+#include "Spake2.hpp"
+#include "Spake2CipherSuite.hpp"
+
+// ============================================================================
+TEST(KeySharePoolTests, TestSharesAreValid)
+{
+  KeySharePool::Config config;
+  config.depth          = 8u;
+  config.low_watermark  = 2u;
+  config.high_watermark = 8u;
+  config.threads        = 2u;
+
+  KeySharePool pool(Curves::P256, config);
+  pool.waitUntilFilled();
+  ASSERT_EQ(pool.getStatistics().available, 8u);
+
+  const EllipticCurve curve(Curves::P256, ArithmeticBackends::MPZ, 0u);
+
+  mpz_t scalar;
+  mpz_init(scalar);
+  for ( unsigned int i = 0; i < 8u; ++i )
+  {
+    EllipticCurve::Point share;
+    if ( !pool.take(scalar, share) )
+    {
+      continue;
+    }
+
+    ASSERT_GT(mpz_sgn(scalar), 0);
+    ASSERT_LT(mpz_cmp(scalar, curve.getOrder()), 0);
+    ASSERT_TRUE(share == curve.scalarMultiplication(scalar, curve.getGenerator()));
+  }
+  mpz_clear(scalar);
+
+  /// The threads may refill the queue while it is drained, but never miss.
+  const KeySharePool::Statistics statistics = pool.getStatistics();
+  ASSERT_EQ(statistics.hits + statistics.misses, 8u);
+  ASSERT_GE(statistics.generated, statistics.hits);
+  ASSERT_LE(statistics.available, config.depth);
+}
+
+// ============================================================================
+TEST(KeySharePoolTests, TestInvalidConfig)
+{
+  KeySharePool::Config config;
+  config.threads = 0u;
+  ASSERT_THROW(KeySharePool(Curves::P256, config), std::invalid_argument);
+
+  config = KeySharePool::Config();
+  config.low_watermark = config.high_watermark;
+  ASSERT_THROW(KeySharePool(Curves::P256, config), std::invalid_argument);
+
+  config = KeySharePool::Config();
+  config.high_watermark = config.depth + 1u;
+  ASSERT_THROW(KeySharePool(Curves::P256, config), std::invalid_argument);
+}
+
+// ============================================================================
+TEST(KeySharePoolTests, TestSessionsTakeInstalledShares)
+{
+  KeySharePool::Config config;
+  config.depth          = 4u;
+  config.low_watermark  = 1u;
+  config.high_watermark = 4u;
+
+  KeySharePool pool(Curves::P256, config);
+  pool.waitUntilFilled();
+  KeySharePool::install(pool);
+
+  Spake2 alice("alice", "foo", true);
+  Spake2 bob  ("bob",   "foo", false);
+  KeySharePool::uninstall(Curves::P256);
+  ASSERT_EQ(pool.getStatistics().hits, 2u);
+
+  alice.setupPhase();
+  bob.  setupPhase();
+
+  ASSERT_TRUE(alice.readOtherPartiesPublicKey());
+  ASSERT_TRUE(bob.  readOtherPartiesPublicKey());
+
+  alice.keyDerivationPhase();
+  bob.  keyDerivationPhase();
+
+  alice.readOtherPartiesConfirmationKey();
+  bob.  readOtherPartiesConfirmationKey();
+
+  ASSERT_TRUE(alice.checkProtocolComplete());
+  ASSERT_TRUE(bob.  checkProtocolComplete());
+
+  /// Without an installed pool, sessions draw their own scalars.
+  Spake2 carol("carol", "foo", true);
+  ASSERT_EQ(pool.getStatistics().hits, 2u);
+}
+
+// ============================================================================
+TEST(KeySharePoolTests, TestDestroyingAnInstalledPool)
+{
+  KeySharePool::Config config;
+  config.depth          = 4u;
+  config.low_watermark  = 1u;
+  config.high_watermark = 4u;
+
+  std::atomic<bool> done(false);
+  std::thread       taker([&done]()
+  {
+    mpz_t                scalar;
+    EllipticCurve::Point share;
+    mpz_init(scalar);
+    while ( !done )
+    {
+      KeySharePool::takeInstalled(Curves::P256, scalar, share);
+    }
+    mpz_clear(scalar);
+  });
+
+  /// Each pool is destroyed while it is installed and being taken from.
+  for ( unsigned int i = 0; i < 16u; ++i )
+  {
+    KeySharePool pool(Curves::P256, config);
+    KeySharePool::install(pool);
+    while ( pool.getStatistics().hits == 0u )
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  done = true;
+  taker.join();
+
+  mpz_t                scalar;
+  EllipticCurve::Point share;
+  mpz_init(scalar);
+  ASSERT_FALSE(KeySharePool::takeInstalled(Curves::P256, scalar, share));
+  mpz_clear(scalar);
+}
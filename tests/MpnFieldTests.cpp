@@ -0,0 +1,166 @@
+#include "FieldTests.hpp"
+#include "MpnField.hpp"
+
+class MpnFieldTests : public FieldTests
+{
+protected:
+  MpnFieldTests() : FieldTests(521ul) {}
+
+  /// A single limb prime, P-256, a prime just above a limb boundary and P-521.
+  void getPrime(unsigned int i, mpz_t value)
+  {
+    switch ( i )
+    {
+      case 0:
+        mpz_set_ui(value, 17ul);
+        break;
+      case 1:
+        mpz_set_str(value, curve_parameters.at(Curves::P256).p, 10);
+        break;
+      case 2:
+        mpz_ui_pow_ui(value, 2ul, 320ul);
+        mpz_nextprime(value, value);
+        break;
+      default:
+        mpz_ui_pow_ui(value, 2ul, 521ul);
+        mpz_sub_ui   (value, value, 1ul);
+    }
+  }
+
+  constexpr static unsigned int num_primes = 4u;
+  constexpr static unsigned int num_tests  = 128u;
+};
+
+// ============================================================================
+TEST_F(MpnFieldTests, TestRejectsInvalidModulus)
+{
+  mpz_set_ui(p, 16ul);
+  ASSERT_THROW(MpnField(p, a), std::invalid_argument);
+
+  /// One limb more than MAX_LIMBS.
+  mpz_ui_pow_ui(p, 2ul, GMP_NUMB_BITS * MpnField::MAX_LIMBS);
+  mpz_add_ui   (p, p, 1ul);
+  ASSERT_THROW(MpnField(p, a), std::invalid_argument);
+}
+
+// ============================================================================
+TEST_F(MpnFieldTests, TestArithmeticMatchesMpz)
+{
+  for ( unsigned int prime = 0; prime < num_primes; ++prime )
+  {
+    getPrime(prime, p);
+
+    MpnField          field(p, a);
+    MpnField::Element x;
+    MpnField::Element y;
+    MpnField::Element result;
+
+    for ( unsigned int i = 0; i < num_tests; ++i )
+    {
+      getOperand(i,                     lhs);
+      getOperand(( i * 7 ) % num_tests, rhs);
+      field.fromMpz(x, lhs);
+      field.fromMpz(y, rhs);
+
+      field.add  (result, x, y);
+      field.toMpz(actual, result);
+      mpz_add    (expected, lhs, rhs);
+      mpz_mod    (expected, expected, p);
+      ASSERT_EQ(mpz_cmp(expected, actual), 0);
+
+      field.sub  (result, x, y);
+      field.toMpz(actual, result);
+      mpz_sub    (expected, lhs, rhs);
+      mpz_mod    (expected, expected, p);
+      ASSERT_EQ(mpz_cmp(expected, actual), 0);
+
+      field.mul  (result, x, y);
+      field.toMpz(actual, result);
+      mpz_mul    (expected, lhs, rhs);
+      mpz_mod    (expected, expected, p);
+      ASSERT_EQ(mpz_cmp(expected, actual), 0);
+
+      field.sqr  (result, x);
+      field.toMpz(actual, result);
+      mpz_mul    (expected, lhs, lhs);
+      mpz_mod    (expected, expected, p);
+      ASSERT_EQ(mpz_cmp(expected, actual), 0);
+
+      field.neg  (result, x);
+      field.toMpz(actual, result);
+      mpz_neg    (expected, lhs);
+      mpz_mod    (expected, expected, p);
+      ASSERT_EQ(mpz_cmp(expected, actual), 0);
+
+      field.toMpz(actual, field.getA());
+      mpz_mod    (expected, a, p);
+      ASSERT_EQ(mpz_cmp(expected, actual), 0);
+    }
+  }
+}
+
+// ============================================================================
+TEST_F(MpnFieldTests, TestInversion)
+{
+  for ( unsigned int prime = 0; prime < num_primes; ++prime )
+  {
+    getPrime(prime, p);
+
+    MpnField          field(p, a);
+    MpnField::Element x;
+    MpnField::Element result;
+
+    field.setZero(x);
+    field.invert (result, x);
+    ASSERT_TRUE(field.isZero(result));
+
+    field.setOne(x);
+    field.invert(result, x);
+    ASSERT_TRUE(field.isOne(result));
+
+    for ( unsigned int i = 2; i < num_tests / 8; ++i )
+    {
+      /// Random operands may be zero for the single limb prime.
+      getOperand(i, lhs);
+      if ( mpz_sgn(lhs) == 0 )
+      {
+        continue;
+      }
+
+      field.fromMpz(x, lhs);
+      field.invert (result, x);
+      field.toMpz (actual, result);
+      mpz_invert  (expected, lhs, p);
+      ASSERT_EQ(mpz_cmp(expected, actual), 0);
+
+      field.invertVariableTime(result, x);
+      field.toMpz             (actual, result);
+      ASSERT_EQ(mpz_cmp(expected, actual), 0);
+    }
+
+    field.setZero           (x);
+    field.invertVariableTime(result, x);
+    ASSERT_TRUE(field.isZero(result));
+  }
+}
+
+// ============================================================================
+TEST_F(MpnFieldTests, TestFromMpzReduces)
+{
+  getPrime(1u, p);
+
+  MpnField          field(p, a);
+  MpnField::Element x;
+
+  /// p + 5 and -5 both fit outside of [0, p).
+  mpz_add_ui   (lhs, p, 5ul);
+  field.fromMpz(x, lhs);
+  field.toMpz  (actual, x);
+  ASSERT_EQ(mpz_cmp_ui(actual, 5ul), 0);
+
+  mpz_set_si   (lhs, -5l);
+  field.fromMpz(x, lhs);
+  field.toMpz  (actual, x);
+  mpz_sub_ui   (expected, p, 5ul);
+  ASSERT_EQ(mpz_cmp(expected, actual), 0);
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "OpenSslContexts.hpp"
+#include "StringHelpers.hpp"
+
+/// RFC 4231 test case 2, and RFC 5869 test case 3 (empty salt and info).
+static const char*       hmac_key     = "Jefe";
+static const char*       hmac_message = "what do ya want for nothing?";
+static const std::string hmac_expected = 
+  "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843";
+static const std::string hkdf_expected = 
+  "8da4e775a563c18f715f802a063c5a31b8a11f5c5ee1879ec3454e5f3c738d2d"
+  "9d201395faa4b61a96c8";
+
+/** Check both vectors twice, with other keys in between, so that each context
+    is re-keyed.
+*/
+static void checkVectors()
+{
+  const std::vector<unsigned char> ikm(22u, 0x0bu);
+  const unsigned char other_key[] = { 0x01u, 0x02u, 0x03u };
+  const unsigned char info[]      = { 'a', 'b', 'c', 'd' };
+
+  for ( unsigned int i = 0; i < 2u; ++i )
+  {
+    unsigned char mac[EVP_MAX_MD_SIZE];
+    const std::size_t length = 
+      OpenSslContexts::hmacSha256(
+        reinterpret_cast<const unsigned char*>(hmac_key), std::strlen(hmac_key),
+        reinterpret_cast<const unsigned char*>(hmac_message), 
+        std::strlen(hmac_message), mac);
+    ASSERT_EQ(binaryToHexString(mac, length), hmac_expected);
+
+    unsigned char okm[42];
+    OpenSslContexts::hkdfSha256(ikm.data(), ikm.size(), info, 0u, info, 0u, 
+                                okm, sizeof(okm));
+    ASSERT_EQ(binaryToHexString(okm, sizeof(okm)), hkdf_expected);
+
+    /// The info is first_info || second_info, whichever way it is split.
+    unsigned char split[32];
+    unsigned char whole[32];
+    OpenSslContexts::hkdfSha256(other_key, sizeof(other_key), info, 2u, 
+                                info + 2, 2u, split, sizeof(split));
+    OpenSslContexts::hkdfSha256(other_key, sizeof(other_key), info, 4u, 
+                                info, 0u, whole, sizeof(whole));
+    ASSERT_EQ(std::memcmp(split, whole, sizeof(split)), 0);
+
+    OpenSslContexts::hmacSha256(other_key, sizeof(other_key), info, 
+                                sizeof(info), mac);
+  }
+}
+
+// ============================================================================
+TEST(OpenSslContextsTests, TestVectors)
+{
+  checkVectors();
+  ASSERT_NE(OpenSslContexts::getSha256(), nullptr);
+}
+
+// ============================================================================
+TEST(OpenSslContextsTests, TestContextsArePerThread)
+{
+  std::vector<std::thread> threads;
+  for ( unsigned int i = 0; i < 4u; ++i )
+  {
+    threads.emplace_back([]()
+    {
+      for ( unsigned int j = 0; j < 64u; ++j )
+      {
+        checkVectors();
+      }
+    });
+  }
+
+  for ( auto& thread : threads )
+  {
+    thread.join();
+  }
+}
@@ -0,0 +1,144 @@
+#include "FieldTests.hpp"
+#include "P256Field.hpp"
+
+class P256FieldTests : public FieldTests
+{
+protected:
+  P256FieldTests() : FieldTests(256ul) {}
+
+  constexpr static unsigned int num_tests = 256u;
+};
+
+// ============================================================================
+TEST_F(P256FieldTests, TestRejectsOtherCurves)
+{
+  mpz_t toy_prime;
+  mpz_init_set_ui(toy_prime, 17ul);
+
+  ASSERT_THROW(P256Field(toy_prime, a), std::invalid_argument);
+  ASSERT_NO_THROW(P256Field(p, a));
+
+  mpz_clear(toy_prime);
+}
+
+// ============================================================================
+TEST_F(P256FieldTests, TestArithmeticMatchesMpz)
+{
+  P256Field          field(p, a);
+  P256Field::Element x;
+  P256Field::Element y;
+  P256Field::Element result;
+
+  for ( unsigned int i = 0; i < num_tests; ++i )
+  {
+    getOperand(i,                   lhs);
+    getOperand(( i * 7 ) % num_tests, rhs);
+    field.fromMpz(x, lhs);
+    field.fromMpz(y, rhs);
+
+    field.add  (result, x, y);
+    field.toMpz(actual, result);
+    mpz_add    (expected, lhs, rhs);
+    mpz_mod    (expected, expected, p);
+    ASSERT_EQ(mpz_cmp(expected, actual), 0);
+
+    field.sub  (result, x, y);
+    field.toMpz(actual, result);
+    mpz_sub    (expected, lhs, rhs);
+    mpz_mod    (expected, expected, p);
+    ASSERT_EQ(mpz_cmp(expected, actual), 0);
+
+    field.mul  (result, x, y);
+    field.toMpz(actual, result);
+    mpz_mul    (expected, lhs, rhs);
+    mpz_mod    (expected, expected, p);
+    ASSERT_EQ(mpz_cmp(expected, actual), 0);
+
+    field.sqr  (result, x);
+    field.toMpz(actual, result);
+    mpz_mul    (expected, lhs, lhs);
+    mpz_mod    (expected, expected, p);
+    ASSERT_EQ(mpz_cmp(expected, actual), 0);
+
+    field.neg  (result, x);
+    field.toMpz(actual, result);
+    mpz_neg    (expected, lhs);
+    mpz_mod    (expected, expected, p);
+    ASSERT_EQ(mpz_cmp(expected, actual), 0);
+  }
+}
+
+// ============================================================================
+TEST_F(P256FieldTests, TestInversion)
+{
+  P256Field          field(p, a);
+  P256Field::Element x;
+  P256Field::Element result;
+
+  for ( unsigned int i = 1; i < num_tests / 8; ++i )
+  {
+    getOperand(i, lhs);
+    field.fromMpz(x, lhs);
+
+    field.invert(result, x);
+    field.toMpz (actual, result);
+    mpz_invert  (expected, lhs, p);
+    ASSERT_EQ(mpz_cmp(expected, actual), 0);
+
+    /// The variable-time inversion may also run in place.
+    field.invertVariableTime(x,      x);
+    field.toMpz             (actual, x);
+    ASSERT_EQ(mpz_cmp(expected, actual), 0);
+  }
+
+  /// The inverse of zero is zero.
+  field.setZero           (x);
+  field.invert            (result, x);
+  ASSERT_TRUE(field.isZero(result));
+  field.invertVariableTime(result, x);
+  ASSERT_TRUE(field.isZero(result));
+}
+
+// ============================================================================
+TEST_F(P256FieldTests, TestFromMpzReduces)
+{
+  P256Field          field(p, a);
+  P256Field::Element x;
+
+  /// p + 5 and -5 both fit outside of [0, p).
+  mpz_add_ui   (lhs, p, 5ul);
+  field.fromMpz(x, lhs);
+  field.toMpz  (actual, x);
+  ASSERT_EQ(mpz_cmp_ui(actual, 5ul), 0);
+
+  mpz_set_si   (lhs, -5l);
+  field.fromMpz(x, lhs);
+  field.toMpz  (actual, x);
+  mpz_sub_ui   (expected, p, 5ul);
+  ASSERT_EQ(mpz_cmp(expected, actual), 0);
+}
+
+// ============================================================================
+TEST_F(P256FieldTests, TestSquareRoot)
+{
+  P256Field          field(p, a);
+  P256Field::Element x;
+  P256Field::Element result;
+
+  for ( unsigned int i = 0; i < num_tests / 8; ++i )
+  {
+    getOperand(i, lhs);
+    mpz_powm_ui  (expected, lhs, 2ul, p);
+    field.fromMpz(x, expected);
+
+    ASSERT_TRUE(field.squareRoot(result, x));
+    field.toMpz(actual, result);
+    mpz_powm_ui(actual, actual, 2ul, p);
+    ASSERT_EQ(mpz_cmp(expected, actual), 0);
+  }
+
+  /// -1 is not a square, since p = 3 mod 4.
+  mpz_sub_ui   (lhs, p, 1ul);
+  field.fromMpz(x, lhs);
+  ASSERT_FALSE(field.squareRoot(result, x));
+}
@@ -0,0 +1,127 @@
+#include "FieldTests.hpp"
+#include "P256Field.hpp"
+#include "P256LaneField.hpp"
+
+class P256LaneFieldTests : public FieldTests
+{
+protected:
+  P256LaneFieldTests() : FieldTests(256ul) {}
+
+  /// Check that every lane of actual holds expected[lane].
+  void expectLanes(const P256LaneField&          lanes, 
+                   const P256Field::Element      expected[P256LaneField::NUM_LANES],
+                   const P256LaneField::Element& actual)
+  {
+    for ( unsigned int lane = 0; lane < P256LaneField::NUM_LANES; ++lane )
+    {
+      P256Field::Element element;
+      lanes.getLane(element, actual, lane);
+      for ( unsigned int i = 0; i < P256Field::NUM_LIMBS; ++i )
+      {
+        ASSERT_EQ(expected[lane].limbs[i], element.limbs[i]);
+      }
+    }
+  }
+
+  constexpr static unsigned int num_rounds = 32u;
+};
+
+// ============================================================================
+TEST_F(P256LaneFieldTests, TestArithmeticMatchesP256Field)
+{
+  const unsigned int num_lanes = P256LaneField::NUM_LANES;
+
+  P256Field field(p, a);
+
+  /// The portable path always runs, and the IFMA path wherever it is supported.
+  for ( const bool allow_ifma : { false, true } )
+  {
+    P256LaneField lanes(allow_ifma);
+    ASSERT_EQ(allow_ifma && P256LaneField::isIfmaSupported(), lanes.usesIfma());
+
+    for ( unsigned int round = 0; round < num_rounds; ++round )
+    {
+      P256Field::Element     x[num_lanes];
+      P256Field::Element     y[num_lanes];
+      P256Field::Element     expected[num_lanes];
+      P256LaneField::Element lhs;
+      P256LaneField::Element rhs;
+      P256LaneField::Element result;
+
+      for ( unsigned int lane = 0; lane < num_lanes; ++lane )
+      {
+        getOperand   (round * num_lanes + lane,               actual);
+        field.fromMpz(x[lane],                                actual);
+        getOperand   (( round * num_lanes + lane * 3 ) % 16u, actual);
+        field.fromMpz(y[lane],                                actual);
+
+        lanes.setLane(lhs, lane, x[lane]);
+        lanes.setLane(rhs, lane, y[lane]);
+      }
+
+      lanes.add(result, lhs, rhs);
+      for ( unsigned int lane = 0; lane < num_lanes; ++lane )
+      {
+        field.add(expected[lane], x[lane], y[lane]);
+      }
+      expectLanes(lanes, expected, result);
+
+      lanes.sub(result, lhs, rhs);
+      for ( unsigned int lane = 0; lane < num_lanes; ++lane )
+      {
+        field.sub(expected[lane], x[lane], y[lane]);
+      }
+      expectLanes(lanes, expected, result);
+
+      lanes.mul(result, lhs, rhs);
+      for ( unsigned int lane = 0; lane < num_lanes; ++lane )
+      {
+        field.mul(expected[lane], x[lane], y[lane]);
+      }
+      expectLanes(lanes, expected, result);
+
+      lanes.neg(result, lhs);
+      for ( unsigned int lane = 0; lane < num_lanes; ++lane )
+      {
+        field.neg(expected[lane], x[lane]);
+      }
+      expectLanes(lanes, expected, result);
+    }
+  }
+}
+
+// ============================================================================
+TEST_F(P256LaneFieldTests, TestMasks)
+{
+  P256Field              field(p, a);
+  P256LaneField          lanes;
+  P256Field::Element     zero;
+  P256Field::Element     one;
+  P256LaneField::Element result;
+  P256LaneField::Element ones;
+  P256LaneField::Mask    mask;
+
+  field.setZero(zero);
+  field.setOne (one);
+  lanes.broadcast(ones, one);
+
+  /// Even lanes hold zero, odd lanes hold one.
+  for ( unsigned int lane = 0; lane < P256LaneField::NUM_LANES; ++lane )
+  {
+    lanes.setLane(result, lane, ( lane % 2 == 0 ) ? zero : one);
+  }
+
+  lanes.isZero(mask, result);
+  for ( unsigned int lane = 0; lane < P256LaneField::NUM_LANES; ++lane )
+  {
+    ASSERT_EQ(( lane % 2 == 0 ) ? ~uint64_t(0) : uint64_t(0), mask.lanes[lane]);
+  }
+
+  /// Moving ones into the zero lanes leaves no zeros.
+  lanes.conditionalMove(result, ones, mask);
+  lanes.isZero(mask, result);
+  for ( unsigned int lane = 0; lane < P256LaneField::NUM_LANES; ++lane )
+  {
+    ASSERT_EQ(uint64_t(0), mask.lanes[lane]);
+  }
+}
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include <gmp.h>
+
+#include <cstdlib>
+#include <new>
+
+#include "EllipticCurve.hpp"
+#include "EllipticCurveConstants.hpp"
+
+/// Heap allocations made by operator new and by GMP since the last reset.
+static std::size_t allocation_count = 0u;
+
+void* operator new(std::size_t size)
+{
+  ++allocation_count;
+  void* const memory = std::malloc(size == 0u ? 1u : size);
+  if ( memory == nullptr )
+  {
+    throw std::bad_alloc();
+  }
+  return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+  ::operator delete(memory);
+}
+
+class PointAllocationTests : public::testing::Test
+{
+protected:
+  void SetUp()
+  {
+    mp_get_memory_functions(&gmp_allocate, &gmp_reallocate, &gmp_free);
+    mp_set_memory_functions(&countAllocate, &countReallocate, gmp_free);
+  }
+
+  void TearDown()
+  {
+    mp_set_memory_functions(gmp_allocate, gmp_reallocate, gmp_free);
+  }
+
+  static void* countAllocate(std::size_t size)
+  {
+    ++allocation_count;
+    return gmp_allocate(size);
+  }
+
+  static void* countReallocate(void* memory, std::size_t old_size, std::size_t size)
+  {
+    ++allocation_count;
+    return gmp_reallocate(memory, old_size, size);
+  }
+
+  static void* (*gmp_allocate)  (std::size_t);
+  static void* (*gmp_reallocate)(void*, std::size_t, std::size_t);
+  static void  (*gmp_free)      (void*, std::size_t);
+};
+
+void* (*PointAllocationTests::gmp_allocate)  (std::size_t)                      = nullptr;
+void* (*PointAllocationTests::gmp_reallocate)(void*, std::size_t, std::size_t) = nullptr;
+void  (*PointAllocationTests::gmp_free)      (void*, std::size_t)              = nullptr;
+
+// ============================================================================
+TEST_F(PointAllocationTests, TestCurvesFitInlineStorage)
+{
+  for ( const auto& curve : curve_parameters )
+  {
+    ASSERT_LE(curve.second.field_size_bytes, MAX_FIELD_SIZE_BYTES);
+  }
+
+  mpz_t too_large;
+  mpz_init_set_ui(too_large, 1u);
+  mpz_mul_2exp   (too_large, too_large, 8u * MAX_FIELD_SIZE_BYTES + 64u);
+  ASSERT_THROW(EllipticCurve::Point(too_large, too_large), std::invalid_argument);
+  mpz_clear(too_large);
+}
+
+// ============================================================================
+TEST_F(PointAllocationTests, TestPointsDoNotAllocate)
+{
+  const EllipticCurve curve(Curves::P256, ArithmeticBackends::P256, 0u);
+  const EllipticCurve::Point& G = curve.getGenerator();
+
+  allocation_count = 0u;
+  {
+    EllipticCurve::Point P(G);
+    EllipticCurve::Point Q(std::move(P));
+    EllipticCurve::Point R;
+    R = Q;
+    R = std::move(Q);
+    ASSERT_TRUE(R == G);
+  }
+  ASSERT_EQ(allocation_count, 0u);
+
+  for ( ArithmeticBackends backend : { ArithmeticBackends::MPN,
+                                       ArithmeticBackends::P256 } )
+  {
+    const EllipticCurve backend_curve(Curves::P256, backend, 0u);
+    const EllipticCurve::Point P = backend_curve.operate(G, G);
+
+    allocation_count = 0u;
+    const EllipticCurve::Point Q = backend_curve.operate    (P, G);
+    const EllipticCurve::Point R = backend_curve.negatePoint(Q);
+    ASSERT_EQ(allocation_count, 0u);
+    ASSERT_FALSE(Q == R);
+  }
+}
+
+// ============================================================================
+TEST_F(PointAllocationTests, TestScalarMultiplicationLoopDoesNotAllocate)
+{
+  mpz_t small_scalar;
+  mpz_t large_scalar;
+  mpz_init_set_ui (small_scalar, 1u);
+  mpz_init_set_str(large_scalar, curve_parameters.at(Curves::P256).n, 10);
+  mpz_sub_ui      (large_scalar, large_scalar, 1u);
+
+  for ( ArithmeticBackends backend : { ArithmeticBackends::MPN,
+                                       ArithmeticBackends::P256 } )
+  {
+    const EllipticCurve curve(Curves::P256, backend, 0u);
+    const EllipticCurve::Point& G = curve.getGenerator();
+
+    /// Any allocations are setup, made once per call however long the loop.
+    allocation_count = 0u;
+    const EllipticCurve::Point small_product =
+      curve.scalarMultiplication(small_scalar, G);
+    const std::size_t small_count = allocation_count;
+
+    allocation_count = 0u;
+    const EllipticCurve::Point large_product =
+      curve.scalarMultiplication(large_scalar, G);
+    const std::size_t large_count = allocation_count;
+
+    ASSERT_EQ(small_count, large_count);
+    ASSERT_TRUE(small_product == G);
+    ASSERT_TRUE(large_product == curve.negatePoint(G));
+  }
+
+  mpz_clears(small_scalar, large_scalar, nullptr);
+}
+
+// ============================================================================
+TEST_F(PointAllocationTests, TestMpzWorkspaceIsReused)
+{
+  const EllipticCurve curve(Curves::P256, ArithmeticBackends::MPZ, 0u);
+
+  /// Temporaries grow to full size in the first few formulas, then are reused.
+  std::size_t counts[2];
+  const unsigned int bits[2] = { 64u, 256u };
+  for ( unsigned int i = 0; i < 2; ++i )
+  {
+    mpz_t scalar;
+    mpz_init   (scalar);
+    mpz_setbit (scalar, bits[i]);
+    mpz_sub_ui (scalar, scalar, 1u);
+
+    allocation_count = 0u;
+    const EllipticCurve::Point product = 
+      curve.scalarMultiplication(scalar, curve.getGenerator());
+    counts[i] = allocation_count;
+
+    ASSERT_FALSE(product.at_infinity);
+    mpz_clear(scalar);
+  }
+
+  ASSERT_EQ(counts[0], counts[1]);
+}
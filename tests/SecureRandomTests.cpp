@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include <gmp.h>
+
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "EllipticCurveConstants.hpp"
+#include "SecureRandom.hpp"
+
+// ============================================================================
+TEST(SecureRandomTests, TestUniformScalarRange)
+{
+  mpz_t value;
+  mpz_t upper_bound;
+  mpz_inits(value, upper_bound, nullptr);
+
+  /// Both of [1, 3) are drawn, and nothing else.
+  mpz_set_ui(upper_bound, 3u);
+  bool seen[3] = { false, false, false };
+  for ( unsigned int i = 0; i < 256u; ++i )
+  {
+    SecureRandom::uniformScalar(value, upper_bound);
+    ASSERT_GE(mpz_cmp_ui(value, 1u), 0);
+    ASSERT_LT(mpz_cmp   (value, upper_bound), 0);
+    seen[mpz_get_ui(value)] = true;
+  }
+  ASSERT_TRUE(seen[1] && seen[2]);
+
+  mpz_set_ui(upper_bound, 1u);
+  ASSERT_THROW(SecureRandom::uniformScalar(value, upper_bound), 
+               std::invalid_argument);
+
+  mpz_setbit(upper_bound, 8u * SecureRandom::MAX_SCALAR_BYTES);
+  ASSERT_THROW(SecureRandom::uniformScalar(value, upper_bound), 
+               std::invalid_argument);
+
+  mpz_clears(value, upper_bound, nullptr);
+}
+
+// ============================================================================
+TEST(SecureRandomTests, TestConcurrentScalars)
+{
+  mpz_t order;
+  mpz_init_set_str(order, curve_parameters.at(Curves::P256).n, 10);
+
+  /// Each thread refills its own buffer several times. Elements of a
+  /// std::vector<int>, unlike std::vector<bool>, may be written concurrently.
+  const unsigned int THREADS = 4u;
+  const unsigned int DRAWS   = 1024u;
+  std::vector<int>         in_range(THREADS, 0);
+  std::vector<std::thread> threads;
+  for ( unsigned int t = 0; t < THREADS; ++t )
+  {
+    threads.emplace_back([&order, &in_range, t, DRAWS]()
+    {
+      bool valid = true;
+      mpz_t value;
+      mpz_init(value);
+      for ( unsigned int i = 0; i < DRAWS; ++i )
+      {
+        SecureRandom::uniformScalar(value, order);
+        valid = valid && mpz_sgn(value) > 0 && mpz_cmp(value, order) < 0;
+      }
+      mpz_clear(value);
+      in_range[t] = valid ? 1 : 0;
+    });
+  }
+  for ( std::thread& thread : threads )
+  {
+    thread.join();
+  }
+
+  for ( unsigned int t = 0; t < THREADS; ++t )
+  {
+    ASSERT_EQ(in_range[t], 1);
+  }
+  mpz_clear(order);
+}
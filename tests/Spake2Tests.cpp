@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include <gmp.h>
 
+#include "Spake2Batch.hpp"
 #include "Spake2Tests.hpp"
 
 const Spake2Tests::GivenValue Spake2Tests::given_values[num_test_vectors] =
@@ -226,10 +227,10 @@ TEST_F(Spake2Tests, testCompareSharedSymmetricSecrets)
   for ( unsigned int i = 0; i < num_test_vectors; ++i )
   {
     /// Ke and Ka
-    ASSERT_STREQ(alice[i]->getSharedSymmetricSecrets().Ke.c_str(), 
+    ASSERT_STREQ(alice[i]->getSharedSymmetricSecrets().getKeHex().c_str(), 
                  expected_values[i].Ke.c_str());
 
-    ASSERT_STREQ(bob[i]->getSharedSymmetricSecrets().Ka.c_str(), 
+    ASSERT_STREQ(bob[i]->getSharedSymmetricSecrets().getKaHex().c_str(), 
                  expected_values[i].Ka.c_str());
   }
 }
@@ -240,16 +241,16 @@ TEST_F(Spake2Tests, testCompareMacKeys)
   for ( unsigned int i = 0; i < num_test_vectors; ++i )
   {
     /// KcA || KcB
-    ASSERT_STREQ(alice[i]->getMacKeys().KcA.c_str(), 
-                 bob  [i]->getMacKeys().KcA.c_str());
+    ASSERT_STREQ(alice[i]->getMacKeys().getKcAHex().c_str(), 
+                 bob  [i]->getMacKeys().getKcAHex().c_str());
 
-    ASSERT_STREQ(alice[i]->getMacKeys().KcB.c_str(), 
-                 bob  [i]->getMacKeys().KcB.c_str());
+    ASSERT_STREQ(alice[i]->getMacKeys().getKcBHex().c_str(), 
+                 bob  [i]->getMacKeys().getKcBHex().c_str());
 
-    ASSERT_STREQ(alice          [i]->getMacKeys().KcA.c_str(), 
+    ASSERT_STREQ(alice          [i]->getMacKeys().getKcAHex().c_str(), 
                  expected_values[i].KcA.c_str());
 
-    ASSERT_STREQ(bob            [i]->getMacKeys().KcB.c_str(), 
+    ASSERT_STREQ(bob            [i]->getMacKeys().getKcBHex().c_str(), 
                  expected_values[i].KcB.c_str());
   }
 }
@@ -360,4 +361,120 @@ TEST_F(Spake2Tests, testMismatchedAdditionalAuthenticatedDats)
 
   ASSERT_TRUE(!alice.checkProtocolComplete());
   ASSERT_TRUE(!bob.  checkProtocolComplete());
-}
\ No newline at end of file
+}
+
+// ============================================================================
+TEST_F(Spake2Tests, testBatchMatchesSessions)
+{
+  Spake2Batch batch;
+  for ( unsigned int i = 0; i < num_test_vectors; ++i )
+  {
+    batch.addSession(*alice[i]);
+    batch.addSession(*bob  [i]);
+  }
+  ASSERT_EQ(batch.getNumSessions(), 2 * num_test_vectors);
+
+  /// Recompute every session together, in place of the per-session results.
+  batch.setupPhase();
+  for ( unsigned int i = 0; i < num_test_vectors; ++i )
+  {
+    ASSERT_STREQ(alice[i]->getUncompressedPublicKey().c_str(), 
+                 expected_values[i].pA.c_str());
+
+    ASSERT_STREQ(bob[i]->getUncompressedPublicKey().c_str(), 
+                 expected_values[i].pB.c_str());
+  }
+
+  batch.keyDerivationPhase();
+  for ( unsigned int i = 0; i < num_test_vectors; ++i )
+  {
+    ASSERT_STREQ(alice[i]->getUncompressedGroupElement().c_str(), 
+                 expected_values[i].K.c_str());
+
+    ASSERT_STREQ(bob[i]->getUncompressedGroupElement().c_str(), 
+                 expected_values[i].K.c_str());
+
+    ASSERT_STREQ(alice[i]->getConfirmationKey().c_str(), 
+                 expected_values[i].A_conf.c_str());
+
+    ASSERT_STREQ(bob[i]->getConfirmationKey().c_str(), 
+                 expected_values[i].B_conf.c_str());
+  }
+}
+
+// ============================================================================
+TEST_F(Spake2Tests, testEdwards25519Execution)
+{
+  Spake2 alice("alice", "foo", true,  "", Curves::EDWARDS25519);
+  Spake2 bob  ("bob",   "foo", false, "", Curves::EDWARDS25519);
+
+  alice.setupPhase();
+  bob.  setupPhase();
+
+  /// The keys are exchanged in their 32 byte RFC 8032 encoding.
+  ASSERT_EQ(alice.getEncodedPublicKey().length(), 2u + 64u);
+
+  ASSERT_TRUE(alice.readOtherPartiesPublicKey());
+  ASSERT_TRUE(bob.  readOtherPartiesPublicKey());
+
+  alice.keyDerivationPhase();
+  bob.  keyDerivationPhase();
+
+  alice.readOtherPartiesConfirmationKey();
+  bob.  readOtherPartiesConfirmationKey();
+
+  ASSERT_TRUE(alice.checkProtocolComplete());
+  ASSERT_TRUE(bob.  checkProtocolComplete());
+}
+
+// ============================================================================
+TEST_F(Spake2Tests, testEdwards25519ClearsTheCofactor)
+{
+  Spake2 alice("alice", "foo", true,  "", Curves::EDWARDS25519);
+  Spake2 bob  ("bob",   "foo", false, "", Curves::EDWARDS25519);
+
+  alice.setupPhase();
+  bob.  setupPhase();
+
+  /// (0, -1) has order 2, so h = 8 removes it from bob's public key.
+  const EllipticCurve curve(Curves::EDWARDS25519, ArithmeticBackends::ED25519);
+  mpz_t zero;
+  mpz_t minus_one;
+  mpz_init  (zero);
+  mpz_init  (minus_one);
+  mpz_sub_ui(minus_one, curve.getPrimeModulus(), 1ul);
+  const EllipticCurve::Point T(zero, minus_one);
+  mpz_clears(zero, minus_one, nullptr);
+
+  alice.putPublicKeyOther(bob.  getIdentity(), 
+                          curve.operate(bob.getPublicKey(), T));
+  bob.  putPublicKeyOther(alice.getIdentity(), alice.getPublicKey());
+
+  alice.keyDerivationPhase();
+  bob.  keyDerivationPhase();
+
+  ASSERT_EQ(alice.getUncompressedGroupElement(), 
+            bob.  getUncompressedGroupElement());
+}
+
+// ============================================================================
+TEST_F(Spake2Tests, testSecp256k1Execution)
+{
+  Spake2 alice("alice", "foo", true,  "", Curves::SECP256K1);
+  Spake2 bob  ("bob",   "foo", false, "", Curves::SECP256K1);
+
+  alice.setupPhase();
+  bob.  setupPhase();
+
+  ASSERT_TRUE(alice.readOtherPartiesPublicKey());
+  ASSERT_TRUE(bob.  readOtherPartiesPublicKey());
+
+  alice.keyDerivationPhase();
+  bob.  keyDerivationPhase();
+
+  alice.readOtherPartiesConfirmationKey();
+  bob.  readOtherPartiesConfirmationKey();
+
+  ASSERT_TRUE(alice.checkProtocolComplete());
+  ASSERT_TRUE(bob.  checkProtocolComplete());
+}
@@ -187,3 +187,27 @@ TEST(HexStringToBytesTest, TestValidInputWithUppercasePrefix)
 }
 
 
+
+// ============================================================================
+TEST(HexStringToBytesTest, TestIntoBufferWithPrefix)
+{
+  unsigned char bytes[4];
+  std::size_t   length = 0;
+  
+  ASSERT_TRUE(hexStringToBytes("0xdeADbeef", bytes, sizeof(bytes), length));
+  ASSERT_EQ(length, 4u);
+  ASSERT_EQ(bytes[0], 0xDE);
+  ASSERT_EQ(bytes[3], 0xEF);
+}
+
+// ============================================================================
+TEST(HexStringToBytesTest, TestIntoBufferRejectsInvalidInput)
+{
+  unsigned char bytes[4];
+  std::size_t   length = 0;
+
+  /// Odd length, non-hex digits, and too long for the buffer.
+  ASSERT_FALSE(hexStringToBytes("0xabc",        bytes, sizeof(bytes), length));
+  ASSERT_FALSE(hexStringToBytes("0xdeadbeeg",   bytes, sizeof(bytes), length));
+  ASSERT_FALSE(hexStringToBytes("0xdeadbeef00", bytes, sizeof(bytes), length));
+}